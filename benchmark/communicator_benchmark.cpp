@@ -0,0 +1,238 @@
+/// \file communicator_benchmark.cpp
+/// \brief End to end benchmarks of serial_communicator::communicator over in-process transports.
+#include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/loopback_transport.h"
+#include "serial_communicator/transport/pty_transport.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace serial_communicator;
+
+namespace {
+// Enumerates the payload contents used to vary escape density.
+enum class payload_pattern
+{
+    ZERO = 0,       ///< No bytes need escaping.
+    RANDOM = 1,     ///< Roughly 1 in 128 bytes need escaping.
+    WORST = 2       ///< Every byte needs escaping.
+};
+
+// Enumerates the transports that communicators can be benchmarked over.
+enum class transport_type
+{
+    LOOPBACK = 0,
+    PTY = 1
+};
+
+// Creates a pair of communicators connected to each other.
+void create_pair(transport_type type, communicator*& sender, communicator*& receiver)
+{
+    switch(type)
+    {
+    case transport_type::LOOPBACK:
+    {
+        loopback_transport* first;
+        loopback_transport* second;
+        loopback_transport::create_pair(first, second);
+        sender = new communicator(first);
+        receiver = new communicator(second);
+        break;
+    }
+    case transport_type::PTY:
+    {
+        pty_transport* master = new pty_transport();
+        pty_transport* slave = new pty_transport(master->p_slave_name());
+        sender = new communicator(master);
+        receiver = new communicator(slave);
+        break;
+    }
+    }
+}
+
+// Creates a message with a payload following the given pattern.
+message* create_message(unsigned short data_length, payload_pattern pattern, std::mt19937& generator)
+{
+    message* output = new message(1, data_length);
+    for(unsigned short i = 0; i < data_length; i++)
+    {
+        unsigned char value = 0;
+        switch(pattern)
+        {
+        case payload_pattern::ZERO:
+            value = 0;
+            break;
+        case payload_pattern::RANDOM:
+            value = static_cast<unsigned char>(generator());
+            break;
+        case payload_pattern::WORST:
+            value = 0xAA;
+            break;
+        }
+        output->set_field<unsigned char>(i, value);
+    }
+    return output;
+}
+
+// Spins the receiver until a message is received.
+message* receive_one(communicator& sender, communicator& receiver)
+{
+    message* output = nullptr;
+    while((output = receiver.receive()) == nullptr)
+    {
+        sender.spin();
+        receiver.spin();
+    }
+    return output;
+}
+
+// Reports latency percentiles in microseconds as counters.
+void report_latency(benchmark::State& state, std::vector<double>& latencies)
+{
+    if(latencies.empty())
+    {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const double percentiles[] = {0.5, 0.9, 0.99, 0.999};
+    const char* names[] = {"p50_us", "p90_us", "p99_us", "p999_us"};
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        unsigned long index = static_cast<unsigned long>(percentiles[i] * (latencies.size() - 1));
+        state.counters[names[i]] = latencies[index];
+    }
+}
+}
+
+// Sends messages end to end with varying payload size and escape density.
+static void communicator_escape_density(benchmark::State& state)
+{
+    unsigned short data_length = static_cast<unsigned short>(state.range(0));
+    payload_pattern pattern = static_cast<payload_pattern>(state.range(1));
+    communicator* sender;
+    communicator* receiver;
+    create_pair(transport_type::LOOPBACK, sender, receiver);
+    std::mt19937 generator(0);
+
+    for(auto _ : state)
+    {
+        sender->send(create_message(data_length, pattern, generator));
+        delete receive_one(*sender, *receiver);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * data_length);
+
+    delete sender;
+    delete receiver;
+}
+BENCHMARK(communicator_escape_density)->ArgsProduct({{16, 1024, 16384}, {0, 1, 2}});
+
+// Fills and drains the queues with varying queue sizes.
+static void communicator_queue(benchmark::State& state)
+{
+    unsigned short queue_size = static_cast<unsigned short>(state.range(0));
+    communicator* sender;
+    communicator* receiver;
+    create_pair(transport_type::LOOPBACK, sender, receiver);
+    sender->p_queue_size(queue_size);
+    receiver->p_queue_size(queue_size);
+
+    for(auto _ : state)
+    {
+        for(unsigned short i = 0; i < queue_size; i++)
+        {
+            sender->send(new message(i, 4));
+        }
+        for(unsigned short i = 0; i < queue_size; i++)
+        {
+            sender->spin();
+            receiver->spin();
+        }
+        message* received;
+        while((received = receiver->receive()) != nullptr)
+        {
+            delete received;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * queue_size);
+
+    delete sender;
+    delete receiver;
+}
+BENCHMARK(communicator_queue)->RangeMultiplier(4)->Range(1, 1024);
+
+// Measures messages per second and latency percentiles over each transport.
+static void communicator_latency(benchmark::State& state)
+{
+    transport_type type = static_cast<transport_type>(state.range(0));
+    unsigned short data_length = static_cast<unsigned short>(state.range(1));
+    bool receipt_required = state.range(2) != 0;
+    communicator* sender;
+    communicator* receiver;
+    create_pair(type, sender, receiver);
+    std::mt19937 generator(0);
+    std::vector<double> latencies;
+    latencies.reserve(1 << 16);
+
+    for(auto _ : state)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        message_status tracker;
+        sender->send(create_message(data_length, payload_pattern::RANDOM, generator), receipt_required, &tracker);
+        delete receive_one(*sender, *receiver);
+        // Complete the round trip by processing the receipt.
+        while(receipt_required && tracker != message_status::RECEIVED)
+        {
+            sender->spin();
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    report_latency(state, latencies);
+
+    delete sender;
+    delete receiver;
+}
+BENCHMARK(communicator_latency)->ArgsProduct({{0, 1}, {16, 1024}, {0, 1}})->UseRealTime();
+
+// Receives messages end to end, either copied out with receive() or viewed in place with receive_view().
+static void communicator_receive_view(benchmark::State& state)
+{
+    unsigned short data_length = static_cast<unsigned short>(state.range(0));
+    bool view = state.range(1) != 0;
+    communicator* sender;
+    communicator* receiver;
+    create_pair(transport_type::LOOPBACK, sender, receiver);
+    std::mt19937 generator(0);
+
+    for(auto _ : state)
+    {
+        sender->send(create_message(data_length, payload_pattern::RANDOM, generator));
+        if(view)
+        {
+            message_view received;
+            while(!(received = receiver->receive_view()).p_valid())
+            {
+                sender->spin();
+                receiver->spin();
+            }
+            benchmark::DoNotOptimize(received.get_field<unsigned char>(0));
+        }
+        else
+        {
+            message* received = receive_one(*sender, *receiver);
+            benchmark::DoNotOptimize(received->get_field<unsigned char>(0));
+            delete received;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * data_length);
+
+    delete sender;
+    delete receiver;
+}
+BENCHMARK(communicator_receive_view)->ArgsProduct({{16, 16384}, {0, 1}});
@@ -0,0 +1,145 @@
+/// \file message_benchmark.cpp
+/// \brief Benchmarks for serializing, deserializing, and accessing serial_communicator::message fields.
+#include "serial_communicator/message.h"
+#include "serial_communicator/message_schema.h"
+
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+using namespace serial_communicator;
+
+// Creates, fills, and moves a message with a payload of the given size.
+static void message_create(benchmark::State& state)
+{
+    unsigned short data_length = static_cast<unsigned short>(state.range(0));
+
+    for(auto _ : state)
+    {
+        message input(1, data_length);
+        input.set_field<unsigned char>(0, 1);
+        message output(std::move(input));
+        benchmark::DoNotOptimize(output.p_data());
+    }
+}
+BENCHMARK(message_create)->Arg(1)->Arg(8)->Arg(16)->Arg(17)->Arg(64);
+
+// Serializes a message with a payload of the given size.
+static void message_serialize(benchmark::State& state)
+{
+    unsigned short data_length = static_cast<unsigned short>(state.range(0));
+    message input(1, data_length);
+    std::vector<unsigned char> buffer(input.p_message_length());
+
+    for(auto _ : state)
+    {
+        input.serialize(buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * input.p_message_length());
+}
+BENCHMARK(message_serialize)->RangeMultiplier(8)->Range(8, 32768);
+
+// Deserializes a message with a payload of the given size.
+static void message_deserialize(benchmark::State& state)
+{
+    unsigned short data_length = static_cast<unsigned short>(state.range(0));
+    message input(1, data_length);
+    std::vector<unsigned char> buffer(input.p_message_length());
+    input.serialize(buffer.data());
+
+    for(auto _ : state)
+    {
+        message output(buffer.data());
+        benchmark::DoNotOptimize(output.p_data_length());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * input.p_message_length());
+}
+BENCHMARK(message_deserialize)->RangeMultiplier(8)->Range(8, 32768);
+
+// Writes and reads back every float field of a payload of the given size.
+static void message_float_fields(benchmark::State& state)
+{
+    unsigned short n_fields = static_cast<unsigned short>(state.range(0));
+    message input(1, n_fields * sizeof(float));
+
+    for(auto _ : state)
+    {
+        for(unsigned short i = 0; i < n_fields; i++)
+        {
+            input.set_field<float>(i * sizeof(float), static_cast<float>(i));
+        }
+        float sum = 0;
+        for(unsigned short i = 0; i < n_fields; i++)
+        {
+            sum += input.get_field<float>(i * sizeof(float));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * n_fields * 2);
+}
+BENCHMARK(message_float_fields)->RangeMultiplier(8)->Range(1, 4096);
+
+// Writes and reads back a float array of the given size in single calls.
+static void message_float_array(benchmark::State& state)
+{
+    unsigned short n_fields = static_cast<unsigned short>(state.range(0));
+    message input(1, n_fields * sizeof(float));
+    std::vector<float> values(n_fields);
+    for(unsigned short i = 0; i < n_fields; i++)
+    {
+        values[i] = static_cast<float>(i);
+    }
+
+    for(auto _ : state)
+    {
+        input.set_array<float>(0, values.data(), n_fields);
+        input.get_array<float>(0, values.data(), n_fields);
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * n_fields * 2);
+}
+BENCHMARK(message_float_array)->RangeMultiplier(8)->Range(1, 4096)->Arg(640);
+
+// Writes and reads back the fields of a typical sensor message, by hand computed address or through a schema.
+typedef message_schema<1, double, float, float, float, unsigned int, unsigned char> sensor_schema;
+static void message_sensor_fields(benchmark::State& state)
+{
+    bool schema = state.range(0) != 0;
+    message* input = sensor_schema::create();
+
+    for(auto _ : state)
+    {
+        double sum = 0;
+        if(schema)
+        {
+            sensor_schema::set<0>(*input, 1.0);
+            sensor_schema::set<1>(*input, 2.0f);
+            sensor_schema::set<2>(*input, 3.0f);
+            sensor_schema::set<3>(*input, 4.0f);
+            sensor_schema::set<4>(*input, 5);
+            sensor_schema::set<5>(*input, 6);
+            sum = sensor_schema::get<0>(*input) + sensor_schema::get<1>(*input) + sensor_schema::get<2>(*input) +
+                  sensor_schema::get<3>(*input) + sensor_schema::get<4>(*input) + sensor_schema::get<5>(*input);
+        }
+        else
+        {
+            input->set_field<double>(0, 1.0);
+            input->set_field<float>(8, 2.0f);
+            input->set_field<float>(12, 3.0f);
+            input->set_field<float>(16, 4.0f);
+            input->set_field<unsigned int>(20, 5);
+            input->set_field<unsigned char>(24, 6);
+            sum = input->get_field<double>(0) + input->get_field<float>(8) + input->get_field<float>(12) +
+                  input->get_field<float>(16) + input->get_field<unsigned int>(20) + input->get_field<unsigned char>(24);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * sensor_schema::n_fields * 2);
+
+    delete input;
+}
+BENCHMARK(message_sensor_fields)->Arg(0)->Arg(1);
@@ -0,0 +1,53 @@
+/// \file frame_fuzzer.cpp
+/// \brief Fuzzes the framing, unescaping, and packet parsing of a communicator's receive path.
+#include "fuzz_transport.h"
+
+#include "serial_communicator/communicator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace serial_communicator;
+
+// Reads every byte of a received message so that out of bounds views are caught by the sanitizers.
+static void consume(const message_view& view)
+{
+    std::vector<unsigned char> data(view.p_data_length());
+    view.get_bytes(0, data.data(), view.p_data_length());
+    message* copy = view.to_message();
+    delete copy;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    fuzz_transport* transport = new fuzz_transport(data, size);
+    communicator communicator(transport);
+    communicator.p_queue_size(16);
+    communicator.p_timestamps(true);
+
+    // Spin until the whole input has been read, and then until the bytes already read are assembled.
+    for(unsigned int i = 0; i < size + 16; i++)
+    {
+        communicator.spin();
+        for(message_view view = communicator.receive_view(); view.p_valid(); view = communicator.receive_view())
+        {
+            consume(view);
+        }
+        unsigned short call = 0;
+        for(message_view view = communicator.receive_request(call); view.p_valid(); view = communicator.receive_request(call))
+        {
+            consume(view);
+        }
+        if(transport->drained())
+        {
+            break;
+        }
+    }
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        communicator.spin();
+    }
+
+    return 0;
+}
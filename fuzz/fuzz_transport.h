@@ -0,0 +1,103 @@
+/// \file fuzz_transport.h
+/// \brief Defines the serial_communicator::fuzz_transport class.
+#ifndef FUZZ_TRANSPORT_H
+#define FUZZ_TRANSPORT_H
+
+#include "serial_communicator/transport.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace serial_communicator {
+///
+/// \brief A stand-in transport that receives a fuzzer's input and discards everything written.
+/// \details The input is made available in pieces whose sizes are drawn from the input itself, so that the fuzzer
+/// controls where packets are split across reads as well as their contents.  Reads never wait.
+///
+class fuzz_transport : public serial_communicator::transport
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief fuzz_transport Creates a new fuzz_transport instance.
+    /// \param data The fuzzer's input, which must remain valid for the life of the transport.
+    /// \param size The size of the input in bytes.
+    ///
+    fuzz_transport(const unsigned char* data, unsigned long size)
+    {
+        fuzz_transport::m_data = data;
+        fuzz_transport::m_size = size;
+        fuzz_transport::m_position = 0;
+        fuzz_transport::m_arrived = 0;
+        fuzz_transport::m_n_written = 0;
+    }
+
+    // METHODS
+    unsigned long read(unsigned char* buffer, unsigned long length) override
+    {
+        unsigned long n_read = std::min(length, fuzz_transport::m_arrived - fuzz_transport::m_position);
+        std::memcpy(buffer, fuzz_transport::m_data + fuzz_transport::m_position, n_read);
+        fuzz_transport::m_position += n_read;
+        return n_read;
+    }
+    unsigned long write(const unsigned char* buffer, unsigned long length) override
+    {
+        (void)buffer;
+        fuzz_transport::m_n_written += length;
+        return length;
+    }
+    unsigned long available() override
+    {
+        if(fuzz_transport::m_position == fuzz_transport::m_arrived && fuzz_transport::m_arrived < fuzz_transport::m_size)
+        {
+            // Deliver the next piece, sized by the byte at its start.
+            unsigned long piece = 1 + fuzz_transport::m_data[fuzz_transport::m_arrived] % 64;
+            fuzz_transport::m_arrived = std::min(fuzz_transport::m_size, fuzz_transport::m_arrived + piece);
+        }
+        return fuzz_transport::m_arrived - fuzz_transport::m_position;
+    }
+    ///
+    /// \brief drained Checks if the whole input has been read.
+    /// \return TRUE if the input has been read, otherwise FALSE.
+    ///
+    bool drained() const
+    {
+        return fuzz_transport::m_position == fuzz_transport::m_size;
+    }
+
+    // PROPERTIES
+    int p_file_descriptor() const override
+    {
+        return -1;
+    }
+    unsigned long p_byte_time() const override
+    {
+        return 0;
+    }
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_data Stores the fuzzer's input.
+    ///
+    const unsigned char* m_data;
+    ///
+    /// \brief m_size Stores the size of the input in bytes.
+    ///
+    unsigned long m_size;
+    ///
+    /// \brief m_position Stores the number of bytes read.
+    ///
+    unsigned long m_position;
+    ///
+    /// \brief m_arrived Stores the number of bytes made available.
+    ///
+    unsigned long m_arrived;
+    ///
+    /// \brief m_n_written Stores the number of bytes written.
+    ///
+    unsigned long m_n_written;
+};
+}
+
+#endif // FUZZ_TRANSPORT_H
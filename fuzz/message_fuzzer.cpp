@@ -0,0 +1,58 @@
+/// \file message_fuzzer.cpp
+/// \brief Fuzzes message deserialization and field access.
+#include "serial_communicator/message.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace serial_communicator;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    try
+    {
+        message input(data, static_cast<unsigned int>(size));
+
+        // Serializing must reproduce the bytes the message was read from.
+        std::vector<unsigned char> output(input.p_message_length());
+        input.serialize(output.data());
+        if(std::memcmp(output.data(), data, output.size()) != 0)
+        {
+            __builtin_trap();
+        }
+
+        // Read fields at addresses taken from the input, which may lie outside of the data.
+        for(size_t i = 0; i + 1 < size && i < 64; i += 2)
+        {
+            unsigned short address = static_cast<unsigned short>((data[i] << 8) | data[i + 1]);
+            try
+            {
+                input.get_field<double>(address);
+                input.get_string(address, data[i]);
+                unsigned int values[4];
+                input.get_array<unsigned int>(address, values, data[i + 1] % 5);
+            }
+            catch(const std::out_of_range&)
+            {
+                // Expected for addresses outside of the data.
+            }
+        }
+
+        // Copies and moves must carry the data intact.
+        message copy(input);
+        message moved(std::move(copy));
+        if(moved.p_data_length() != input.p_data_length() || std::memcmp(moved.p_data(), input.p_data(), input.p_data_length()) != 0)
+        {
+            __builtin_trap();
+        }
+    }
+    catch(const std::invalid_argument&)
+    {
+        // The input was too short for the message it describes.
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+/// \file standalone_main.cpp
+/// \brief Runs a fuzz target over input files, for compilers without libFuzzer and for AFL.
+/// \details Each argument is a file whose contents are passed to the fuzz target once.  Without arguments, a single
+/// input is read from standard input, which is how AFL delivers its test cases.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// Passes the contents of a stream to the fuzz target.
+static void run(std::istream& input)
+{
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        run(std::cin);
+        return 0;
+    }
+    for(int i = 1; i < argc; i++)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+        if(!file)
+        {
+            std::fprintf(stderr, "unable to open %s\n", argv[i]);
+            return 1;
+        }
+        run(file);
+    }
+    return 0;
+}
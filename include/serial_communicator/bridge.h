@@ -0,0 +1,211 @@
+/// \file bridge.h
+/// \brief Defines the serial_communicator::bridge class.
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include "communicator.h"
+#include "diagnostics.h"
+
+#include <serial_communicator/RawMessage.h>
+#include <serial_communicator/Transaction.h>
+
+#include <nodelet/nodelet.h>
+#include <ros/ros.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace serial_communicator {
+///
+/// \brief A nodelet that bridges a communicator's messages to ROS topics and services.
+/// \details The bridge owns a communicator and maps message IDs to topics and services through its private
+/// parameters.  Received messages are published as shared pointers, so consumer nodelets in the same manager
+/// receive them without serialization, and their data is copied once out of the receive buffer.  Messages published
+/// to subscribed topics are sent with the topic's message ID.  A service sends a request message and returns the
+/// next message received with the service's response ID.
+///
+class bridge : public nodelet::Nodelet
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief bridge Creates a new bridge instance.
+    ///
+    bridge();
+    ~bridge();
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief A topic that is forwarded to the communicator.
+    ///
+    struct subscription
+    {
+        ///
+        /// \brief id The ID of the messages sent for the topic.
+        ///
+        unsigned short id;
+        ///
+        /// \brief receipt_required Indicates if the messages are retransmitted until a receipt is received.
+        ///
+        bool receipt_required;
+    };
+    ///
+    /// \brief A service that exchanges a request message for a response message.
+    ///
+    struct service
+    {
+        ///
+        /// \brief request_id The ID of the request message.
+        ///
+        unsigned short request_id;
+        ///
+        /// \brief response_id The ID of the response message.
+        ///
+        unsigned short response_id;
+        ///
+        /// \brief timeout The time to wait for the response, in milliseconds.
+        ///
+        unsigned int timeout;
+        ///
+        /// \brief mutex Serializes calls so that each response is matched to one request.
+        ///
+        std::mutex mutex;
+        ///
+        /// \brief server The ROS service server.
+        ///
+        ros::ServiceServer server;
+    };
+
+    // VARIABLES
+    ///
+    /// \brief m_communicator The bridged communicator.
+    ///
+    serial_communicator::communicator* m_communicator;
+    ///
+    /// \brief m_diagnostics Publishes the communicator's statistics, or is nullptr if disabled.
+    ///
+    serial_communicator::diagnostics* m_diagnostics;
+    ///
+    /// \brief m_diagnostics_period The interval at which statistics are published, in seconds.
+    ///
+    double m_diagnostics_period;
+    ///
+    /// \brief m_publishers Stores the publisher for each received message ID.
+    ///
+    std::map<unsigned short, ros::Publisher> m_publishers;
+    ///
+    /// \brief m_subscribers Stores the subscribers to topics forwarded to the communicator.
+    ///
+    std::vector<ros::Subscriber> m_subscribers;
+    ///
+    /// \brief m_services Stores the services.
+    ///
+    std::vector<service*> m_services;
+    ///
+    /// \brief m_responses Stores the response IDs that services are waiting for, with the response once received.
+    ///
+    std::map<unsigned short, message_view> m_responses;
+    ///
+    /// \brief m_responses_mutex Guards the awaited responses.
+    ///
+    std::mutex m_responses_mutex;
+    ///
+    /// \brief m_responses_condition Signals services when a response is received.
+    ///
+    std::condition_variable m_responses_condition;
+
+    // THREADING
+    ///
+    /// \brief m_thread The thread that spins the communicator and publishes received messages.
+    ///
+    std::thread m_thread;
+    ///
+    /// \brief m_running Indicates if the thread should keep running.
+    ///
+    std::atomic<bool> m_running;
+
+    // METHODS
+    ///
+    /// \brief onInit Creates the communicator, topics, and services from the private parameters.
+    ///
+    void onInit() override;
+    ///
+    /// \brief create_communicator Creates the communicator from the private parameters.
+    /// \param node_handle The private node handle.
+    /// \return TRUE if the communicator was created, otherwise FALSE.
+    ///
+    bool create_communicator(ros::NodeHandle& node_handle);
+    ///
+    /// \brief create_publishers Advertises a topic for each received message ID listed in the publishers parameter.
+    /// \param node_handle The private node handle.
+    ///
+    void create_publishers(ros::NodeHandle& node_handle);
+    ///
+    /// \brief create_subscribers Subscribes to each topic listed in the subscribers parameter.
+    /// \param node_handle The private node handle.
+    ///
+    void create_subscribers(ros::NodeHandle& node_handle);
+    ///
+    /// \brief create_services Advertises each service listed in the services parameter.
+    /// \param node_handle The private node handle.
+    ///
+    void create_services(ros::NodeHandle& node_handle);
+    ///
+    /// \brief worker Spins the communicator and routes received messages until stopped.
+    ///
+    void worker();
+    ///
+    /// \brief route Hands a received message to the service awaiting it, or publishes it on its topic.
+    /// \param view The received message.
+    /// \param timestamp The time at which the message was sent, or arrived if it is not known.
+    ///
+    void route(const message_view& view, std::chrono::steady_clock::time_point timestamp);
+    ///
+    /// \brief forward Sends a message published on a subscribed topic.
+    /// \param input The published message.
+    /// \param subscription The topic's subscription.
+    ///
+    void forward(const RawMessage::ConstPtr& input, subscription subscription);
+    ///
+    /// \brief call Sends a service's request message and waits for its response message.
+    /// \param request The service request.
+    /// \param response The service response.
+    /// \param service The called service.
+    /// \return TRUE if the request was handled, otherwise FALSE.
+    ///
+    bool call(Transaction::Request& request, Transaction::Response& response, service* service);
+    ///
+    /// \brief member Reads an integer member of a parameter list entry.
+    /// \param entry The parameter list entry.
+    /// \param name The name of the member.
+    /// \param value Outputs the member's value.
+    /// \return TRUE if the member exists and is an integer, otherwise FALSE.
+    ///
+    bool member(XmlRpc::XmlRpcValue& entry, const std::string& name, int& value) const;
+    ///
+    /// \brief member Reads a boolean member of a parameter list entry.
+    /// \param entry The parameter list entry.
+    /// \param name The name of the member.
+    /// \param value Outputs the member's value.
+    /// \return TRUE if the member exists and is a boolean, otherwise FALSE.
+    ///
+    bool member(XmlRpc::XmlRpcValue& entry, const std::string& name, bool& value) const;
+    ///
+    /// \brief member Reads a string member of a parameter list entry.
+    /// \param entry The parameter list entry.
+    /// \param name The name of the member.
+    /// \param value Outputs the member's value.
+    /// \return TRUE if the member exists and is a string, otherwise FALSE.
+    ///
+    bool member(XmlRpc::XmlRpcValue& entry, const std::string& name, std::string& value) const;
+};
+}
+
+#endif // BRIDGE_H
@@ -0,0 +1,18 @@
+/// \file call_status.h
+/// \brief Defines the serial_communicator::call_status enumeration.
+#ifndef CALL_STATUS_H
+#define CALL_STATUS_H
+
+namespace serial_communicator {
+///
+/// \brief Enumerates the ways a call can complete.
+///
+enum class call_status
+{
+  COMPLETED = 0,    ///< The response to the call was received.
+  TIMED_OUT = 1,    ///< No response was received before the call's timeout elapsed.
+  CANCELLED = 2     ///< The communicator was destroyed before a response was received.
+};
+}
+
+#endif // CALL_STATUS_H
@@ -3,12 +3,33 @@
 #ifndef COMMUNICATOR_H
 #define COMMUNICATOR_H
 
+#include "call_status.h"
+#include "encryption.h"
 #include "message.h"
+#include "message_view.h"
 #include "message_status.h"
+#include "statistics.h"
+#include "transport.h"
 #include "utility/outbound.h"
 #include "utility/inbound.h"
+#include "utility/capture.h"
+#include "utility/clock_sync.h"
+#include "utility/link.h"
+#include "utility/escape_writer.h"
+#include "utility/frame_reader.h"
+#include "utility/cipher.h"
+#include "utility/reed_solomon.h"
+#include "utility/journal.h"
 
-#include <serial/serial.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 ///
 /// \brief Includes all software for implementing the serial_communicator.
@@ -16,6 +37,8 @@
 namespace serial_communicator {
 ///
 /// \brief A communicator for transmitting and receiving messages via serial.
+/// \details The communicator is thread safe.  The transmit and receive queues are guarded separately, so any
+/// number of threads may call send() and receive() concurrently with each other and with a thread calling spin().
 ///
 class communicator
 {
@@ -27,6 +50,26 @@ public:
     /// \param baud The baud rate of the serial connection.
     ///
     communicator(std::string port, unsigned int baud, unsigned int data_bits = 8, unsigned int parity_bits = 0, unsigned int stop_bits = 1);
+    ///
+    /// \brief communicator Creates a new communicator instance bonded across several serial ports.
+    /// \param ports The serial ports to communicate over.
+    /// \param bauds The baud rates of each serial port.
+    /// \details Packets are spread across the ports by baud rate and load, and ports that stop responding
+    /// are failed over automatically.  The remote communicator must be bonded across the same links.
+    ///
+    communicator(std::vector<std::string> ports, std::vector<unsigned int> bauds, unsigned int data_bits = 8, unsigned int parity_bits = 0, unsigned int stop_bits = 1);
+    ///
+    /// \brief communicator Creates a new communicator instance over an arbitrary transport.
+    /// \param transport The transport to communicate over. The communicator takes ownership of the pointer.
+    ///
+    communicator(serial_communicator::transport* transport);
+    ///
+    /// \brief communicator Creates a new communicator instance bonded across several arbitrary transports.
+    /// \param transports The transports to communicate over. The communicator takes ownership of the pointers.
+    /// \details Packets are spread across the transports by speed and load, and transports that stop responding
+    /// are failed over automatically.  The remote communicator must be bonded across the same links.
+    ///
+    communicator(std::vector<serial_communicator::transport*> transports);
     ~communicator();
 
     // METHODS
@@ -44,6 +87,17 @@ public:
     ///
     bool send(message* message, bool receipt_required = false, message_status* tracker = nullptr);
     ///
+    /// \brief send Sends a message by moving it into the communicator's transmit queue.
+    /// \param message The message to send, which is moved from if it is queued and left unchanged otherwise.
+    /// \param receipt_required OPTIONAL Indicates that the message should be retransmitted until a receipt is
+    /// received from the receiver, or the maximum amount of transmissions has been reached.
+    /// \param tracker OPTIONAL A pointer that allows external code to monitor the status of a message in real time.
+    /// \return Returns TRUE if the message was successfully placed in the transmit queue, otherwise FALSE.
+    /// \details This behaves as the pointer overload, but the message can live on the stack.  Messages with inline
+    /// data are queued without allocating for the message or its data.
+    ///
+    bool send(message&& message, bool receipt_required = false, message_status* tracker = nullptr);
+    ///
     /// \brief messages_available Gets the total number of messages available to read from the receive queue.
     /// \return The number of available messages to read.
     ///
@@ -56,12 +110,181 @@ public:
     ///
     message* receive(unsigned short id = 0xFFFF);
     ///
+    /// \brief receive_view Grabs a message from the receive queue without copying it out of its receive buffer.
+    /// \param id OPTIONAL The ID of the message to read. Defaults to 0xFFFF, which will grab the next available message.
+    /// \return A view of the received message, which is empty if no message is available.
+    /// \details Messages are selected in the same order as receive().  The view holds the receive buffer that the
+    /// message arrived in until it is released or destroyed, so it should not be held longer than needed.
+    ///
+    message_view receive_view(unsigned short id = 0xFFFF);
+    ///
+    /// \brief receive Grabs a message from the receive queue along with the time it was sent.
+    /// \param timestamp Outputs the time at which the sender queued the message, in the local steady clock.
+    /// \param id OPTIONAL The ID of the message to read. Defaults to 0xFFFF, which will grab the next available message.
+    /// \return A pointer to the received message, or nullptr if none are available. The calling code takes ownership of the message pointer.
+    /// \details The sender's timestamp is corrected for the offset and drift between the clocks once they are
+    /// synchronized, which requires the sender to have timestamps enabled and this communicator to have exchanged
+    /// timestamped receipts with it.  Otherwise the time at which the message arrived is output.
+    ///
+    message* receive(std::chrono::steady_clock::time_point& timestamp, unsigned short id = 0xFFFF);
+    ///
+    /// \brief receive_view Grabs a message from the receive queue without copying it, along with the time it was sent.
+    /// \param timestamp Outputs the time at which the sender queued the message, in the local steady clock.
+    /// \param id OPTIONAL The ID of the message to read. Defaults to 0xFFFF, which will grab the next available message.
+    /// \return A view of the received message, which is empty if no message is available.
+    /// \details The timestamp is output as by receive().
+    ///
+    message_view receive_view(std::chrono::steady_clock::time_point& timestamp, unsigned short id = 0xFFFF);
+    ///
+    /// \brief call Sends a request message and calls back with its response.
+    /// \param request The request message, which is moved from if it is queued and left unchanged otherwise.
+    /// \param timeout The time to wait for the response in milliseconds.
+    /// \param callback The callback, which is given how the call completed and the response if it was received.
+    /// \param receipt_required OPTIONAL Indicates that the request should be retransmitted until a receipt is received.
+    /// \return Returns TRUE if the request was placed in the transmit queue, otherwise FALSE and the callback is not called.
+    /// \details The request is sent with a call ID, and the remote communicator's response to that call ID is handed
+    /// to the callback directly as it is received, without passing through the receive queue.  Any number of calls
+    /// may be outstanding at once.  The callback is called exactly once from the thread calling spin(), and may send
+    /// messages or make calls but must not call spin().
+    ///
+    bool call(message&& request, unsigned int timeout, std::function<void(call_status, const message_view&)> callback, bool receipt_required = false);
+    ///
+    /// \brief call Sends a request message and calls back with its response, given any callable as the callback.
+    /// \details Lambdas without captures convert to bool as well as to std::function, so they are forwarded here
+    /// rather than being ambiguous with the future overload's receipt_required.
+    ///
+    template <typename CALLBACK, typename = typename std::enable_if<!std::is_arithmetic<CALLBACK>::value>::type>
+    bool call(message&& request, unsigned int timeout, CALLBACK callback, bool receipt_required = false)
+    {
+        return call(std::move(request), timeout, std::function<void(call_status, const message_view&)>(callback), receipt_required);
+    }
+    ///
+    /// \brief call Sends a request message and returns a future for its response.
+    /// \param request The request message, which is moved from if it is queued and left unchanged otherwise.
+    /// \param timeout The time to wait for the response in milliseconds.
+    /// \param receipt_required OPTIONAL Indicates that the request should be retransmitted until a receipt is received.
+    /// \return A future for the response.  The future holds a std::runtime_error if the request could not be queued,
+    /// or the call timed out or was cancelled.
+    /// \details This behaves as the callback overload.  The future is completed by spin(), so it must not be waited
+    /// on by the thread calling spin().
+    ///
+    std::future<message_view> call(message&& request, unsigned int timeout, bool receipt_required = false);
+    ///
+    /// \brief receive_request Grabs a request message sent by a remote call from the receive queue.
+    /// \param call Outputs the call ID to respond to.
+    /// \param id OPTIONAL The ID of the message to read. Defaults to 0xFFFF, which will grab the next available request.
+    /// \return A view of the request message, which is empty if no request is available.
+    /// \details Requests are selected in the same order as receive(), skipping messages that are not requests.
+    /// Requests may also be taken by receive(), but can then not be responded to.
+    ///
+    message_view receive_request(unsigned short& call, unsigned short id = 0xFFFF);
+    ///
+    /// \brief respond Sends the response to a remote call.
+    /// \param call The call ID given by receive_request().
+    /// \param response The response message, which is moved from if it is queued and left unchanged otherwise.
+    /// \param receipt_required OPTIONAL Indicates that the response should be retransmitted until a receipt is received.
+    /// \param tracker OPTIONAL A pointer that allows external code to monitor the status of the response in real time.
+    /// \return Returns TRUE if the response was placed in the transmit queue, otherwise FALSE.
+    ///
+    bool respond(unsigned short call, message&& response, bool receipt_required = false, message_status* tracker = nullptr);
+    ///
     /// \brief spin Performs a single spin of the communicator's internal duties.
-    /// \note This should be called at a constant rate within the main loop of external code.
+    /// \note This should be called at a constant rate within the main loop of external code, or whenever
+    /// wait() or the communicator's file descriptor indicate that work is pending.
     /// \details A single spin operation will only attempt to send and received one message. This is to prevent the spin
-    /// method from severely blocking the main loop of the external code.
+    /// method from severely blocking the main loop of the external code.  Spinning does not block when no
+    /// bytes have arrived.
     ///
     void spin();
+    ///
+    /// \brief wait Blocks until the communicator has work pending or the timeout elapses.
+    /// \param timeout The maximum amount of time to wait in milliseconds. A negative value waits indefinitely.
+    /// \return TRUE if work is pending and spin() should be called, otherwise FALSE.
+    /// \details Work is pending when bytes have arrived on the serial port, a message has been queued for sending,
+    /// or a message awaiting a receipt has timed out.  This allows event driven operation in place of spinning at a
+    /// constant rate.
+    ///
+    bool wait(int timeout = -1);
+    ///
+    /// \brief start_capture Starts capturing all transmitted and received packets to a file.
+    /// \param path The path of the capture file, which is replaced if it exists.
+    /// \param size OPTIONAL The size of the capture file's ring in bytes. Once full, the oldest packets are overwritten.
+    /// \details Capturing copies each packet into a memory-mapped file and does not block transmitting or receiving.
+    /// Capture files can be replayed with the serial_communicator_replay tool.
+    ///
+    void start_capture(std::string path, unsigned long size = 16777216);
+    ///
+    /// \brief stop_capture Stops capturing packets and closes the capture file.
+    ///
+    void stop_capture();
+    ///
+    /// \brief start_journal Starts keeping messages that require receipts in a journal file until they are received.
+    /// \param path The path of the journal file.  An existing journal is reopened, and its messages are sent again.
+    /// \param size OPTIONAL The size of a new journal file's ring in bytes.
+    /// \details Journaled messages are retransmitted until they are received, however long the link is down, and
+    /// survive restarts of the process.  Only some of them are held in the transmit queue at once, so memory use stays
+    /// constant while the rest wait in the file.  Delivery is at least once: a message whose receipt was lost before a
+    /// restart is sent again.  Trackers follow messages while they are held in the transmit queue; the tracker of a
+    /// message that waits in the file is set to QUEUED and is not updated again.  Messages that belong to calls are not
+    /// journaled.  Throws std::invalid_argument if the size can not hold a single message, or std::runtime_error if the
+    /// journal file can not be opened.
+    ///
+    void start_journal(std::string path, unsigned long size = 16777216);
+    ///
+    /// \brief stop_journal Stops journaling messages and closes the journal file.
+    /// \details Messages already in the transmit queue are sent as usual.  Messages still waiting in the file are sent
+    /// once the journal is started again.
+    ///
+    void stop_journal();
+    ///
+    /// \brief start_negotiation Starts adapting the baud rate of each link to the link's quality.
+    /// \param bauds The baud rates that links may run at.  The remote communicator must be given the same rates.
+    /// \return TRUE if negotiation was started on every link, or FALSE if a link's transport does not have a baud rate
+    /// or the communicator is on a multi-drop bus.
+    /// \details Each link steps up through the rates while it is free of errors, and steps down when checksum
+    /// failures or receipt timeouts become frequent.  Both communicators agree on each change and switch together,
+    /// and revert if the link does not work at the new rate.  Messages are held off a link while it changes rate.
+    /// Errors are only seen when there is traffic, so a link that loses sync after a change recovers once messages
+    /// with receipts, or messages in both directions, are sent over it.
+    ///
+    bool start_negotiation(std::vector<unsigned int> bauds);
+    ///
+    /// \brief stop_negotiation Stops adapting baud rates.  Links remain at their current rates.
+    ///
+    void stop_negotiation();
+    ///
+    /// \brief start_encryption Starts sealing every packet with authenticated encryption under a pre-shared key.
+    /// \param key The pre-shared key, which must be 32 bytes.  The remote communicator must be given the same key.
+    /// \param algorithm OPTIONAL The authenticated encryption algorithm, which the remote communicator must share.
+    /// \details Everything after the front of each packet is encrypted, and the checksum is replaced by a 12 byte
+    /// nonce and a 16 byte authentication tag.  The front, which holds the sequence number, receipt field, message
+    /// ID, priority, and data length, is authenticated but not encrypted, as are the nodes of packets on a bus.
+    /// Once started, packets that are not sealed, or fail to open, are dropped without a receipt, so the sender
+    /// retransmits messages that require one.  Packets that have already been received are dropped as replays.
+    /// Replays are tracked from the first packet received from each node, and each communicator's nonces keep
+    /// increasing across restarts as long as its wall clock does.  Nonces are kept apart between communicators by a
+    /// salt drawn from a secure random generator.  Throws std::invalid_argument if the key is the wrong length.
+    ///
+    void start_encryption(std::vector<unsigned char> key, serial_communicator::encryption algorithm = serial_communicator::encryption::CHACHA20_POLY1305);
+    ///
+    /// \brief stop_encryption Stops sealing packets, and accepts packets that are not sealed.
+    ///
+    void stop_encryption();
+    ///
+    /// \brief start_error_correction Starts protecting every packet with Reed-Solomon forward error correction.
+    /// \param min_parity OPTIONAL The fewest parity bytes added to each codeword of up to 255 bytes.
+    /// \param max_parity OPTIONAL The most parity bytes added to each codeword, up to 64.
+    /// \details The front of each packet is protected by a codeword of its own, and the rest is split into codewords
+    /// that each correct up to half as many corrupted bytes as they have parity bytes, without a retransmission.
+    /// The number of parity bytes is chosen for each packet from the error rate measured on the link it is sent over,
+    /// between the given bounds, and is sent with the packet.  The remote communicator must also be correcting errors,
+    /// though its bounds may differ.  Throws std::invalid_argument if the bounds are out of range.
+    ///
+    void start_error_correction(unsigned int min_parity = 2, unsigned int max_parity = 32);
+    ///
+    /// \brief stop_error_correction Stops protecting packets with forward error correction.
+    ///
+    void stop_error_correction();
 
     // PROPERTIES
     ///
@@ -126,6 +349,80 @@ public:
     /// \note The default value is 5 transmissions.
     ///
     void p_max_transmissions(unsigned char value);
+    ///
+    /// \brief p_reorder_window Gets the reorder window in milliseconds.
+    /// \return The reorder window in milliseconds.
+    /// \details When bonded across several ports, packets may arrive out of order.  Received messages are held
+    /// for the reorder window before they can be received, giving earlier packets on slower links time to arrive.
+    /// This has no effect on a communicator with a single port.
+    /// \note The default value is 10ms.
+    ///
+    unsigned int p_reorder_window();
+    ///
+    /// \brief p_reorder_window Sets the reorder window in milliseconds.
+    /// \param value The reorder window in milliseconds.
+    /// \details When bonded across several ports, packets may arrive out of order.  Received messages are held
+    /// for the reorder window before they can be received, giving earlier packets on slower links time to arrive.
+    /// This has no effect on a communicator with a single port.
+    /// \note The default value is 10ms.
+    ///
+    void p_reorder_window(unsigned int value);
+    ///
+    /// \brief p_timestamps Gets if messages are sent with timestamps.
+    /// \return TRUE if messages are sent with timestamps, otherwise FALSE.
+    /// \details Timestamped messages carry the time they were queued, and their receipts carry the times the
+    /// receiver got the message and sent the receipt.  The round trips of timestamped messages sent with a
+    /// receipt required synchronize this communicator's clock with the receiver's, so that timestamps received
+    /// from it can be corrected.  Timestamped messages can only be received by communicators that support them.
+    /// \note The default value is FALSE.
+    ///
+    bool p_timestamps();
+    ///
+    /// \brief p_timestamps Sets if messages are sent with timestamps.
+    /// \param value TRUE to send messages with timestamps, otherwise FALSE.
+    /// \details Timestamped messages carry the time they were queued, and their receipts carry the times the
+    /// receiver got the message and sent the receipt.  The round trips of timestamped messages sent with a
+    /// receipt required synchronize this communicator's clock with the receiver's, so that timestamps received
+    /// from it can be corrected.  Timestamped messages can only be received by communicators that support them.
+    /// \note The default value is FALSE.
+    ///
+    void p_timestamps(bool value);
+    ///
+    /// \brief p_node Gets the communicator's node on a multi-drop bus.
+    /// \return The node, or 0xFF if the communicator is not on a bus.
+    /// \note The default value is 0xFF.
+    ///
+    unsigned char p_node();
+    ///
+    /// \brief p_node Sets the communicator's node on a multi-drop bus, such as RS-485.
+    /// \param value The node, from 0 to 254, or 0xFF to talk to a single peer.  Every communicator on a bus must
+    /// have a node, and no two may share one.
+    /// \details Packets on a bus carry the nodes they are sent to and from.  Messages are sent to the node given by
+    /// their p_node(), or broadcast to every node if it is 0xFF, and received messages give the node they came from.
+    /// Receipts are returned to the node that sent the message, so sending a broadcast that requires a receipt throws
+    /// std::invalid_argument.  Responses to calls should be sent to the node of the request.  Packets for other nodes
+    /// are skipped as they arrive.  Before transmitting a message, a node waits for the bus to be quiet for a
+    /// turnaround, which leaves the addressed node time to answer, and then for a short slot per lower node, so the
+    /// lowest waiting node wins the bus.  Baud rate negotiation and clock synchronization are not available on a bus.
+    ///
+    void p_node(unsigned char value);
+    ///
+    /// \brief p_file_descriptor Gets a file descriptor that becomes readable when the communicator has work pending.
+    /// \return The file descriptor, which may be added to an external poll, select, or epoll loop.
+    /// \details The descriptor is level triggered and remains readable until spin() is called.  The descriptor is
+    /// owned by the communicator and must not be read from or closed by external code.
+    ///
+    int p_file_descriptor() const;
+    ///
+    /// \brief p_statistics Gets the communicator's link and queue statistics.
+    /// \return A reference to the communicator's statistics, which may be read from any thread.
+    ///
+    const serial_communicator::statistics& p_statistics() const;
+    ///
+    /// \brief p_statistics Gets the communicator's link and queue statistics for resetting.
+    /// \return A reference to the communicator's statistics.
+    ///
+    serial_communicator::statistics& p_statistics();
 
 private:
     // ENUMERATIONS
@@ -137,7 +434,24 @@ private:
         NOT_REQUIRED = 0,       ///< In a transmitted message, indicates that no receipt is required from the receiver.
         REQUIRED = 1,           ///< In a transmitted message, indicates that a receipt is required from the receiver.
         RECEIVED = 2,           ///< In a receipt message, indicates that the message was properly received.
-        CHECKSUM_MISMATCH = 3   ///< In a receipt message, indicates that the message was received, but the checksum did not match.
+        CHECKSUM_MISMATCH = 3,  ///< In a receipt message, indicates that the message was received, but the checksum did not match.
+        CONTROL = 4             ///< Indicates a control packet for negotiating the link, which is not a message.
+    };
+
+    // STRUCTURES
+    ///
+    /// \brief A call that is waiting for its response.
+    ///
+    struct pending_call
+    {
+        ///
+        /// \brief callback The callback to complete the call with.
+        ///
+        std::function<void(call_status, const message_view&)> callback;
+        ///
+        /// \brief deadline The time at which the call times out.
+        ///
+        std::chrono::steady_clock::time_point deadline;
     };
 
     // CONSTANTS
@@ -149,30 +463,167 @@ private:
     /// \brief m_escape_byte Stores the message escape byte.
     ///
     const unsigned char m_escape_byte = 0x1B;
+    ///
+    /// \brief m_timestamp_flag Stores the bit of the receipt field that marks a packet as timestamped.
+    /// \details Timestamped messages end with the 8 byte time they were queued, and timestamped receipts with the
+    /// 8 byte times the message arrived and the receipt was sent.  Times are big endian signed microseconds of a
+    /// monotonic clock, and follow the data before the checksum.
+    ///
+    const unsigned char m_timestamp_flag = 0x80;
+    ///
+    /// \brief m_call_flag Stores the bit of the receipt field that marks a message as belonging to a call.
+    /// \details Such messages carry a 2 byte big endian call field between the data and any timestamps.
+    ///
+    const unsigned char m_call_flag = 0x40;
+    ///
+    /// \brief m_sealed_flag Stores the bit of the receipt field that marks a packet as sealed.
+    /// \details Sealed packets are encrypted after the front, and end with a nonce and authentication tag in place
+    /// of the checksum.
+    ///
+    const unsigned char m_sealed_flag = 0x20;
+    ///
+    /// \brief m_response_bit Stores the bit of the call field that marks a message as a response.
+    ///
+    const unsigned short m_response_bit = 0x8000;
+    ///
+    /// \brief m_bus_turnaround Stores the time in microseconds that the bus must be quiet before any node may
+    /// transmit a message, which leaves the node that was just addressed time to send its receipt.
+    ///
+    const unsigned int m_bus_turnaround = 2000;
+    ///
+    /// \brief m_bus_slot Stores the length of each node's arbitration slot in byte times.
+    ///
+    const unsigned int m_bus_slot = 2;
+    ///
+    /// \brief m_closed_poll_interval Stores the interval in milliseconds at which closed links are checked for having
+    /// been opened again.
+    ///
+    const unsigned int m_closed_poll_interval = 1000;
+    ///
+    /// \brief m_front_parity Stores the number of parity bytes protecting the front of each error corrected packet.
+    ///
+    const unsigned int m_front_parity = 4;
 
     // PARAMETERS
     ///
     /// \brief m_queue_size Stores the size of the transmit/receive queues, in messages.
+    /// \note Only changes while m_spin_mutex, m_tx_mutex, and m_rx_mutex are all held.
     ///
     unsigned short m_queue_size;
     ///
     /// \brief m_receipt_timeout Stores the receipt timeout in milliseconds.
     ///
-    unsigned int m_receipt_timeout;
+    std::atomic<unsigned int> m_receipt_timeout;
     ///
     /// \brief m_max_transmissions Stores the maximum amount of transmissions for one message.
     ///
-    unsigned char m_max_transmissions;
+    std::atomic<unsigned char> m_max_transmissions;
+    ///
+    /// \brief m_reorder_window Stores the reorder window in milliseconds.
+    ///
+    std::atomic<unsigned int> m_reorder_window;
+    ///
+    /// \brief m_timestamps Stores if messages are sent with timestamps.
+    ///
+    std::atomic<bool> m_timestamps;
+    ///
+    /// \brief m_node Stores the communicator's node on a multi-drop bus, or 0xFF if it is not on a bus.
+    ///
+    std::atomic<unsigned char> m_node;
 
     // VARIABLES
     ///
-    /// \brief m_serial_port The communicator's serial port.
+    /// \brief m_links The communicator's links.
     ///
-    serial::Serial* m_serial_port;
+    std::vector<utility::link*> m_links;
+    ///
+    /// \brief m_readers Assembles the packets received over each link, in the same order as the links.
+    ///
+    std::vector<utility::frame_reader*> m_readers;
+    ///
+    /// \brief m_polled Stores if each link's file descriptor is in the epoll set, in the same order as the links.
+    /// \note Only used by the spinning thread.
+    ///
+    std::vector<bool> m_polled;
+    ///
+    /// \brief m_rx_history Stores the most recently received sequence numbers, with the node they came from in the
+    /// upper bits, for discarding duplicates across links.
+    ///
+    std::vector<unsigned long long> m_rx_history;
+    ///
+    /// \brief m_rx_history_position Stores the next position to write to in the received sequence history.
+    ///
+    unsigned int m_rx_history_position;
+    ///
+    /// \brief m_statistics Stores the communicator's link and queue statistics.
+    ///
+    serial_communicator::statistics m_statistics;
+    ///
+    /// \brief m_capture Stores the active packet capture, or nullptr if not capturing.
+    ///
+    utility::capture* m_capture;
+    ///
+    /// \brief m_journal Stores the journal of messages that require receipts, or nullptr if not journaling.
+    /// \note Protected by m_tx_mutex.
+    ///
+    utility::journal* m_journal;
+    ///
+    /// \brief m_clock Estimates the remote communicator's clock from timestamped receipts.
+    /// \note Only used by the spinning thread.
+    ///
+    utility::clock_sync m_clock;
+    ///
+    /// \brief m_cipher Stores the cipher that seals and opens packets, or nullptr if not encrypting.
+    /// \note Only used by the spinning thread.
+    ///
+    utility::cipher* m_cipher;
+    ///
+    /// \brief m_sealed Stores the encrypted bytes of the packet being sealed, reused from packet to packet.
+    ///
+    std::vector<unsigned char> m_sealed;
+    ///
+    /// \brief m_correcting Stores if packets are protected with forward error correction.
+    /// \note Only used by the spinning thread.
+    ///
+    bool m_correcting;
+    ///
+    /// \brief m_min_parity Stores the fewest parity bytes added to each codeword.
+    ///
+    unsigned int m_min_parity;
+    ///
+    /// \brief m_max_parity Stores the most parity bytes added to each codeword.
+    ///
+    unsigned int m_max_parity;
+    ///
+    /// \brief m_parity Stores the parity bytes of the packet being written, reused from packet to packet.
+    ///
+    std::vector<unsigned char> m_parity;
     ///
     /// \brief m_sequence_counter Stores the current sequence number for assigning unique and monotonic sequence IDs to messages.
     ///
     unsigned int m_sequence_counter;
+    ///
+    /// \brief m_calls Stores the calls waiting for their responses, by call ID.
+    ///
+    std::map<unsigned short, pending_call> m_calls;
+    ///
+    /// \brief m_call_counter Stores the next call ID to try.
+    ///
+    unsigned short m_call_counter;
+
+    // EVENTS
+    ///
+    /// \brief m_epoll_fd The epoll instance that aggregates all of the communicator's event sources.
+    ///
+    int m_epoll_fd;
+    ///
+    /// \brief m_queue_fd An eventfd signalled when transmit work is pending.
+    ///
+    int m_queue_fd;
+    ///
+    /// \brief m_timer_fd A timerfd armed to the earliest receipt timeout in the transmit queue.
+    ///
+    int m_timer_fd;
 
     // QUEUES
     ///
@@ -184,8 +635,73 @@ private:
     ///
     utility::inbound** m_rx_queue;
 
+    // SYNCHRONIZATION
+    ///
+    /// \brief m_spin_mutex Serializes spin() calls and queue resizing.
+    /// \details Only the thread holding this mutex may transmit, read the serial port, or remove
+    /// entries from the transmit queue.  This allows outbound entries to be used without holding
+    /// m_tx_mutex while they are being written to the serial port.
+    ///
+    std::mutex m_spin_mutex;
+    ///
+    /// \brief m_tx_mutex Guards the transmit queue and the sequence counter.
+    ///
+    mutable std::mutex m_tx_mutex;
+    ///
+    /// \brief m_rx_mutex Guards the receive queue.
+    /// \note Mutexes are always acquired in the order m_spin_mutex, m_tx_mutex, m_rx_mutex, m_calls_mutex.
+    ///
+    mutable std::mutex m_rx_mutex;
+    ///
+    /// \brief m_calls_mutex Guards the pending calls and the call counter.
+    /// \note Acquired after all other mutexes, and never held while a callback is called.
+    ///
+    std::mutex m_calls_mutex;
+
     // METHODS
     ///
+    /// \brief initialize Initializes the communicator's parameters, queues, and event sources once its links exist.
+    ///
+    void initialize();
+    ///
+    /// \brief link_index Gets the index of a link.
+    /// \param link The link.
+    /// \return The index of the link within the communicator's links.
+    ///
+    unsigned char link_index(const utility::link* link) const;
+    ///
+    /// \brief select_link Selects the link to transmit a packet over.
+    /// \param length The length of the packet in bytes.
+    /// \param previous OPTIONAL A link to avoid, such as one that the packet was previously sent over without success.
+    /// \return The usable link that would complete transmission of the packet the soonest.
+    ///
+    utility::link* select_link(unsigned int length, utility::link* previous = nullptr);
+    ///
+    /// \brief sendable Checks if any link can currently carry packets.
+    /// \return TRUE if select_link() will find a link, or FALSE if every link is changing baud rate.
+    ///
+    bool sendable() const;
+    ///
+    /// \brief bus_delay Gets the time until this node may transmit a message on a multi-drop bus.
+    /// \return The time in microseconds, which is 0 if the bus is free or the communicator is not on a bus.
+    ///
+    unsigned long long bus_delay();
+    ///
+    /// \brief select_inbound Finds the next message to receive from the receive queue.
+    /// \param id The ID of the message to find, or 0xFFFF for any message.
+    /// \param location Outputs the message's location in the receive queue.
+    /// \param requests OPTIONAL Indicates that only requests from remote calls should be found.
+    /// \return TRUE if a message was found, otherwise FALSE.
+    /// \note The receive queue must be locked by the caller.
+    ///
+    bool select_inbound(unsigned short id, unsigned short& location, bool requests = false) const;
+    ///
+    /// \brief releasable Checks if an inbound message is past the reorder window and may be received.
+    /// \param inbound The inbound message to check.
+    /// \return TRUE if the message may be received, otherwise FALSE.
+    ///
+    bool releasable(const utility::inbound* inbound) const;
+    ///
     /// \brief spin_tx Conducts the transmit duties during a spin cycle.
     ///
     void spin_tx();
@@ -194,6 +710,52 @@ private:
     ///
     void spin_rx();
     ///
+    /// \brief spin_rx Receives a single packet from a link, if one has arrived.
+    /// \param link The link to receive from.
+    /// \param reader The link's packet assembler.
+    /// \details At most one chunk of bytes that have already arrived is read, so a spin never waits on the link.
+    ///
+    void spin_rx(utility::link* link, utility::frame_reader* reader);
+    ///
+    /// \brief spin_negotiation Conducts the baud rate negotiation duties of each link during a spin cycle.
+    ///
+    void spin_negotiation();
+    ///
+    /// \brief spin_calls Times out calls whose responses have not arrived in time.
+    ///
+    void spin_calls();
+    ///
+    /// \brief queue Places a message into the transmit queue.
+    /// \param message The message, which is moved from if it is queued.
+    /// \param receipt_required Indicates that the message should be retransmitted until a receipt is received.
+    /// \param tracker A pointer that allows external code to monitor the status of the message, or nullptr.
+    /// \param has_call Indicates that the message belongs to a call.
+    /// \param call The message's call field, if it belongs to a call.
+    /// \return TRUE if the message was placed in the transmit queue, otherwise FALSE.
+    ///
+    bool queue(message&& message, bool receipt_required, message_status* tracker, bool has_call, unsigned short call);
+    ///
+    /// \brief journal_message Appends a message to the journal, and places it into the transmit queue if there is room.
+    /// \param message The message, which is moved from if it is placed into the transmit queue.
+    /// \param tracker A pointer that allows external code to monitor the status of the message, or nullptr.
+    /// \return TRUE if the message was journaled, or FALSE if the journal is full.
+    /// \note Must be called with m_tx_mutex held.
+    ///
+    bool journal_message(message&& message, message_status* tracker);
+    ///
+    /// \brief load_journal Places messages waiting in the journal into the transmit queue while there is room.
+    /// \note Must be called with m_tx_mutex held.
+    ///
+    void load_journal();
+    ///
+    /// \brief clear_events Resets the queue and timer event sources.
+    ///
+    void clear_events();
+    ///
+    /// \brief update_events Re-arms the queue and timer event sources from the current state of the transmit queue.
+    ///
+    void update_events();
+    ///
     /// \brief tx Serializes a message and writes it to the serial buffer.
     /// \param message The message to write.
     ///
@@ -202,23 +764,64 @@ private:
     /// \brief tx Writes data to a serial buffer with proper escapement.
     /// \param buffer The buffer of unescaped packet bytes to escape and send.
     /// \param length The length of the unescaped packet buffer.
+    /// \param link The link to write to.
+    /// \param destination OPTIONAL The bus node to send the packet to, or 0xFF for all nodes.
+    ///
+    void tx(unsigned char* buffer, unsigned int length, utility::link* link, unsigned char destination = 0xFF);
+    ///
+    /// \brief tx Writes a packet given as several segments to a serial buffer with proper escapement.
+    /// \param segments The segments of unescaped packet bytes, in order, beginning with the header byte and ending
+    /// with the checksum.
+    /// \param n_segments The number of segments.
+    /// \param link The link to write to.
+    /// \param destination OPTIONAL The bus node to send the packet to, or 0xFF for all nodes.
+    /// \details Segments are escaped as they are written, so large segments are not copied to be framed.  On a bus,
+    /// the destination and source nodes are inserted after the header, and the checksum is extended to cover them.
+    /// While encrypting, the packet is sealed in place of its checksum.
+    ///
+    void tx(const iovec* segments, unsigned int n_segments, utility::link* link, unsigned char destination = 0xFF);
+    ///
+    /// \brief write_packet Escapes and writes a framed packet given as segments.
+    /// \param segments The segments of unescaped packet bytes, in order, beginning with the header byte.
+    /// \param n_segments The number of segments.
+    /// \param link The link to write to.
+    /// \param destination The bus node to send the packet to, or 0xFF for all nodes.
+    /// \param checksummed Indicates that the packet ends with a checksum, which is extended over the nodes on a bus.
+    /// \details While correcting errors, the packet is written as codewords, each followed by its parity.
+    ///
+    void write_packet(const iovec* segments, unsigned int n_segments, utility::link* link, unsigned char destination, bool checksummed);
+    ///
+    /// \brief select_parity Selects the number of parity bytes to add to each codeword of a packet.
+    /// \param link The link that the packet will be sent over.
+    /// \param length The number of packet bytes after the front.
+    /// \return The number of parity bytes, within the bounds given to start_error_correction().
+    ///
+    unsigned int select_parity(utility::link* link, unsigned int length) const;
+    ///
+    /// \brief tx Writes a negotiation control packet to a serial buffer.
+    /// \param control The contents of the control packet.
+    /// \param link The link to write to.
+    ///
+    void tx(const utility::negotiator::control& control, utility::link* link);
+    ///
+    /// \brief packet_length Gets the full length of a received packet from its front.
+    /// \param front The header, sequence, receipt, id, priority, and data length fields of the packet.
+    /// \return The length of the packet in bytes.
     ///
-    void tx(unsigned char* buffer, unsigned int length);
+    unsigned int packet_length(const unsigned char* front) const;
     ///
-    /// \brief rx Reads a specified amount of bytes from the serial buffer.
-    /// \param buffer The pre-allocated buffer to store read bytes in.
-    /// \param length The number of bytes to read.
-    /// \return TRUE if length bytes was read successfully, otherwise FALSE (a.k.a. timeout)
-    /// \details This method will read bytes from the buffer and correct for escape bytes.
+    /// \brief timestamps_length Gets the length of the timestamps that follow a packet's data.
+    /// \param receipt The packet's receipt field.
+    /// \return The length of the timestamps in bytes.
     ///
-    bool rx(unsigned char* buffer, unsigned int length);
+    unsigned int timestamps_length(unsigned char receipt) const;
     ///
     /// \brief checksum Calculates the XOR checksum of the provided data array.
     /// \param data The data to calculate the checksum for.
     /// \param length The length of the data array.
     /// \return The XOR checksum of the data.
     ///
-    unsigned char checksum(unsigned char* data, unsigned int length);
+    unsigned char checksum(const unsigned char* data, unsigned int length);
 };
 }
 
@@ -0,0 +1,49 @@
+/// \file diagnostics.h
+/// \brief Defines the serial_communicator::diagnostics class.
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "statistics.h"
+
+#include <ros/ros.h>
+
+#include <string>
+
+namespace serial_communicator {
+///
+/// \brief Publishes a communicator's statistics on the ROS diagnostics topic.
+///
+class diagnostics
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief diagnostics Creates a new diagnostics instance.
+    /// \param node_handle The node handle to advertise the /diagnostics topic with.
+    /// \param name The name of the diagnostic status, such as the serial port the communicator is using.
+    ///
+    diagnostics(ros::NodeHandle& node_handle, std::string name);
+
+    // METHODS
+    ///
+    /// \brief publish Publishes a snapshot of the statistics.
+    /// \param statistics The statistics to publish.
+    /// \details Counters and gauges are published directly, and each timing is published as its count, mean,
+    /// 50th, 99th percentile, and maximum in microseconds.
+    ///
+    void publish(const statistics& statistics);
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_publisher The /diagnostics publisher.
+    ///
+    ros::Publisher m_publisher;
+    ///
+    /// \brief m_name Stores the name of the diagnostic status.
+    ///
+    std::string m_name;
+};
+}
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,17 @@
+/// \file encryption.h
+/// \brief Defines the serial_communicator::encryption enumeration.
+#ifndef ENCRYPTION_H
+#define ENCRYPTION_H
+
+namespace serial_communicator {
+///
+/// \brief Enumerates the authenticated encryption algorithms that packets can be sealed with.
+///
+enum class encryption
+{
+  CHACHA20_POLY1305 = 0,    ///< ChaCha20 with a Poly1305 tag, which is fast on any processor.
+  AES_256_GCM = 1           ///< AES-256 in Galois/counter mode, which is fastest on processors with AES instructions.
+};
+}
+
+#endif // ENCRYPTION_H
@@ -0,0 +1,42 @@
+/// \file inbound.inl
+/// \brief Implements the serial_communicator::utility::inbound accessors.
+#ifndef INBOUND_INL
+#define INBOUND_INL
+
+#include "serial_communicator/inline/inline.h"
+
+namespace serial_communicator {
+namespace utility {
+// PROPERTIES
+SERIAL_COMMUNICATOR_HOT const message_view& inbound::p_view() const
+{
+    return inbound::m_view;
+}
+SERIAL_COMMUNICATOR_HOT unsigned int inbound::p_sequence_number() const
+{
+    return inbound::m_sequence_number;
+}
+SERIAL_COMMUNICATOR_HOT std::chrono::steady_clock::time_point inbound::p_timestamp() const
+{
+    return inbound::m_timestamp;
+}
+SERIAL_COMMUNICATOR_HOT std::chrono::steady_clock::time_point inbound::p_origin_timestamp() const
+{
+    return inbound::m_origin_timestamp;
+}
+SERIAL_COMMUNICATOR_HOT bool inbound::p_has_call() const
+{
+    return inbound::m_has_call;
+}
+SERIAL_COMMUNICATOR_HOT unsigned short inbound::p_call() const
+{
+    return inbound::m_call;
+}
+SERIAL_COMMUNICATOR_HOT void inbound::p_call(unsigned short value)
+{
+    inbound::m_has_call = true;
+    inbound::m_call = value;
+}
+}}
+
+#endif // INBOUND_INL
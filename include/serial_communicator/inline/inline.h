@@ -0,0 +1,16 @@
+/// \file inline.h
+/// \brief Defines the SERIAL_COMMUNICATOR_HOT specifier for hot path implementations.
+/// \details The small accessors on the serialization hot path are implemented in the .inl files alongside this
+/// header.  When built with SERIAL_COMMUNICATOR_INLINE, the class headers include them so that they can be inlined
+/// into calling code, and SERIAL_COMMUNICATOR_HOT marks them inline.  Otherwise they are compiled into the library
+/// as ordinary functions.  The library and all code using it must agree on SERIAL_COMMUNICATOR_INLINE.
+#ifndef INLINE_H
+#define INLINE_H
+
+#ifdef SERIAL_COMMUNICATOR_INLINE
+#define SERIAL_COMMUNICATOR_HOT inline
+#else
+#define SERIAL_COMMUNICATOR_HOT
+#endif
+
+#endif // INLINE_H
@@ -0,0 +1,64 @@
+/// \file message.inl
+/// \brief Implements the serial_communicator::message field accessors and properties.
+#ifndef MESSAGE_INL
+#define MESSAGE_INL
+
+#include "serial_communicator/inline/inline.h"
+#include "serial_communicator/utility/bounds.h"
+#include "serial_communicator/utility/byte_order.h"
+
+namespace serial_communicator {
+// METHODS
+template <typename T>
+SERIAL_COMMUNICATOR_HOT void message::set_field(unsigned short address, T data)
+{
+    utility::check_bounds(address, sizeof(T), message::m_data_length);
+    utility::store_big_endian(&message::m_data[address], data);
+}
+template <typename T>
+SERIAL_COMMUNICATOR_HOT T message::get_field(unsigned short address) const
+{
+    utility::check_bounds(address, sizeof(T), message::m_data_length);
+    return utility::load_big_endian<T>(&message::m_data[address]);
+}
+
+// PROPERTIES
+SERIAL_COMMUNICATOR_HOT unsigned short message::p_id() const
+{
+    return message::m_id;
+}
+SERIAL_COMMUNICATOR_HOT unsigned char message::p_priority() const
+{
+    return message::m_priority;
+}
+SERIAL_COMMUNICATOR_HOT void message::p_priority(unsigned char value)
+{
+    message::m_priority = value;
+}
+SERIAL_COMMUNICATOR_HOT unsigned char message::p_node() const
+{
+    return message::m_node;
+}
+SERIAL_COMMUNICATOR_HOT void message::p_node(unsigned char value)
+{
+    message::m_node = value;
+}
+SERIAL_COMMUNICATOR_HOT unsigned short message::p_data_length() const
+{
+    return message::m_data_length;
+}
+SERIAL_COMMUNICATOR_HOT unsigned int message::p_message_length() const
+{
+    return message::m_data_length + 5;
+}
+SERIAL_COMMUNICATOR_HOT unsigned char* message::p_data()
+{
+    return message::m_data;
+}
+SERIAL_COMMUNICATOR_HOT const unsigned char* message::p_data() const
+{
+    return message::m_data;
+}
+}
+
+#endif // MESSAGE_INL
@@ -0,0 +1,50 @@
+/// \file message_view.inl
+/// \brief Implements the serial_communicator::message_view field accessors and properties.
+#ifndef MESSAGE_VIEW_INL
+#define MESSAGE_VIEW_INL
+
+#include "serial_communicator/inline/inline.h"
+#include "serial_communicator/utility/bounds.h"
+#include "serial_communicator/utility/byte_order.h"
+
+namespace serial_communicator {
+// METHODS
+template <typename T>
+SERIAL_COMMUNICATOR_HOT T message_view::get_field(unsigned short address) const
+{
+    utility::check_bounds(address, sizeof(T), message_view::p_data_length());
+    return utility::load_big_endian<T>(message_view::p_data() + address);
+}
+
+// PROPERTIES
+SERIAL_COMMUNICATOR_HOT bool message_view::p_valid() const
+{
+    return message_view::m_buffer != nullptr;
+}
+SERIAL_COMMUNICATOR_HOT unsigned short message_view::p_id() const
+{
+    return static_cast<unsigned short>((message_view::m_message[0] << 8) | message_view::m_message[1]);
+}
+SERIAL_COMMUNICATOR_HOT unsigned char message_view::p_priority() const
+{
+    return message_view::m_message[2];
+}
+SERIAL_COMMUNICATOR_HOT unsigned char message_view::p_node() const
+{
+    return message_view::m_buffer->p_source();
+}
+SERIAL_COMMUNICATOR_HOT unsigned short message_view::p_data_length() const
+{
+    return static_cast<unsigned short>((message_view::m_message[3] << 8) | message_view::m_message[4]);
+}
+SERIAL_COMMUNICATOR_HOT unsigned int message_view::p_message_length() const
+{
+    return message_view::p_data_length() + 5;
+}
+SERIAL_COMMUNICATOR_HOT const unsigned char* message_view::p_data() const
+{
+    return message_view::m_message + 5;
+}
+}
+
+#endif // MESSAGE_VIEW_INL
@@ -0,0 +1,72 @@
+/// \file outbound.inl
+/// \brief Implements the serial_communicator::utility::outbound accessors.
+#ifndef OUTBOUND_INL
+#define OUTBOUND_INL
+
+#include "serial_communicator/inline/inline.h"
+
+namespace serial_communicator {
+namespace utility {
+// METHODS
+SERIAL_COMMUNICATOR_HOT bool outbound::can_retransmit(unsigned char transmit_limit) const
+{
+    return outbound::m_n_transmissions < transmit_limit;
+}
+
+// PROPERTIES
+SERIAL_COMMUNICATOR_HOT const message* outbound::p_message() const
+{
+    return &(outbound::m_message);
+}
+SERIAL_COMMUNICATOR_HOT unsigned int outbound::p_sequence_number() const
+{
+    return outbound::m_sequence_number;
+}
+SERIAL_COMMUNICATOR_HOT bool outbound::p_receipt_required() const
+{
+    return outbound::m_receipt_required;
+}
+SERIAL_COMMUNICATOR_HOT unsigned char outbound::p_n_transmissions() const
+{
+    return outbound::m_n_transmissions;
+}
+SERIAL_COMMUNICATOR_HOT message_status outbound::p_status() const
+{
+    return outbound::m_status;
+}
+SERIAL_COMMUNICATOR_HOT utility::link* outbound::p_link() const
+{
+    return outbound::m_link;
+}
+SERIAL_COMMUNICATOR_HOT std::chrono::steady_clock::time_point outbound::p_queue_timestamp() const
+{
+    return outbound::m_queue_timestamp;
+}
+SERIAL_COMMUNICATOR_HOT std::chrono::steady_clock::time_point outbound::p_transmit_timestamp() const
+{
+    return outbound::m_transmit_timestamp;
+}
+SERIAL_COMMUNICATOR_HOT bool outbound::p_has_call() const
+{
+    return outbound::m_has_call;
+}
+SERIAL_COMMUNICATOR_HOT unsigned short outbound::p_call() const
+{
+    return outbound::m_call;
+}
+SERIAL_COMMUNICATOR_HOT void outbound::p_call(unsigned short value)
+{
+    outbound::m_has_call = true;
+    outbound::m_call = value;
+}
+SERIAL_COMMUNICATOR_HOT unsigned long long outbound::p_journal_position() const
+{
+    return outbound::m_journal_position;
+}
+SERIAL_COMMUNICATOR_HOT void outbound::p_journal_position(unsigned long long value)
+{
+    outbound::m_journal_position = value;
+}
+}}
+
+#endif // OUTBOUND_INL
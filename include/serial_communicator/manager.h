@@ -0,0 +1,132 @@
+/// \file manager.h
+/// \brief Defines the serial_communicator::manager class.
+#ifndef MANAGER_H
+#define MANAGER_H
+
+#include "communicator.h"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace serial_communicator {
+///
+/// \brief Manages many communicators using a shared pool of I/O threads.
+/// \details Each communicator's file descriptor is multiplexed on a single epoll instance that is serviced by
+/// the manager's worker threads.  A communicator is only ever spun by one worker at a time, so the number of
+/// threads is independent of the number of communicators.
+///
+class manager
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief manager Creates a new manager instance.
+    /// \param n_threads The number of worker threads to service the communicators with.
+    ///
+    manager(unsigned int n_threads = 1);
+    ~manager();
+
+    // METHODS
+    ///
+    /// \brief add Adds a communicator to the manager.
+    /// \param communicator The communicator to add. The manager takes ownership of the pointer.
+    /// \return The index of the communicator within the manager.
+    /// \details Communicators may be added before or after the manager is started.
+    ///
+    unsigned short add(communicator* communicator);
+    ///
+    /// \brief start Starts the worker threads.
+    ///
+    void start();
+    ///
+    /// \brief stop Stops the worker threads.
+    /// \details Blocks until all worker threads have finished their current spin.
+    ///
+    void stop();
+    ///
+    /// \brief send Sends a message through one of the managed communicators.
+    /// \param index The index of the communicator to send the message through.
+    /// \param message The message to send. The manager takes ownership of the pointer.
+    /// \param receipt_required OPTIONAL Indicates that the message should be retransmitted until a receipt is received.
+    /// \param tracker OPTIONAL A pointer that allows external code to monitor the status of a message in real time.
+    /// \return Returns TRUE if the message was successfully placed in the transmit queue, otherwise FALSE.
+    ///
+    bool send(unsigned short index, message* message, bool receipt_required = false, message_status* tracker = nullptr);
+    ///
+    /// \brief receive Grabs a message from the receive queue of any managed communicator.
+    /// \param index Outputs the index of the communicator that the message was received by.
+    /// \param id OPTIONAL The ID of the message to read. Defaults to 0xFFFF, which will grab the next available message.
+    /// \return A pointer to the received message, or nullptr if none are available. The calling code takes ownership of the message pointer.
+    /// \details Communicators are visited in round robin order so that a busy port can not starve the others.
+    ///
+    message* receive(unsigned short& index, unsigned short id = 0xFFFF);
+
+    // PROPERTIES
+    ///
+    /// \brief p_communicator Gets a managed communicator.
+    /// \param index The index of the communicator.
+    /// \return A pointer to the communicator, or nullptr if the index is invalid. The manager retains ownership.
+    ///
+    communicator* p_communicator(unsigned short index);
+    ///
+    /// \brief p_size Gets the number of managed communicators.
+    /// \return The number of managed communicators.
+    ///
+    unsigned short p_size();
+    ///
+    /// \brief p_callback Sets a callback for dispatching received messages.
+    /// \param callback The callback, which is given the index of the receiving communicator and ownership of the message.
+    /// \details When a callback is set, the worker threads pass every received message to it directly after spinning,
+    /// and receive() will not return any messages.  The callback may be called from any worker thread.
+    /// \note The callback should be set before the manager is started.
+    ///
+    void p_callback(std::function<void(unsigned short, message*)> callback);
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_communicators Stores the managed communicators.
+    ///
+    std::vector<communicator*> m_communicators;
+    ///
+    /// \brief m_communicators_mutex Guards the communicator list.
+    ///
+    std::mutex m_communicators_mutex;
+    ///
+    /// \brief m_receive_index Stores the index of the next communicator to visit in receive().
+    ///
+    unsigned short m_receive_index;
+    ///
+    /// \brief m_callback Stores the callback for dispatching received messages.
+    ///
+    std::function<void(unsigned short, message*)> m_callback;
+
+    // THREADING
+    ///
+    /// \brief m_n_threads Stores the number of worker threads.
+    ///
+    unsigned int m_n_threads;
+    ///
+    /// \brief m_threads Stores the worker threads.
+    ///
+    std::vector<std::thread> m_threads;
+    ///
+    /// \brief m_epoll_fd The epoll instance that multiplexes all communicator file descriptors.
+    ///
+    int m_epoll_fd;
+    ///
+    /// \brief m_stop_fd An eventfd signalled to stop the worker threads.
+    ///
+    int m_stop_fd;
+
+    // METHODS
+    ///
+    /// \brief worker Services communicators from the epoll instance until stopped.
+    ///
+    void worker();
+};
+}
+
+#endif // MANAGER_H
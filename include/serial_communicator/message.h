@@ -3,12 +3,27 @@
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
+#include <string>
+
+///
+/// \brief The largest data length, in bytes, that a message stores inline rather than on the heap.
+/// \details This may be overridden at build time, but must be the same for the library and all code using it.
+///
+#ifndef SERIAL_COMMUNICATOR_INLINE_PAYLOAD
+#define SERIAL_COMMUNICATOR_INLINE_PAYLOAD 16
+#endif
+
 namespace serial_communicator {
 ///
 /// \brief Represents a message that can be sent or recieved through the Serial Communicator.
+/// \details Messages with data lengths up to SERIAL_COMMUNICATOR_INLINE_PAYLOAD store their data inline, so they
+/// can be created, copied, and moved without allocating.
 ///
 class message
 {
+    template <unsigned short ID, typename... FIELDS>
+    friend class message_schema;
+
 public:
     // CONSTRUCTORS
     ///
@@ -27,6 +42,21 @@ public:
     /// \param byte_array The byte array to copy and create the message from.
     ///
     message(const unsigned char* byte_array);
+    ///
+    /// \brief message Creates a message from a serialized byte array of known length, such as one read from a file.
+    /// \param byte_array The byte array to copy and create the message from.
+    /// \param length The length of the byte array in bytes.
+    /// \details Throws std::invalid_argument if the serialized message does not fit within the byte array.
+    ///
+    message(const unsigned char* byte_array, unsigned int length);
+    message(const message& other);
+    ///
+    /// \brief message Creates a message by taking the data of another message.
+    /// \param other The message to move from, which is left with no data fields.
+    ///
+    message(message&& other);
+    message& operator=(const message& other);
+    message& operator=(message&& other);
     ~message();
 
     // METHODS
@@ -44,6 +74,53 @@ public:
     /// \return The data read from the field.
     ///
     T get_field(unsigned short address) const;
+    template <typename T>
+    ///
+    /// \brief set_array Sets a contiguous array of data fields in the message.
+    /// \param address The address of the first field to write to.
+    /// \param data The array of values to write.
+    /// \param count The number of values in the array.
+    /// \details The whole array is converted to big endian in a single pass, which is much faster than setting
+    /// each element as a separate field.
+    ///
+    void set_array(unsigned short address, const T* data, unsigned short count);
+    template <typename T>
+    ///
+    /// \brief get_array Gets a contiguous array of data fields from the message.
+    /// \param address The address of the first field to read from.
+    /// \param data The pre-allocated array to read the values into.
+    /// \param count The number of values to read.
+    ///
+    void get_array(unsigned short address, T* data, unsigned short count) const;
+    ///
+    /// \brief set_string Sets a fixed length string field in the message.
+    /// \param address The address of the field to write to.
+    /// \param data The string to write.
+    /// \param length The length of the field in bytes.
+    /// \details Strings longer than the field are truncated, and shorter strings are padded with null bytes.
+    ///
+    void set_string(unsigned short address, const std::string& data, unsigned short length);
+    ///
+    /// \brief get_string Gets a fixed length string field from the message.
+    /// \param address The address of the field to read from.
+    /// \param length The length of the field in bytes.
+    /// \return The string read from the field, up to the first null byte.
+    ///
+    std::string get_string(unsigned short address, unsigned short length) const;
+    ///
+    /// \brief set_bytes Copies raw bytes into the message's data fields without conversion.
+    /// \param address The address to write to.
+    /// \param data The bytes to write, which should already be big endian.
+    /// \param length The number of bytes to write.
+    ///
+    void set_bytes(unsigned short address, const unsigned char* data, unsigned short length);
+    ///
+    /// \brief get_bytes Copies raw bytes out of the message's data fields without conversion.
+    /// \param address The address to read from.
+    /// \param data The pre-allocated buffer to copy the big endian bytes into.
+    /// \param length The number of bytes to read.
+    ///
+    void get_bytes(unsigned short address, unsigned char* data, unsigned short length) const;
     ///
     /// \brief serialize Serializes the message into the given byte array.
     /// \param byte_array The byte array to serialize the message into.
@@ -62,6 +139,22 @@ public:
     ///
     unsigned char p_priority() const;
     ///
+    /// \brief p_priority Sets the priority of the message.
+    /// \param value The priority of the message.  Messages with higher priorities are sent and received first.
+    ///
+    void p_priority(unsigned char value);
+    ///
+    /// \brief p_node Gets the bus node that the message is sent to, or was received from.
+    /// \return The node, or 0xFF for all nodes.
+    ///
+    unsigned char p_node() const;
+    ///
+    /// \brief p_node Sets the bus node that the message is sent to.
+    /// \param value The destination node, or 0xFF to broadcast to all nodes.  This only applies to communicators on
+    /// a multi-drop bus, and is not part of the serialized message.
+    ///
+    void p_node(unsigned char value);
+    ///
     /// \brief p_data_length Gets the data length of the message in bytes.
     /// \return The data length of the message in bytes.
     ///
@@ -71,6 +164,16 @@ public:
     /// \return The total length of the message in bytes.
     ///
     unsigned int p_message_length() const;
+    ///
+    /// \brief p_data Gets the message's data fields in place.
+    /// \return A pointer to the message's big endian data fields.
+    ///
+    unsigned char* p_data();
+    ///
+    /// \brief p_data Gets the message's data fields in place.
+    /// \return A pointer to the message's big endian data fields.
+    ///
+    const unsigned char* p_data() const;
 
 private:
     // VARIABLES
@@ -83,30 +186,42 @@ private:
     ///
     unsigned char m_priority;
     ///
+    /// \brief m_node The bus node that the message is sent to or was received from.
+    ///
+    unsigned char m_node;
+    ///
     /// \brief m_data_length The message's data length, in bytes.
     ///
     unsigned short m_data_length;
     ///
-    /// \brief m_data The message's data.
+    /// \brief m_data The message's data, which points to either m_inline or a heap allocation.
     ///
     unsigned char* m_data;
+    ///
+    /// \brief m_inline Stores the message's data if it is small enough.
+    ///
+    unsigned char m_inline[SERIAL_COMMUNICATOR_INLINE_PAYLOAD > 0 ? SERIAL_COMMUNICATOR_INLINE_PAYLOAD : 1];
 
     // METHODS
     ///
-    /// \brief set_field Sets a data field in the message.
-    /// \param address The address of the field to write to.
-    /// \param size The size of the data in bytes.
-    /// \param data A void pointer to the data to write.
+    /// \brief allocate Sets the data length and points the data at storage large enough to hold it.
+    /// \param data_length The size of the data fields in bytes.
     ///
-    void set_field(unsigned short address, unsigned int size, void* data);
+    void allocate(unsigned short data_length);
     ///
-    /// \brief get_field Gets a data field from the message.
-    /// \param address The address of the field to read from.
-    /// \param size The size of the data in bytes.
-    /// \param data A void pointer to the output variable to read the data into.
+    /// \brief deallocate Frees the message's data if it is stored on the heap.
     ///
-    void get_field(unsigned short address, unsigned int size, void* data) const;
+    void deallocate();
+    ///
+    /// \brief deserialize Reads the message's fields from a serialized byte array.
+    /// \param byte_array The byte array, which must hold the whole serialized message.
+    ///
+    void deserialize(const unsigned char* byte_array);
 };
 }
 
+#ifdef SERIAL_COMMUNICATOR_INLINE
+#include "inline/message.inl"
+#endif
+
 #endif // MESSAGE_H
@@ -0,0 +1,158 @@
+/// \file message_schema.h
+/// \brief Defines the serial_communicator::message_schema class.
+#ifndef MESSAGE_SCHEMA_H
+#define MESSAGE_SCHEMA_H
+
+#include "message.h"
+#include "message_view.h"
+#include "utility/byte_order.h"
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Computes the total size of a list of schema fields.
+///
+template <typename... FIELDS>
+struct schema_size;
+template <>
+struct schema_size<>
+{
+    static constexpr unsigned int value = 0;
+};
+template <typename FIRST, typename... REST>
+struct schema_size<FIRST, REST...>
+{
+    static constexpr unsigned int value = sizeof(FIRST) + schema_size<REST...>::value;
+};
+///
+/// \brief Locates a field within a list of schema fields.
+/// \details Fields are packed in declaration order starting from ADDRESS.
+///
+template <unsigned int INDEX, unsigned int ADDRESS, typename... FIELDS>
+struct schema_field;
+template <unsigned int ADDRESS, typename FIRST, typename... REST>
+struct schema_field<0, ADDRESS, FIRST, REST...>
+{
+    typedef FIRST type;
+    static constexpr unsigned short address = ADDRESS;
+};
+template <unsigned int INDEX, unsigned int ADDRESS, typename FIRST, typename... REST>
+struct schema_field<INDEX, ADDRESS, FIRST, REST...> : schema_field<INDEX - 1, ADDRESS + sizeof(FIRST), REST...>
+{
+};
+}
+
+///
+/// \brief Declares the layout of a message at compile time.
+/// \details A schema lists a message's field types in order.  Fields are packed back to back from address 0, so
+/// each field's address and the message's data length are computed at compile time rather than by hand, and
+/// fields are read and written by index with inlined byte swapping.  For example:
+///
+///     typedef message_schema<0x10, float, float, unsigned int> position;
+///     message* output = position::create();
+///     position::set<0>(*output, 1.5f);
+///     unsigned int counter = position::get<2>(*output);
+///
+/// get() also accepts a message_view, so received messages can be read in place.  Schemas access message storage
+/// directly so that each access inlines to a single load or store and byte swap.
+///
+template <unsigned short ID, typename... FIELDS>
+class message_schema
+{
+public:
+    // CONSTANTS
+    ///
+    /// \brief id The ID of the message.
+    ///
+    static constexpr unsigned short id = ID;
+    ///
+    /// \brief n_fields The number of fields in the message.
+    ///
+    static constexpr unsigned int n_fields = sizeof...(FIELDS);
+    ///
+    /// \brief data_length The data length of the message in bytes.
+    ///
+    static constexpr unsigned short data_length = utility::schema_size<FIELDS...>::value;
+    static_assert(utility::schema_size<FIELDS...>::value <= 0xFFFF, "message schema exceeds the maximum data length");
+
+    ///
+    /// \brief type The type of a field.
+    ///
+    template <unsigned int INDEX>
+    using type = typename utility::schema_field<INDEX, 0, FIELDS...>::type;
+    ///
+    /// \brief address Gets the address of a field.
+    /// \return The address of the field in bytes.
+    ///
+    template <unsigned int INDEX>
+    static constexpr unsigned short address()
+    {
+        return utility::schema_field<INDEX, 0, FIELDS...>::address;
+    }
+
+    // FACTORIES
+    ///
+    /// \brief create Creates a new message with this schema's ID and data length.
+    /// \return A pointer to the new message. The calling code takes ownership of the message pointer.
+    ///
+    static message* create()
+    {
+        return new message(id, data_length);
+    }
+
+    // METHODS
+    ///
+    /// \brief matches Checks if a message has this schema's ID and data length.
+    /// \param input The message or message_view to check.
+    /// \return TRUE if the message matches the schema, otherwise FALSE.
+    ///
+    template <typename MESSAGE>
+    static bool matches(const MESSAGE& input)
+    {
+        return input.p_id() == id && input.p_data_length() == data_length;
+    }
+    ///
+    /// \brief set Sets a field in a message.
+    /// \param output The message to write to, which must match the schema.
+    /// \param value The value to write to the field.
+    ///
+    template <unsigned int INDEX>
+    static void set(message& output, type<INDEX> value)
+    {
+        static_assert(INDEX < n_fields, "field index out of range");
+        utility::store_big_endian(output.m_data + address<INDEX>(), value);
+    }
+    ///
+    /// \brief get Gets a field from a message.
+    /// \param input The message to read from, which must match the schema.
+    /// \return The value of the field.
+    ///
+    template <unsigned int INDEX>
+    static type<INDEX> get(const message& input)
+    {
+        static_assert(INDEX < n_fields, "field index out of range");
+        return utility::load_big_endian<type<INDEX>>(input.m_data + address<INDEX>());
+    }
+    ///
+    /// \brief get Gets a field from a message view.
+    /// \param input The message view to read from, which must match the schema.
+    /// \return The value of the field.
+    ///
+    template <unsigned int INDEX>
+    static type<INDEX> get(const message_view& input)
+    {
+        static_assert(INDEX < n_fields, "field index out of range");
+        return utility::load_big_endian<type<INDEX>>(input.m_message + 5 + address<INDEX>());
+    }
+};
+
+// Out of line definitions for ODR use of the constants.
+template <unsigned short ID, typename... FIELDS>
+constexpr unsigned short message_schema<ID, FIELDS...>::id;
+template <unsigned short ID, typename... FIELDS>
+constexpr unsigned int message_schema<ID, FIELDS...>::n_fields;
+template <unsigned short ID, typename... FIELDS>
+constexpr unsigned short message_schema<ID, FIELDS...>::data_length;
+}
+
+#endif // MESSAGE_SCHEMA_H
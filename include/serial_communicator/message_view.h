@@ -0,0 +1,135 @@
+/// \file message_view.h
+/// \brief Defines the serial_communicator::message_view class.
+#ifndef MESSAGE_VIEW_H
+#define MESSAGE_VIEW_H
+
+#include "message.h"
+#include "utility/rx_buffer.h"
+
+#include <string>
+
+namespace serial_communicator {
+///
+/// \brief A read-only view of a received message that refers directly to the packet in the receive buffer.
+/// \details Views avoid copying the message out of the packet it arrived in.  Each view holds a reference to the
+/// underlying receive buffer, which is returned for reuse once every view of it has been released or destroyed.
+/// Copying a view shares the buffer rather than copying the message.
+///
+class message_view
+{
+    template <unsigned short ID, typename... FIELDS>
+    friend class message_schema;
+
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief message_view Creates an empty view that does not refer to any message.
+    ///
+    message_view();
+    ///
+    /// \brief message_view Creates a view of a message serialized within a receive buffer.
+    /// \param buffer The receive buffer holding the message.
+    /// \param offset The offset of the serialized message within the buffer.
+    /// \details The view adds its own reference to the buffer.
+    ///
+    message_view(utility::rx_buffer* buffer, unsigned int offset);
+    message_view(const message_view& other);
+    message_view& operator=(const message_view& other);
+    ~message_view();
+
+    // METHODS
+    template <typename T>
+    ///
+    /// \brief get_field Gets a data field from the message.
+    /// \param address The address of the field to read from.
+    /// \return The data read from the field.
+    ///
+    T get_field(unsigned short address) const;
+    template <typename T>
+    ///
+    /// \brief get_array Gets a contiguous array of data fields from the message.
+    /// \param address The address of the first field to read from.
+    /// \param data The pre-allocated array to read the values into.
+    /// \param count The number of values to read.
+    ///
+    void get_array(unsigned short address, T* data, unsigned short count) const;
+    ///
+    /// \brief get_string Gets a fixed length string field from the message.
+    /// \param address The address of the field to read from.
+    /// \param length The length of the field in bytes.
+    /// \return The string read from the field, up to the first null byte.
+    ///
+    std::string get_string(unsigned short address, unsigned short length) const;
+    ///
+    /// \brief get_bytes Copies raw bytes out of the message's data fields without conversion.
+    /// \param address The address to read from.
+    /// \param data The pre-allocated buffer to copy the big endian bytes into.
+    /// \param length The number of bytes to read.
+    ///
+    void get_bytes(unsigned short address, unsigned char* data, unsigned short length) const;
+    ///
+    /// \brief to_message Copies the viewed message into a new message.
+    /// \return A pointer to the new message. The calling code takes ownership of the message pointer.
+    ///
+    message* to_message() const;
+    ///
+    /// \brief release Releases the view's reference to the receive buffer, leaving the view empty.
+    ///
+    void release();
+
+    // PROPERTIES
+    ///
+    /// \brief p_valid Checks if the view refers to a message.
+    /// \return TRUE if the view refers to a message, otherwise FALSE.
+    ///
+    bool p_valid() const;
+    ///
+    /// \brief p_id Gets the ID of the message.
+    /// \return The ID of the message.
+    ///
+    unsigned short p_id() const;
+    ///
+    /// \brief p_priority Gets the priority of the message.
+    /// \return The priority of the message.
+    ///
+    unsigned char p_priority() const;
+    ///
+    /// \brief p_node Gets the bus node that the message was received from.
+    /// \return The source node, or 0xFF if the message was not received over a multi-drop bus.
+    ///
+    unsigned char p_node() const;
+    ///
+    /// \brief p_data_length Gets the data length of the message in bytes.
+    /// \return The data length of the message in bytes.
+    ///
+    unsigned short p_data_length() const;
+    ///
+    /// \brief p_message_length Gets the total length of the message in bytes.
+    /// \return The total length of the message in bytes.
+    ///
+    unsigned int p_message_length() const;
+    ///
+    /// \brief p_data Gets the message's data fields in place.
+    /// \return A pointer to the message's big endian data fields, valid until the view is released.
+    ///
+    const unsigned char* p_data() const;
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_buffer Stores the receive buffer holding the message.
+    ///
+    utility::rx_buffer* m_buffer;
+    ///
+    /// \brief m_message Stores a pointer to the serialized message within the receive buffer.
+    ///
+    const unsigned char* m_message;
+
+};
+}
+
+#ifdef SERIAL_COMMUNICATOR_INLINE
+#include "inline/message_view.inl"
+#endif
+
+#endif // MESSAGE_VIEW_H
@@ -0,0 +1,142 @@
+/// \file statistics.h
+/// \brief Defines the serial_communicator::statistics class.
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "utility/histogram.h"
+
+#include <atomic>
+
+namespace serial_communicator {
+///
+/// \brief Collects link and queue statistics of a communicator.
+/// \details All statistics are lock-free and may be read from any thread while the communicator is in use.
+///
+class statistics
+{
+public:
+    // ENUMERATIONS
+    ///
+    /// \brief Enumerates the counted statistics.
+    ///
+    enum class counter
+    {
+        BYTES_SENT = 0,         ///< The number of bytes written, including escapes.
+        BYTES_RECEIVED = 1,     ///< The number of bytes read, including escapes and discarded bytes.
+        PACKETS_SENT = 2,       ///< The number of packets written, including receipts and retransmissions.
+        PACKETS_RECEIVED = 3,   ///< The number of complete packets read, including receipts and corrupted packets.
+        ESCAPES_INSERTED = 4,   ///< The number of escape bytes inserted into written packets.
+        CHECKSUM_FAILURES = 5,  ///< The number of packets read with a mismatched checksum.
+        RETRANSMISSIONS = 6,    ///< The number of times a message was retransmitted.
+        NOT_RECEIVED = 7,       ///< The number of messages that were never verified as received.
+        RX_QUEUE_DROPS = 8,     ///< The number of received messages dropped because the receive queue was full.
+        SEND_REJECTIONS = 9,    ///< The number of send() calls rejected because the transmit queue was full.
+        DUPLICATES = 10,        ///< The number of duplicate messages discarded by a bonded communicator.
+        BAUD_CHANGES = 11,      ///< The number of times a link's baud rate was changed by negotiation.
+        FRAMING_ERRORS = 12,    ///< The number of partially read packets discarded because another packet's header cut them short.
+        PACKETS_FILTERED = 13,  ///< The number of packets on a multi-drop bus skipped because they were addressed to other nodes.
+        AUTHENTICATION_FAILURES = 14,   ///< The number of packets dropped because they were not sealed, or failed to open, while encrypting.
+        REPLAYS = 15,           ///< The number of authentic sealed packets dropped because they had been received before.
+        BYTES_CORRECTED = 16,   ///< The number of received bytes repaired by forward error correction.
+        CORRECTION_FAILURES = 17    ///< The number of packets discarded because they had too many errors to correct.
+    };
+    ///
+    /// \brief Enumerates the sampled statistics.
+    ///
+    enum class gauge
+    {
+        TX_QUEUE_DEPTH = 0,     ///< The number of messages in the transmit queue at the end of the last spin.
+        RX_QUEUE_DEPTH = 1      ///< The number of messages in the receive queue at the end of the last spin.
+    };
+    ///
+    /// \brief Enumerates the timed statistics, which are recorded in microseconds.
+    ///
+    enum class timing
+    {
+        TIME_IN_QUEUE = 0,      ///< The time from a message being queued until its first transmission.
+        TIME_TO_RECEIPT = 1,    ///< The time from a message's last transmission until its receipt arrived.
+        SPIN_DURATION = 2       ///< The duration of a spin.
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_n_counters The number of counters, which must follow the last counter.
+    ///
+    static const unsigned int m_n_counters = static_cast<unsigned int>(counter::CORRECTION_FAILURES) + 1;
+    ///
+    /// \brief m_n_gauges The number of gauges, which must follow the last gauge.
+    ///
+    static const unsigned int m_n_gauges = static_cast<unsigned int>(gauge::RX_QUEUE_DEPTH) + 1;
+    ///
+    /// \brief m_n_timings The number of timings, which must follow the last timing.
+    ///
+    static const unsigned int m_n_timings = static_cast<unsigned int>(timing::SPIN_DURATION) + 1;
+
+    // CONSTRUCTORS
+    ///
+    /// \brief statistics Creates a new statistics instance with all statistics cleared.
+    ///
+    statistics();
+
+    // METHODS
+    ///
+    /// \brief increment Increments a counter.
+    /// \param counter The counter to increment.
+    /// \param amount OPTIONAL The amount to increment by.
+    ///
+    void increment(counter counter, unsigned long long amount = 1);
+    ///
+    /// \brief sample Sets the value of a gauge.
+    /// \param gauge The gauge to set.
+    /// \param value The value to set.
+    ///
+    void sample(gauge gauge, unsigned long long value);
+    ///
+    /// \brief record Records a time.
+    /// \param timing The timing to record into.
+    /// \param microseconds The time to record, in microseconds.
+    ///
+    void record(timing timing, unsigned long long microseconds);
+    ///
+    /// \brief reset Clears all statistics.
+    ///
+    void reset();
+
+    // PROPERTIES
+    ///
+    /// \brief p_counter Gets the value of a counter.
+    /// \param counter The counter to get.
+    /// \return The value of the counter.
+    ///
+    unsigned long long p_counter(counter counter) const;
+    ///
+    /// \brief p_gauge Gets the value of a gauge.
+    /// \param gauge The gauge to get.
+    /// \return The value of the gauge.
+    ///
+    unsigned long long p_gauge(gauge gauge) const;
+    ///
+    /// \brief p_histogram Gets the histogram of a timing.
+    /// \param timing The timing to get.
+    /// \return The histogram of the timing, in microseconds.
+    ///
+    const utility::histogram& p_histogram(timing timing) const;
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_counters Stores the counters.
+    ///
+    std::atomic<unsigned long long> m_counters[m_n_counters];
+    ///
+    /// \brief m_gauges Stores the gauges.
+    ///
+    std::atomic<unsigned long long> m_gauges[m_n_gauges];
+    ///
+    /// \brief m_histograms Stores the timing histograms.
+    ///
+    utility::histogram m_histograms[m_n_timings];
+};
+}
+
+#endif // STATISTICS_H
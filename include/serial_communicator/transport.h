@@ -0,0 +1,98 @@
+/// \file transport.h
+/// \brief Defines the serial_communicator::transport class.
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <sys/uio.h>
+
+namespace serial_communicator {
+///
+/// \brief An abstract byte stream that a communicator sends and receives packets over.
+///
+class transport
+{
+public:
+    virtual ~transport() {}
+
+    // METHODS
+    ///
+    /// \brief read Reads bytes from the transport.
+    /// \param buffer The pre-allocated buffer to store read bytes in.
+    /// \param length The maximum number of bytes to read.
+    /// \return The number of bytes read, which is less than length if the transport's read timeout elapsed.
+    ///
+    virtual unsigned long read(unsigned char* buffer, unsigned long length) = 0;
+    ///
+    /// \brief write Writes bytes to the transport.
+    /// \param buffer The buffer of bytes to write.
+    /// \param length The number of bytes to write.
+    /// \return The number of bytes written.
+    ///
+    virtual unsigned long write(const unsigned char* buffer, unsigned long length) = 0;
+    ///
+    /// \brief write Writes several buffers to the transport, in order, as one contiguous stream of bytes.
+    /// \param vectors The buffers to write.
+    /// \param count The number of buffers to write.
+    /// \return The total number of bytes written.
+    /// \details By default each buffer is written in turn.  Transports that can gather buffers into a single
+    /// operation, such as writev(), override this.
+    ///
+    virtual unsigned long write(const iovec* vectors, unsigned int count)
+    {
+        unsigned long n_written = 0;
+        for(unsigned int i = 0; i < count; i++)
+        {
+            n_written += write(static_cast<const unsigned char*>(vectors[i].iov_base), vectors[i].iov_len);
+        }
+        return n_written;
+    }
+    ///
+    /// \brief available Gets the number of bytes that have arrived and can be read without blocking.
+    /// \return The number of bytes available.
+    ///
+    virtual unsigned long available() = 0;
+    ///
+    /// \brief set_baud Changes the baud rate of the transport.
+    /// \param baud The new baud rate.
+    /// \return TRUE if the baud rate was changed, or FALSE if the transport does not have a baud rate.
+    /// \details Bytes already written are transmitted at the old rate before the rate is changed.
+    ///
+    virtual bool set_baud(unsigned int baud)
+    {
+        (void)baud;
+        return false;
+    }
+
+    // PROPERTIES
+    ///
+    /// \brief p_file_descriptor Gets a file descriptor that can be polled for the transport's readability.
+    /// \return The file descriptor, or -1 if the transport can not be polled.
+    ///
+    virtual int p_file_descriptor() const = 0;
+    ///
+    /// \brief p_byte_time Gets the time taken to transmit one byte over the transport.
+    /// \return The byte time in nanoseconds, or 0 if the transport is not rate limited.
+    ///
+    virtual unsigned long p_byte_time() const = 0;
+    ///
+    /// \brief p_baud Gets the baud rate of the transport.
+    /// \return The baud rate, or 0 if the transport does not have a baud rate.
+    ///
+    virtual unsigned int p_baud() const
+    {
+        return 0;
+    }
+    ///
+    /// \brief p_closed Gets if the remote end of the transport has closed it, so that no more bytes can arrive.
+    /// \return TRUE if the transport has been closed, otherwise FALSE.
+    /// \details Updated by available().  Some transports, such as a pseudo-terminal whose other side is closed, can be
+    /// opened again by the remote end, and stop being closed once they are.
+    ///
+    virtual bool p_closed() const
+    {
+        return false;
+    }
+};
+}
+
+#endif // TRANSPORT_H
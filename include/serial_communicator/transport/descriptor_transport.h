@@ -0,0 +1,53 @@
+/// \file descriptor_transport.h
+/// \brief Defines the serial_communicator::descriptor_transport class.
+#ifndef DESCRIPTOR_TRANSPORT_H
+#define DESCRIPTOR_TRANSPORT_H
+
+#include "serial_communicator/transport.h"
+
+namespace serial_communicator {
+///
+/// \brief A transport over a stream file descriptor, such as a pseudo-terminal or socket.
+///
+class descriptor_transport : public transport
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief descriptor_transport Creates a new descriptor_transport instance.
+    /// \param fd The file descriptor to communicate over. The transport takes ownership of the descriptor.
+    ///
+    descriptor_transport(int fd);
+    ~descriptor_transport();
+
+    // METHODS
+    unsigned long read(unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const iovec* vectors, unsigned int count) override;
+    unsigned long available() override;
+
+    // PROPERTIES
+    int p_file_descriptor() const override;
+    unsigned long p_byte_time() const override;
+    bool p_closed() const override;
+
+protected:
+    // CONSTANTS
+    ///
+    /// \brief m_read_timeout The time a read waits for bytes to arrive, in milliseconds.
+    ///
+    const int m_read_timeout = 30;
+
+    // VARIABLES
+    ///
+    /// \brief m_fd The transport's file descriptor.
+    ///
+    int m_fd;
+    ///
+    /// \brief m_closed Stores if the descriptor was found at end of stream or hung up.
+    ///
+    bool m_closed;
+};
+}
+
+#endif // DESCRIPTOR_TRANSPORT_H
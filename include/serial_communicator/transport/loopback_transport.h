@@ -0,0 +1,96 @@
+/// \file loopback_transport.h
+/// \brief Defines the serial_communicator::loopback_transport class.
+#ifndef LOOPBACK_TRANSPORT_H
+#define LOOPBACK_TRANSPORT_H
+
+#include "serial_communicator/transport.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace serial_communicator {
+///
+/// \brief An in-memory transport connected to a peer loopback_transport within the same process.
+/// \details Loopback transports are not rate limited, which allows the protocol to be exercised and benchmarked
+/// far beyond the speed of a physical link.
+///
+class loopback_transport : public transport
+{
+public:
+    // FACTORIES
+    ///
+    /// \brief create_pair Creates two transports connected to each other.
+    /// \param first Outputs the first transport. The calling code takes ownership of the pointer.
+    /// \param second Outputs the second transport. The calling code takes ownership of the pointer.
+    ///
+    static void create_pair(loopback_transport*& first, loopback_transport*& second);
+
+    // METHODS
+    unsigned long read(unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const iovec* vectors, unsigned int count) override;
+    unsigned long available() override;
+
+    // PROPERTIES
+    int p_file_descriptor() const override;
+    unsigned long p_byte_time() const override;
+
+private:
+    ///
+    /// \brief A one way byte stream between two loopback transports.
+    ///
+    struct channel
+    {
+        channel();
+        ~channel();
+        ///
+        /// \brief mutex Guards the channel.
+        ///
+        std::mutex mutex;
+        ///
+        /// \brief condition Signalled when bytes are written to the channel.
+        ///
+        std::condition_variable condition;
+        ///
+        /// \brief buffer Stores the bytes written to the channel.
+        ///
+        std::vector<unsigned char> buffer;
+        ///
+        /// \brief read_position Stores the position of the next unread byte in the buffer.
+        ///
+        unsigned long read_position;
+        ///
+        /// \brief event_fd An eventfd that is readable while the channel has unread bytes.
+        ///
+        int event_fd;
+    };
+
+    // CONSTRUCTORS
+    ///
+    /// \brief loopback_transport Creates a new loopback_transport instance.
+    /// \param rx The channel to read from.
+    /// \param tx The channel to write to.
+    ///
+    loopback_transport(std::shared_ptr<channel> rx, std::shared_ptr<channel> tx);
+
+    // CONSTANTS
+    ///
+    /// \brief m_read_timeout The time a read waits for bytes to arrive, in milliseconds.
+    ///
+    const unsigned int m_read_timeout = 30;
+
+    // VARIABLES
+    ///
+    /// \brief m_rx The channel to read from.
+    ///
+    std::shared_ptr<channel> m_rx;
+    ///
+    /// \brief m_tx The channel to write to.
+    ///
+    std::shared_ptr<channel> m_tx;
+};
+}
+
+#endif // LOOPBACK_TRANSPORT_H
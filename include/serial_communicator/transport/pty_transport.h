@@ -0,0 +1,64 @@
+/// \file pty_transport.h
+/// \brief Defines the serial_communicator::pty_transport class.
+#ifndef PTY_TRANSPORT_H
+#define PTY_TRANSPORT_H
+
+#include "serial_communicator/transport/descriptor_transport.h"
+
+#include <string>
+
+namespace serial_communicator {
+///
+/// \brief A transport over a pseudo-terminal or other terminal device in raw mode.
+/// \details A communicator using the master side of a pseudo-terminal can talk to a communicator that opens the slave
+/// side, exercising the kernel's terminal layer without any hardware.
+///
+class pty_transport : public descriptor_transport
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief pty_transport Creates the master side of a new pseudo-terminal.
+    /// \details The slave side can be opened through p_slave_name().
+    ///
+    pty_transport();
+    ///
+    /// \brief pty_transport Opens an existing terminal device in raw mode.
+    /// \param device The path to the terminal device, such as the slave side of a pseudo-terminal.
+    ///
+    pty_transport(std::string device);
+
+    // PROPERTIES
+    ///
+    /// \brief p_slave_name Gets the path to the slave side of the pseudo-terminal.
+    /// \return The path to the slave device, or an empty string if this transport opened an existing device.
+    ///
+    std::string p_slave_name() const;
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_slave_name Stores the path to the slave side of the pseudo-terminal.
+    ///
+    std::string m_slave_name;
+
+    // METHODS
+    ///
+    /// \brief open_master Opens the master side of a new pseudo-terminal.
+    /// \return The master descriptor.
+    ///
+    static int open_master();
+    ///
+    /// \brief open_device Opens a terminal device.
+    /// \param device The path to the terminal device.
+    /// \return The device descriptor.
+    ///
+    static int open_device(std::string device);
+    ///
+    /// \brief make_raw Configures the transport's descriptor for raw, unprocessed bytes.
+    ///
+    void make_raw();
+};
+}
+
+#endif // PTY_TRANSPORT_H
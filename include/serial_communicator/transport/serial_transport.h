@@ -0,0 +1,63 @@
+/// \file serial_transport.h
+/// \brief Defines the serial_communicator::serial_transport class.
+#ifndef SERIAL_TRANSPORT_H
+#define SERIAL_TRANSPORT_H
+
+#include "serial_communicator/transport.h"
+
+#include <serial/serial.h>
+
+#include <string>
+
+namespace serial_communicator {
+///
+/// \brief A transport over a serial port.
+///
+class serial_transport : public transport
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief serial_transport Creates a new serial_transport instance.
+    /// \param port The serial port to communicate over.
+    /// \param baud The baud rate of the serial connection.
+    /// \param data_bits The number of data bits per byte.
+    /// \param parity_bits The parity setting of the serial connection.
+    /// \param stop_bits The number of stop bits per byte.
+    ///
+    serial_transport(std::string port, unsigned int baud, unsigned int data_bits = 8, unsigned int parity_bits = 0, unsigned int stop_bits = 1);
+    ~serial_transport();
+
+    // METHODS
+    unsigned long read(unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const unsigned char* buffer, unsigned long length) override;
+    unsigned long available() override;
+    bool set_baud(unsigned int baud) override;
+
+    // PROPERTIES
+    int p_file_descriptor() const override;
+    unsigned long p_byte_time() const override;
+    unsigned int p_baud() const override;
+
+private:
+    // VARIABLES
+    ///
+    /// \brief m_serial_port The transport's serial port.
+    ///
+    serial::Serial* m_serial_port;
+    ///
+    /// \brief m_poll_fd A descriptor to the serial device used only to poll for readability.
+    ///
+    int m_poll_fd;
+    ///
+    /// \brief m_bits_per_byte Stores the number of bits transmitted per byte, including framing.
+    ///
+    unsigned int m_bits_per_byte;
+    ///
+    /// \brief m_byte_time Stores the time taken to transmit one byte, in nanoseconds.
+    ///
+    unsigned long m_byte_time;
+};
+}
+
+#endif // SERIAL_TRANSPORT_H
@@ -0,0 +1,201 @@
+/// \file shm_transport.h
+/// \brief Defines the serial_communicator::shm_transport class.
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include "serial_communicator/transport.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace serial_communicator {
+///
+/// \brief A transport over a POSIX shared memory segment, connecting communicators in two processes on one host.
+/// \details The segment holds a ring buffer for each direction.  Bytes are written straight into the peer's ring
+/// and read straight out of it, so the data path makes no system calls.  Each side also binds a datagram socket
+/// as a doorbell that makes it pollable.  The doorbell is only rung when a ring goes from empty to holding bytes,
+/// so a busy stream costs no more than one system call per burst.
+///
+/// One process creates the segment by name and another attaches to it.  The packet format is the same as over any
+/// other transport, so a gateway process that owns a serial link can serve a local process over a shared memory
+/// transport with the same communicator semantics.
+///
+class shm_transport : public transport
+{
+public:
+    // FACTORIES
+    ///
+    /// \brief create Creates a named shared memory segment and a transport for its creating side.
+    /// \param name The name of the segment, which must be unique on the host and up to 64 characters without slashes.
+    /// \param capacity OPTIONAL The size of each ring in bytes, which is rounded up to a power of two.
+    /// \return The transport. The calling code takes ownership of the pointer.  The name is removed when the
+    /// transport is destroyed.
+    /// \details A segment left behind by a creating process that has exited is replaced.
+    ///
+    static shm_transport* create(std::string name, unsigned long capacity = 65536);
+    ///
+    /// \brief attach Attaches to a shared memory segment created by another process.
+    /// \param name The name of the segment.
+    /// \return The transport. The calling code takes ownership of the pointer.
+    ///
+    static shm_transport* attach(std::string name);
+    ~shm_transport();
+
+    // METHODS
+    unsigned long read(unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const unsigned char* buffer, unsigned long length) override;
+    unsigned long write(const iovec* vectors, unsigned int count) override;
+    unsigned long available() override;
+
+    // PROPERTIES
+    int p_file_descriptor() const override;
+    unsigned long p_byte_time() const override;
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief The positions of a ring buffer, each on its own cache line.
+    /// \details Positions count bytes since the segment was created and are only reduced to offsets into the ring
+    /// when accessing it, so a full ring is distinguished from an empty one.
+    ///
+    struct ring
+    {
+        ///
+        /// \brief head The number of bytes written to the ring.
+        ///
+        alignas(64) std::atomic<unsigned long long> head;
+        ///
+        /// \brief tail The number of bytes read from the ring.
+        ///
+        alignas(64) std::atomic<unsigned long long> tail;
+    };
+    ///
+    /// \brief The header at the start of the shared memory segment, followed by the bytes of both rings.
+    ///
+    struct segment
+    {
+        ///
+        /// \brief magic Identifies a segment created by a shm_transport, once it is initialized.
+        ///
+        std::atomic<unsigned int> magic;
+        ///
+        /// \brief capacity The size of each ring in bytes.
+        ///
+        unsigned int capacity;
+        ///
+        /// \brief rings The ring written by the creating side, and the ring written by the attaching side.
+        ///
+        ring rings[2];
+    };
+
+    // CONSTRUCTORS
+    ///
+    /// \brief shm_transport Creates a new shm_transport instance over a mapped segment.
+    /// \param path The path of the segment.
+    /// \param map The mapped segment.
+    /// \param map_size The size of the mapping in bytes.
+    /// \param side The side of the segment, 0 for the creating side and 1 for the attaching side.
+    /// \param doorbell_fd The bound doorbell socket of the side.
+    ///
+    shm_transport(std::string path, void* map, unsigned long map_size, unsigned int side, int doorbell_fd);
+
+    // CONSTANTS
+    ///
+    /// \brief m_magic Identifies a segment created by a shm_transport.
+    ///
+    static const unsigned int m_magic = 0x53434D31;
+    ///
+    /// \brief m_max_name_length The longest segment name, which keeps the doorbell addresses within bounds.
+    ///
+    static const unsigned int m_max_name_length = 64;
+    ///
+    /// \brief m_read_timeout The time a read waits for bytes to arrive, in milliseconds.
+    ///
+    const int m_read_timeout = 30;
+    ///
+    /// \brief m_write_timeout The time a write waits for room in a full ring before giving up, in milliseconds.
+    ///
+    const int m_write_timeout = 100;
+
+    // VARIABLES
+    ///
+    /// \brief m_path Stores the path of the segment, which is its name with a leading slash.
+    ///
+    std::string m_path;
+    ///
+    /// \brief m_map Stores the mapped segment.
+    ///
+    segment* m_map;
+    ///
+    /// \brief m_map_size Stores the size of the mapping in bytes.
+    ///
+    unsigned long m_map_size;
+    ///
+    /// \brief m_side Stores the side of the segment this transport is on.
+    ///
+    unsigned int m_side;
+    ///
+    /// \brief m_rx Stores the ring this transport reads from.
+    ///
+    ring* m_rx;
+    ///
+    /// \brief m_tx Stores the ring this transport writes to.
+    ///
+    ring* m_tx;
+    ///
+    /// \brief m_rx_data Stores the bytes of the ring this transport reads from.
+    ///
+    unsigned char* m_rx_data;
+    ///
+    /// \brief m_tx_data Stores the bytes of the ring this transport writes to.
+    ///
+    unsigned char* m_tx_data;
+    ///
+    /// \brief m_mask Stores the mask that reduces a position to an offset into a ring.
+    ///
+    unsigned long long m_mask;
+    ///
+    /// \brief m_doorbell_fd Stores the datagram socket that is readable while this side has been signalled.
+    ///
+    int m_doorbell_fd;
+
+    // METHODS
+    ///
+    /// \brief doorbell_address Gets the abstract socket address of a side's doorbell.
+    /// \param path The path of the segment.
+    /// \param side The side of the segment.
+    /// \param address Outputs the address.
+    /// \return The length of the address.
+    ///
+    static socklen_t doorbell_address(const std::string& path, unsigned int side, sockaddr_un& address);
+    ///
+    /// \brief bind_doorbell Creates and binds a side's doorbell.
+    /// \param path The path of the segment.
+    /// \param side The side of the segment.
+    /// \return The doorbell socket, or -1 if the side is held by another transport.
+    /// \details Abstract socket addresses are released when their process exits, so a bound doorbell shows that a
+    /// side is held by a live process.
+    ///
+    static int bind_doorbell(const std::string& path, unsigned int side);
+    ///
+    /// \brief ring_doorbell Signals a side's doorbell.
+    /// \param side The side of the segment.
+    ///
+    void ring_doorbell(unsigned int side);
+    ///
+    /// \brief append Copies bytes into the ring this transport writes to, waiting for room while it is full.
+    /// \param buffer The bytes to copy.
+    /// \param length The number of bytes to copy.
+    /// \param deadline The time after which waiting for room gives up.
+    /// \return The number of bytes copied.
+    /// \details Bytes are made visible to the peer as they are copied, and the peer's doorbell is rung if it had
+    /// read everything before them.
+    ///
+    unsigned long append(const unsigned char* buffer, unsigned long length, std::chrono::steady_clock::time_point deadline);
+};
+}
+
+#endif // SHM_TRANSPORT_H
@@ -0,0 +1,47 @@
+/// \file socket_transport.h
+/// \brief Defines the serial_communicator::socket_transport class.
+#ifndef SOCKET_TRANSPORT_H
+#define SOCKET_TRANSPORT_H
+
+#include "serial_communicator/transport/descriptor_transport.h"
+
+#include <string>
+
+namespace serial_communicator {
+///
+/// \brief A transport over a stream socket, such as a UNIX socket pair or a TCP connection.
+///
+class socket_transport : public descriptor_transport
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief socket_transport Creates a new socket_transport instance from a connected stream socket.
+    /// \param fd The connected socket. The transport takes ownership of the descriptor.
+    ///
+    socket_transport(int fd);
+
+    // FACTORIES
+    ///
+    /// \brief create_pair Creates two transports connected to each other through a UNIX socket pair.
+    /// \param first Outputs the first transport. The calling code takes ownership of the pointer.
+    /// \param second Outputs the second transport. The calling code takes ownership of the pointer.
+    ///
+    static void create_pair(socket_transport*& first, socket_transport*& second);
+    ///
+    /// \brief connect Creates a transport by connecting to a TCP server.
+    /// \param host The host name or address of the server.
+    /// \param port The TCP port of the server.
+    /// \return The connected transport. The calling code takes ownership of the pointer.
+    ///
+    static socket_transport* connect(std::string host, unsigned short port);
+    ///
+    /// \brief accept Creates a transport by listening for and accepting a single TCP connection.
+    /// \param port The TCP port to listen on.
+    /// \return The connected transport. The calling code takes ownership of the pointer.
+    ///
+    static socket_transport* accept(unsigned short port);
+};
+}
+
+#endif // SOCKET_TRANSPORT_H
@@ -0,0 +1,38 @@
+/// \file bounds.h
+/// \brief Defines the optional bounds checks of message field accessors.
+/// \details Field accessors trust the caller's addresses, since checking them costs time on the hot path.  When
+/// built with SERIAL_COMMUNICATOR_BOUNDS_CHECKS, accesses past the end of a message's data throw instead, which is
+/// how the fuzzers and sanitized test builds run.  The library and all code using it must agree on the setting.
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#ifdef SERIAL_COMMUNICATOR_BOUNDS_CHECKS
+#include <stdexcept>
+#endif
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief check_bounds Checks that a field lies within a message's data.
+/// \param address The address of the field.
+/// \param length The length of the field in bytes.
+/// \param data_length The data length of the message in bytes.
+/// \details Throws std::out_of_range if the field does not fit, and does nothing unless built with
+/// SERIAL_COMMUNICATOR_BOUNDS_CHECKS.
+///
+inline void check_bounds(unsigned long address, unsigned long length, unsigned long data_length)
+{
+#ifdef SERIAL_COMMUNICATOR_BOUNDS_CHECKS
+    if(address > data_length || length > data_length - address)
+    {
+        throw std::out_of_range("message field lies outside of the message data");
+    }
+#else
+    (void)address;
+    (void)length;
+    (void)data_length;
+#endif
+}
+}}
+
+#endif // BOUNDS_H
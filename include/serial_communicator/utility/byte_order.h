@@ -0,0 +1,91 @@
+/// \file byte_order.h
+/// \brief Defines inline conversions between host values and big endian bytes.
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <endian.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Converts unsigned integers of a given size between host and big endian byte order.
+///
+template <unsigned int SIZE>
+struct byte_order;
+template <>
+struct byte_order<1>
+{
+    typedef std::uint8_t type;
+    static type to_big_endian(type value) { return value; }
+    static type from_big_endian(type value) { return value; }
+};
+template <>
+struct byte_order<2>
+{
+    typedef std::uint16_t type;
+    static type to_big_endian(type value) { return htobe16(value); }
+    static type from_big_endian(type value) { return be16toh(value); }
+};
+template <>
+struct byte_order<4>
+{
+    typedef std::uint32_t type;
+    static type to_big_endian(type value) { return htobe32(value); }
+    static type from_big_endian(type value) { return be32toh(value); }
+};
+template <>
+struct byte_order<8>
+{
+    typedef std::uint64_t type;
+    static type to_big_endian(type value) { return htobe64(value); }
+    static type from_big_endian(type value) { return be64toh(value); }
+};
+
+///
+/// \brief load_big_endian Reads a value from big endian bytes.
+/// \param bytes The bytes to read from, which need not be aligned.
+/// \return The value in host byte order.
+///
+template <typename T>
+inline T load_big_endian(const unsigned char* bytes)
+{
+    static_assert(std::is_arithmetic<T>::value, "fields must be arithmetic types");
+    typename byte_order<sizeof(T)>::type raw;
+    std::memcpy(&raw, bytes, sizeof(T));
+    raw = byte_order<sizeof(T)>::from_big_endian(raw);
+    T output;
+    std::memcpy(&output, &raw, sizeof(T));
+    return output;
+}
+///
+/// \brief store_big_endian Writes a value as big endian bytes.
+/// \param bytes The bytes to write to, which need not be aligned.
+/// \param value The value to write, in host byte order.
+///
+template <typename T>
+inline void store_big_endian(unsigned char* bytes, T value)
+{
+    static_assert(std::is_arithmetic<T>::value, "fields must be arithmetic types");
+    typename byte_order<sizeof(T)>::type raw;
+    std::memcpy(&raw, &value, sizeof(T));
+    raw = byte_order<sizeof(T)>::to_big_endian(raw);
+    std::memcpy(bytes, &raw, sizeof(T));
+}
+
+///
+/// \brief convert_big_endian Converts a block of values between host and big endian byte order.
+/// \param output The buffer to write the converted values to.  This may be the same as the input.
+/// \param input The buffer of values to convert, which need not be aligned.
+/// \param size The size of each value in bytes, which must be 1, 2, 4, or 8.
+/// \param count The number of values to convert.
+/// \details The conversion is symmetric, so the same call converts in either direction.  Blocks are swapped with
+/// vector instructions where the processor supports them.
+///
+void convert_big_endian(unsigned char* output, const unsigned char* input, unsigned int size, unsigned long count);
+
+}}
+
+#endif // BYTE_ORDER_H
@@ -0,0 +1,135 @@
+/// \file capture.h
+/// \brief Defines the serial_communicator::utility::capture class.
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <string>
+#include <vector>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Captures packets to a memory-mapped ring file.
+/// \details Each captured packet is stored unescaped, with its direction, the index of the link it crossed, and a
+/// monotonic timestamp.  Recording is a copy into the mapped file with no system calls, so it does not block the I/O
+/// path.  When the file is full, the oldest packets are overwritten.
+///
+class capture
+{
+public:
+    // ENUMERATIONS
+    ///
+    /// \brief Enumerates the directions of a captured packet.
+    ///
+    enum class direction
+    {
+        TX = 0,     ///< The packet was transmitted.
+        RX = 1      ///< The packet was received.
+    };
+
+    // STRUCTURES
+    ///
+    /// \brief A packet loaded from a capture file.
+    ///
+    struct frame
+    {
+        unsigned long long timestamp;       ///< The monotonic time the packet was captured, in nanoseconds.
+        capture::direction direction;       ///< The direction of the packet.
+        unsigned char link;                 ///< The index of the link the packet crossed.
+        std::vector<unsigned char> bytes;   ///< The unescaped packet bytes.
+    };
+
+    // CONSTRUCTORS
+    ///
+    /// \brief capture Creates a new capture file, replacing any existing file.
+    /// \param path The path of the capture file.
+    /// \param size The size of the capture file's ring, in bytes.
+    ///
+    capture(std::string path, unsigned long size);
+    ~capture();
+
+    // METHODS
+    ///
+    /// \brief record Records a packet into the capture file.
+    /// \param direction The direction of the packet.
+    /// \param link The index of the link the packet crossed.
+    /// \param packet The unescaped packet bytes.
+    /// \param length The length of the packet.
+    /// \note Must only be called by one thread at a time.
+    ///
+    void record(direction direction, unsigned char link, const unsigned char* packet, unsigned int length);
+    ///
+    /// \brief load Loads all packets from a capture file, oldest first.
+    /// \param path The path of the capture file.
+    /// \param frames Outputs the loaded packets.
+    /// \return TRUE if the file was loaded, otherwise FALSE.  A corrupted or truncated file returns FALSE, with the packets
+    /// before the corruption still output.
+    ///
+    static bool load(std::string path, std::vector<frame>& frames);
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief The header at the start of a capture file.
+    ///
+    struct file_header
+    {
+        char magic[8];                      ///< Identifies the file as a capture file.
+        unsigned long long capacity;        ///< The size of the ring following the header, in bytes.
+        unsigned long long head;            ///< The offset of the oldest record in the ring.
+        unsigned long long used;            ///< The number of bytes in use in the ring.
+    };
+    ///
+    /// \brief The header preceding each packet in the ring.
+    ///
+    struct record_header
+    {
+        unsigned int length;                ///< The length of the packet, or m_wrap_marker if the ring wraps here.
+        unsigned char direction;            ///< The direction of the packet.
+        unsigned char link;                 ///< The index of the link the packet crossed.
+        unsigned short reserved;            ///< Reserved for alignment.
+        unsigned long long timestamp;       ///< The monotonic time the packet was captured, in nanoseconds.
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_wrap_marker Marks that the rest of the ring is unused and records continue at its start.
+    ///
+    static const unsigned int m_wrap_marker = 0xFFFFFFFF;
+
+    // VARIABLES
+    ///
+    /// \brief m_fd The capture file's descriptor.
+    ///
+    int m_fd;
+    ///
+    /// \brief m_map_size The size of the mapping, in bytes.
+    ///
+    unsigned long m_map_size;
+    ///
+    /// \brief m_header The file header within the mapping.
+    ///
+    file_header* m_header;
+    ///
+    /// \brief m_ring The ring within the mapping.
+    ///
+    unsigned char* m_ring;
+
+    // METHODS
+    ///
+    /// \brief make_room Drops the oldest records until the ring has enough free space.
+    /// \param length The number of free bytes required.
+    ///
+    void make_room(unsigned long long length);
+    ///
+    /// \brief record_size Gets the ring space taken by the record at an offset.
+    /// \param ring The ring.
+    /// \param capacity The size of the ring.
+    /// \param offset The offset of the record.
+    /// \return The number of bytes the record takes, including padding or the skipped end of the ring.
+    ///
+    static unsigned long long record_size(const unsigned char* ring, unsigned long long capacity, unsigned long long offset);
+};
+}}
+
+#endif // CAPTURE_H
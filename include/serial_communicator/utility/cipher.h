@@ -0,0 +1,129 @@
+/// \file cipher.h
+/// \brief Defines the serial_communicator::utility::cipher class.
+#ifndef CIPHER_H
+#define CIPHER_H
+
+#include "serial_communicator/encryption.h"
+
+#include <vector>
+#include <sys/uio.h>
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Seals and opens packets with authenticated encryption under a pre-shared key.
+/// \details Each sealed packet is given a unique 12 byte nonce, made of a salt chosen for this cipher and a counter
+/// that starts at the wall clock time in microseconds and counts every packet sealed.  Every peer sharing the key
+/// counts through nearly the same range, so their nonces are kept apart by the salt alone.  The salt is therefore
+/// drawn from OpenSSL's cryptographically secure generator rather than a process-seeded one, which would give
+/// processes started together the same salt.  Within one cipher the counter never repeats, and across restarts it
+/// resumes from the later wall clock time.  Opened packets are checked against a window of the counters recently
+/// received from each node, which rejects replayed packets.
+///
+class cipher
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief cipher Creates a new cipher instance.
+    /// \param algorithm The authenticated encryption algorithm.
+    /// \param key The pre-shared key, which must be 32 bytes.
+    /// \details Throws std::invalid_argument if the key is the wrong length, or std::runtime_error if the cipher or
+    /// its salt can not be set up.
+    ///
+    cipher(serial_communicator::encryption algorithm, const std::vector<unsigned char>& key);
+    ~cipher();
+
+    // CONSTANTS
+    ///
+    /// \brief m_key_length The length of a key in bytes.
+    ///
+    static const unsigned int m_key_length = 32;
+    ///
+    /// \brief m_nonce_length The length of a nonce in bytes.
+    ///
+    static const unsigned int m_nonce_length = 12;
+    ///
+    /// \brief m_tag_length The length of an authentication tag in bytes.
+    ///
+    static const unsigned int m_tag_length = 16;
+
+    // METHODS
+    ///
+    /// \brief seal Encrypts and authenticates a packet.
+    /// \param aad The bytes to authenticate without encrypting.
+    /// \param aad_length The number of bytes to authenticate without encrypting.
+    /// \param segments The segments of bytes to encrypt, in order.
+    /// \param n_segments The number of segments.
+    /// \param ciphertext Outputs the encrypted bytes, which has room for all bytes of the segments.
+    /// \param nonce Outputs the nonce that the packet was sealed with.
+    /// \param tag Outputs the authentication tag.
+    ///
+    void seal(const unsigned char* aad, unsigned int aad_length, const iovec* segments, unsigned int n_segments, unsigned char* ciphertext, unsigned char* nonce, unsigned char* tag);
+    ///
+    /// \brief open Authenticates and decrypts a packet in place.
+    /// \param aad The bytes that were authenticated without being encrypted.
+    /// \param aad_length The number of bytes that were authenticated without being encrypted.
+    /// \param data The encrypted bytes, which are replaced with the decrypted bytes.
+    /// \param length The number of encrypted bytes.
+    /// \param nonce The nonce that the packet was sealed with.
+    /// \param tag The authentication tag.
+    /// \return TRUE if the packet is authentic, otherwise FALSE and the bytes must not be used.
+    ///
+    bool open(const unsigned char* aad, unsigned int aad_length, unsigned char* data, unsigned int length, const unsigned char* nonce, const unsigned char* tag);
+    ///
+    /// \brief accept Checks that an authentic packet has not been received before, and records it.
+    /// \param source The node that the packet was sent from, or 0xFF for a single peer.
+    /// \param nonce The nonce that the packet was sealed with.
+    /// \return TRUE if the packet is new, or FALSE if it is a replay or too old to tell.
+    ///
+    bool accept(unsigned char source, const unsigned char* nonce);
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief The counters recently received from a node.
+    ///
+    struct window
+    {
+        ///
+        /// \brief valid Indicates that a packet has been received from the node.
+        ///
+        bool valid;
+        ///
+        /// \brief highest The highest counter received.
+        ///
+        unsigned long long highest;
+        ///
+        /// \brief received The counters received below and including the highest, one bit each.
+        ///
+        unsigned long long received;
+    };
+
+    // VARIABLES
+    ///
+    /// \brief m_encrypt Stores the context that seals packets.
+    ///
+    EVP_CIPHER_CTX* m_encrypt;
+    ///
+    /// \brief m_decrypt Stores the context that opens packets.
+    ///
+    EVP_CIPHER_CTX* m_decrypt;
+    ///
+    /// \brief m_salt Stores the secure random leading bytes of this cipher's nonces.
+    ///
+    unsigned int m_salt;
+    ///
+    /// \brief m_counter Stores the counter of the next nonce.
+    ///
+    unsigned long long m_counter;
+    ///
+    /// \brief m_windows Stores the counters recently received from each node.
+    ///
+    window m_windows[256];
+};
+}}
+
+#endif // CIPHER_H
@@ -0,0 +1,151 @@
+/// \file clock_sync.h
+/// \brief Defines the serial_communicator::utility::clock_sync class.
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <chrono>
+#include <vector>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Estimates the offset and drift of a remote communicator's clock from receipt round trips.
+/// \details Each round trip gives the local transmit and arrival times of a message and its receipt, and the remote
+/// arrival and transmit times carried in the receipt.  As in NTP, these give the offset between the clocks and the
+/// round trip delay.  Samples whose delay is close to the shortest seen are the least disturbed by queueing, and a
+/// line is fit through their offsets to track drift between the clocks.
+///
+/// Remote times are microseconds of a monotonic clock with an arbitrary epoch.
+///
+class clock_sync
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief clock_sync Creates a new, unsynchronized clock_sync instance.
+    ///
+    clock_sync();
+
+    // METHODS
+    ///
+    /// \brief add_sample Adds a round trip sample.
+    /// \param transmitted The local time at which the message was transmitted.
+    /// \param remote_received The remote time at which the message arrived.
+    /// \param remote_transmitted The remote time at which the receipt was transmitted.
+    /// \param received The local time at which the receipt arrived.
+    ///
+    void add_sample(std::chrono::steady_clock::time_point transmitted, long long remote_received, long long remote_transmitted, std::chrono::steady_clock::time_point received);
+    ///
+    /// \brief to_local Converts a remote time to the local clock.
+    /// \param remote The remote time.
+    /// \return The equivalent local time.  The remote time is taken to be local if no samples have been added.
+    ///
+    std::chrono::steady_clock::time_point to_local(long long remote) const;
+    ///
+    /// \brief to_remote Converts a local time to the remote time format.
+    /// \param local The local time.
+    /// \return The local time in microseconds, which is how it is sent to the remote communicator.
+    ///
+    static long long to_remote(std::chrono::steady_clock::time_point local);
+
+    // PROPERTIES
+    ///
+    /// \brief p_synchronized Gets if any samples have been added.
+    /// \return TRUE if the remote clock can be converted, otherwise FALSE.
+    ///
+    bool p_synchronized() const;
+    ///
+    /// \brief p_offset Gets the estimated offset of the remote clock at the time of the latest sample.
+    /// \return The remote time minus the local time, in microseconds.
+    ///
+    long long p_offset() const;
+    ///
+    /// \brief p_drift Gets the estimated drift of the remote clock.
+    /// \return The rate at which the offset grows, in parts per million.
+    ///
+    double p_drift() const;
+    ///
+    /// \brief p_delay Gets the shortest round trip delay of the retained samples.
+    /// \return The delay in microseconds, excluding the time the remote communicator held the message.
+    ///
+    long long p_delay() const;
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief A single round trip sample.
+    ///
+    struct sample
+    {
+        ///
+        /// \brief local The local time at the middle of the round trip, in microseconds.
+        ///
+        long long local;
+        ///
+        /// \brief offset The remote time minus the local time, in microseconds.
+        ///
+        long long offset;
+        ///
+        /// \brief delay The round trip delay, in microseconds.
+        ///
+        long long delay;
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_max_samples The number of most recent samples that are retained.
+    ///
+    const unsigned int m_max_samples = 32;
+    ///
+    /// \brief m_delay_margin The extra delay, in microseconds, beyond twice the shortest delay that a sample may have
+    /// and still be used.
+    ///
+    const long long m_delay_margin = 200;
+    ///
+    /// \brief m_min_fit_span The shortest time spanned by the used samples before drift is fit, in microseconds.
+    ///
+    const long long m_min_fit_span = 5000000;
+    ///
+    /// \brief m_max_drift The largest drift that is believed, as a fraction.
+    ///
+    const double m_max_drift = 0.0005;
+
+    // VARIABLES
+    ///
+    /// \brief m_samples Stores the most recent samples.
+    ///
+    std::vector<sample> m_samples;
+    ///
+    /// \brief m_position Stores the position of the oldest sample once the samples are full.
+    ///
+    unsigned int m_position;
+    ///
+    /// \brief m_reference Stores the local time that the offset is fit about, in microseconds.
+    ///
+    long long m_reference;
+    ///
+    /// \brief m_offset Stores the fit offset at the reference time, in microseconds.
+    ///
+    double m_offset;
+    ///
+    /// \brief m_drift Stores the fit drift as a fraction.
+    ///
+    double m_drift;
+    ///
+    /// \brief m_delay Stores the shortest delay of the retained samples, in microseconds.
+    ///
+    long long m_delay;
+    ///
+    /// \brief m_latest Stores the local time of the latest sample, in microseconds.
+    ///
+    long long m_latest;
+
+    // METHODS
+    ///
+    /// \brief fit Fits the offset and drift to the retained samples.
+    ///
+    void fit();
+};
+}}
+
+#endif // CLOCK_SYNC_H
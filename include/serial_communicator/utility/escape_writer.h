@@ -0,0 +1,128 @@
+/// \file escape_writer.h
+/// \brief Defines the serial_communicator::utility::escape_writer class.
+#ifndef ESCAPE_WRITER_H
+#define ESCAPE_WRITER_H
+
+#include "serial_communicator/utility/link.h"
+
+#include <sys/uio.h>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Escapes a packet into a link as it is appended, without first copying the packet into one buffer.
+/// \details Long runs of bytes that need no escaping are written directly from the caller's memory.  Short runs
+/// and escape sequences are copied into a small staging area.  Both are gathered into vectored writes, so a large
+/// payload is written with a few writes and without being copied.  Appended memory must remain valid until flush().
+///
+class escape_writer
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief escape_writer Creates a new escape_writer instance.
+    /// \param link The link to write to.
+    /// \param header_byte The header byte, which must be escaped everywhere but the start of the packet.
+    /// \param escape_byte The escape byte.
+    ///
+    escape_writer(utility::link* link, unsigned char header_byte, unsigned char escape_byte);
+
+    // METHODS
+    ///
+    /// \brief append_header Appends the packet's header byte, which is not escaped.
+    ///
+    void append_header();
+    ///
+    /// \brief append Appends packet bytes, escaping them as needed.
+    /// \param data The unescaped bytes to append.
+    /// \param length The number of bytes to append.
+    ///
+    void append(const unsigned char* data, unsigned int length);
+    ///
+    /// \brief flush Writes all appended bytes to the link.
+    ///
+    void flush();
+
+    // PROPERTIES
+    ///
+    /// \brief p_n_bytes Gets the number of escaped bytes written so far.
+    /// \return The number of escaped bytes.
+    ///
+    unsigned long p_n_bytes() const;
+    ///
+    /// \brief p_n_escapes Gets the number of escapes inserted so far.
+    /// \return The number of escapes inserted.
+    ///
+    unsigned long p_n_escapes() const;
+
+private:
+    // CONSTANTS
+    ///
+    /// \brief m_max_vectors The maximum number of buffers gathered into one write.
+    ///
+    static const unsigned int m_max_vectors = 64;
+    ///
+    /// \brief m_staging_size The size of the staging area in bytes.
+    ///
+    static const unsigned int m_staging_size = 4096;
+    ///
+    /// \brief m_min_reference The shortest run of bytes that is written in place rather than staged.
+    ///
+    static const unsigned int m_min_reference = 64;
+
+    // VARIABLES
+    ///
+    /// \brief m_link Stores the link to write to.
+    ///
+    utility::link* m_link;
+    ///
+    /// \brief m_header_byte Stores the header byte.
+    ///
+    unsigned char m_header_byte;
+    ///
+    /// \brief m_escape_byte Stores the escape byte.
+    ///
+    unsigned char m_escape_byte;
+    ///
+    /// \brief m_vectors Stores the buffers gathered for the next write.
+    ///
+    iovec m_vectors[m_max_vectors];
+    ///
+    /// \brief m_n_vectors Stores the number of buffers gathered for the next write.
+    ///
+    unsigned int m_n_vectors;
+    ///
+    /// \brief m_staging Stores copied runs and escape sequences for the next write.
+    ///
+    unsigned char m_staging[m_staging_size];
+    ///
+    /// \brief m_staging_length Stores the number of bytes used in the staging area.
+    ///
+    unsigned int m_staging_length;
+    ///
+    /// \brief m_n_bytes Stores the number of escaped bytes written so far.
+    ///
+    unsigned long m_n_bytes;
+    ///
+    /// \brief m_n_escapes Stores the number of escapes inserted so far.
+    ///
+    unsigned long m_n_escapes;
+
+    // METHODS
+    ///
+    /// \brief stage Copies bytes into the staging area, writing first if it is full.
+    /// \param data The bytes to copy.
+    /// \param length The number of bytes to copy.
+    ///
+    void stage(const unsigned char* data, unsigned int length);
+    ///
+    /// \brief reference Gathers bytes to be written in place.
+    /// \param data The bytes to write.
+    /// \param length The number of bytes to write.
+    ///
+    void reference(const unsigned char* data, unsigned int length);
+};
+
+}}
+
+#endif // ESCAPE_WRITER_H
@@ -0,0 +1,255 @@
+/// \file frame_reader.h
+/// \brief Defines the serial_communicator::utility::frame_reader class.
+#ifndef FRAME_READER_H
+#define FRAME_READER_H
+
+#include "serial_communicator/statistics.h"
+#include "serial_communicator/utility/link.h"
+#include "serial_communicator/utility/rx_buffer.h"
+
+#include <chrono>
+#include <functional>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Assembles packets from the bytes received over a link without blocking.
+/// \details Only bytes that have already arrived are read, a chunk at a time, and unescaped into the packet being
+/// assembled.  A packet that is not yet complete is kept until more bytes arrive, so a packet split across reads
+/// costs no extra waiting.  The header byte is always escaped within a packet, so a header byte part way through a
+/// packet means the packet was cut short.  The partial packet is discarded as a framing error and assembly restarts
+/// at the new header, so a corrupted length can not swallow the packets that follow it.
+///
+/// On a multi-drop bus, each header is followed by the destination and source nodes of the packet.  Packets
+/// addressed to other nodes, and the echoes of this node's own packets, are skipped as soon as their addresses are
+/// read, without being unescaped or given a buffer.
+///
+/// With forward error correction, the front and the addresses form a Reed-Solomon codeword of their own, followed by
+/// the number of parity bytes protecting the rest of the packet.  The rest is split into codewords of up to 255
+/// bytes, each followed by its parity.  Each codeword is corrected as soon as it is complete, so a packet with bytes
+/// corrupted on the way is measured, filtered, and handed over as it was sent.
+///
+class frame_reader
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief frame_reader Creates a new frame_reader instance.
+    /// \param header_byte The header byte that starts each packet.
+    /// \param escape_byte The escape byte.
+    /// \param front_length The number of bytes at the start of a packet, including the header, needed to measure it.
+    /// \param measure Gets the full length of a packet from its front bytes.
+    /// \param statistics The statistics to count received bytes and framing errors in.
+    ///
+    frame_reader(unsigned char header_byte, unsigned char escape_byte, unsigned int front_length, std::function<unsigned int(const unsigned char*)> measure, serial_communicator::statistics& statistics);
+    ~frame_reader();
+
+    // METHODS
+    ///
+    /// \brief fill Reads the bytes that have arrived over a link, up to one chunk, once the previous chunk is used.
+    /// \param link The link to read from.
+    /// \return TRUE if bytes were read, otherwise FALSE.
+    ///
+    bool fill(utility::link* link);
+    ///
+    /// \brief next Assembles the next packet from the bytes read so far.
+    /// \param length Outputs the length of the packet.
+    /// \param timestamp Outputs the time at which the packet's header was read.
+    /// \return The packet, holding a single reference for the caller, or nullptr if more bytes are needed.
+    ///
+    utility::rx_buffer* next(unsigned int& length, std::chrono::steady_clock::time_point& timestamp);
+
+    // PROPERTIES
+    ///
+    /// \brief p_pending Gets if bytes have been read that are not yet assembled.
+    /// \return TRUE if next() should be called again before waiting for the link, otherwise FALSE.
+    ///
+    bool p_pending() const;
+    ///
+    /// \brief p_node Gets the bus node that packets are accepted for.
+    /// \return The node, or 0xFF if packets are not addressed.
+    ///
+    unsigned char p_node() const;
+    ///
+    /// \brief p_node Sets the bus node that packets are accepted for.
+    /// \param value The node, or 0xFF if packets are not addressed.  Packets sent to the node or to 0xFF are accepted.
+    ///
+    void p_node(unsigned char value);
+    ///
+    /// \brief p_front_parity Gets the number of parity bytes protecting the front of each packet.
+    /// \return The number of parity bytes, or 0 if packets are not error corrected.
+    ///
+    unsigned int p_front_parity() const;
+    ///
+    /// \brief p_front_parity Sets the number of parity bytes protecting the front of each packet.
+    /// \param value The number of parity bytes, up to 8, or 0 if packets are not error corrected.
+    /// \details Throws std::invalid_argument if the number is out of range.
+    ///
+    void p_front_parity(unsigned int value);
+    ///
+    /// \brief p_error_rate Gets the fraction of received bytes found in error by forward error correction.
+    /// \return The fraction of bytes in error, averaged over recently received codewords.
+    ///
+    double p_error_rate() const;
+
+private:
+    // ENUMERATIONS
+    ///
+    /// \brief Enumerates the stages of assembling a packet.
+    ///
+    enum class stage
+    {
+        SEARCHING = 0,  ///< Discarding bytes until a header byte.
+        ADDRESSES = 1,  ///< Reading the destination and source nodes of the packet.
+        FRONT = 2,      ///< Reading the front of the packet.
+        BODY = 3        ///< Reading the rest of the packet.
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_chunk_size The maximum number of bytes read from the link at once.
+    ///
+    static const unsigned int m_chunk_size = 4096;
+    ///
+    /// \brief m_max_front_length The largest supported front length.
+    ///
+    static const unsigned int m_max_front_length = 16;
+    ///
+    /// \brief m_max_front_parity The largest supported number of parity bytes protecting the front.
+    ///
+    static const unsigned int m_max_front_parity = 8;
+    ///
+    /// \brief m_error_rate_weight The weight of each codeword in the averaged error rate.
+    ///
+    const double m_error_rate_weight = 1.0 / 64.0;
+
+    // VARIABLES
+    ///
+    /// \brief m_header_byte Stores the header byte.
+    ///
+    unsigned char m_header_byte;
+    ///
+    /// \brief m_escape_byte Stores the escape byte.
+    ///
+    unsigned char m_escape_byte;
+    ///
+    /// \brief m_front_length Stores the number of bytes needed to measure a packet.
+    ///
+    unsigned int m_front_length;
+    ///
+    /// \brief m_node Stores the bus node that packets are accepted for, or 0xFF if packets are not addressed.
+    ///
+    unsigned char m_node;
+    ///
+    /// \brief m_front_parity Stores the number of parity bytes protecting the front, or 0 if not error correcting.
+    ///
+    unsigned int m_front_parity;
+    ///
+    /// \brief m_error_rate Stores the averaged fraction of received bytes in error.
+    ///
+    double m_error_rate;
+    ///
+    /// \brief m_measure Gets the full length of a packet from its front bytes.
+    ///
+    std::function<unsigned int(const unsigned char*)> m_measure;
+    ///
+    /// \brief m_statistics Stores the statistics to count in.
+    ///
+    serial_communicator::statistics& m_statistics;
+    ///
+    /// \brief m_chunk Stores the bytes last read from the link.
+    ///
+    unsigned char m_chunk[m_chunk_size];
+    ///
+    /// \brief m_chunk_length Stores the number of bytes in the chunk.
+    ///
+    unsigned int m_chunk_length;
+    ///
+    /// \brief m_chunk_position Stores the position of the next unassembled byte in the chunk.
+    ///
+    unsigned int m_chunk_position;
+    ///
+    /// \brief m_stage Stores the stage of the packet being assembled.
+    ///
+    stage m_stage;
+    ///
+    /// \brief m_unescape_next Stores if the next byte is escaped, even across chunks.
+    ///
+    bool m_unescape_next;
+    ///
+    /// \brief m_addresses Stores the destination and source nodes of the packet.
+    ///
+    unsigned char m_addresses[2];
+    ///
+    /// \brief m_front Stores the front of the packet until it can be measured.
+    ///
+    unsigned char m_front[m_max_front_length];
+    ///
+    /// \brief m_coded_front Stores the codeword of the addresses, front, and parity level until it is corrected.
+    ///
+    unsigned char m_coded_front[2 + m_max_front_length + m_max_front_parity];
+    ///
+    /// \brief m_parity Stores the number of parity bytes following each codeword of the rest of the packet.
+    ///
+    unsigned int m_parity;
+    ///
+    /// \brief m_packet_length Stores the length of the packet once its parity is removed.
+    ///
+    unsigned int m_packet_length;
+    ///
+    /// \brief m_buffer Stores the packet being assembled once measured, or nullptr.
+    ///
+    utility::rx_buffer* m_buffer;
+    ///
+    /// \brief m_length Stores the length of the current stage's bytes, for the addresses, the front, or the whole
+    /// packet, including any parity.
+    ///
+    unsigned int m_length;
+    ///
+    /// \brief m_position Stores the number of bytes assembled so far.
+    ///
+    unsigned int m_position;
+    ///
+    /// \brief m_timestamp Stores the time at which the packet's header was read.
+    ///
+    std::chrono::steady_clock::time_point m_timestamp;
+
+    // METHODS
+    ///
+    /// \brief unescape Unescapes bytes from the chunk until the current stage is complete, or the chunk is used, or a
+    /// header byte is reached.
+    /// \param destination The bytes of the current stage.
+    /// \return TRUE if the current stage is complete, otherwise FALSE.
+    ///
+    bool unescape(unsigned char* destination);
+    ///
+    /// \brief accept_addresses Checks that the packet is addressed to this node, or skips it.
+    /// \return TRUE if the packet is accepted, otherwise FALSE and the next header is searched for.
+    ///
+    bool accept_addresses();
+    ///
+    /// \brief correct_front Corrects the codeword of the front, and unpacks its addresses, front, and parity level.
+    /// \return TRUE if the front was corrected, otherwise FALSE and the packet is discarded.
+    ///
+    bool correct_front();
+    ///
+    /// \brief correct_body Corrects each codeword of the rest of the packet in place, and removes their parity.
+    /// \return TRUE if the packet was corrected, otherwise FALSE and the packet is discarded.
+    ///
+    bool correct_body();
+    ///
+    /// \brief record_errors Counts the bytes corrected in a codeword, and updates the averaged error rate.
+    /// \param n_errors The number of bytes corrected, or -1 if the codeword could not be corrected.
+    /// \param length The length of the codeword in bytes.
+    /// \param n_parity The number of parity bytes in the codeword.
+    ///
+    void record_errors(int n_errors, unsigned int length, unsigned int n_parity);
+    ///
+    /// \brief discard Discards the packet being assembled and searches for the next header.
+    /// \param reason OPTIONAL The counter to count the discarded packet in.
+    ///
+    void discard(serial_communicator::statistics::counter reason = serial_communicator::statistics::counter::FRAMING_ERRORS);
+};
+}}
+
+#endif // FRAME_READER_H
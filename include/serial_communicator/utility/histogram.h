@@ -0,0 +1,109 @@
+/// \file histogram.h
+/// \brief Defines the serial_communicator::utility::histogram class.
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief A lock-free, log-linear histogram of unsigned values.
+/// \details Values are grouped into buckets with 8 sub-buckets per power of two, giving a relative precision
+/// of 12.5% over the full 64 bit range with a fixed memory footprint.  Values may be recorded and read
+/// concurrently from any number of threads.
+///
+class histogram
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief histogram Creates a new, empty histogram instance.
+    ///
+    histogram();
+
+    // METHODS
+    ///
+    /// \brief record Records a value into the histogram.
+    /// \param value The value to record.
+    ///
+    void record(unsigned long long value);
+    ///
+    /// \brief percentile Gets the value at a given percentile.
+    /// \param percentile The percentile to get, between 0 and 100.
+    /// \return The highest value equivalent to the percentile's bucket, bounded by the maximum, or 0 if the histogram is empty.
+    ///
+    unsigned long long percentile(double percentile) const;
+    ///
+    /// \brief reset Clears all recorded values.
+    ///
+    void reset();
+
+    // PROPERTIES
+    ///
+    /// \brief p_count Gets the number of recorded values.
+    /// \return The number of recorded values.
+    ///
+    unsigned long long p_count() const;
+    ///
+    /// \brief p_min Gets the minimum recorded value.
+    /// \return The minimum recorded value, or 0 if the histogram is empty.
+    ///
+    unsigned long long p_min() const;
+    ///
+    /// \brief p_max Gets the maximum recorded value.
+    /// \return The maximum recorded value.
+    ///
+    unsigned long long p_max() const;
+    ///
+    /// \brief p_mean Gets the mean of the recorded values.
+    /// \return The mean of the recorded values, or 0 if the histogram is empty.
+    ///
+    double p_mean() const;
+
+private:
+    // CONSTANTS
+    ///
+    /// \brief m_n_buckets The total number of buckets.
+    ///
+    static const unsigned int m_n_buckets = 496;
+
+    // VARIABLES
+    ///
+    /// \brief m_buckets Stores the count of each bucket.
+    ///
+    std::atomic<unsigned long long> m_buckets[m_n_buckets];
+    ///
+    /// \brief m_count Stores the number of recorded values.
+    ///
+    std::atomic<unsigned long long> m_count;
+    ///
+    /// \brief m_sum Stores the sum of the recorded values.
+    ///
+    std::atomic<unsigned long long> m_sum;
+    ///
+    /// \brief m_min Stores the minimum recorded value.
+    ///
+    std::atomic<unsigned long long> m_min;
+    ///
+    /// \brief m_max Stores the maximum recorded value.
+    ///
+    std::atomic<unsigned long long> m_max;
+
+    // METHODS
+    ///
+    /// \brief bucket Gets the bucket index of a value.
+    /// \param value The value.
+    /// \return The index of the bucket that the value is counted in.
+    ///
+    static unsigned int bucket(unsigned long long value);
+    ///
+    /// \brief bucket_value Gets the highest value counted in a bucket.
+    /// \param bucket The index of the bucket.
+    /// \return The highest value counted in the bucket.
+    ///
+    static unsigned long long bucket_value(unsigned int bucket);
+};
+}}
+
+#endif // HISTOGRAM_H
@@ -3,7 +3,9 @@
 #ifndef INBOUND_H
 #define INBOUND_H
 
-#include "serial_communicator/message.h"
+#include "serial_communicator/message_view.h"
+
+#include <chrono>
 
 namespace serial_communicator {
 ///
@@ -19,35 +21,82 @@ public:
     // CONSTRUCTORS
     ///
     /// \brief inbound Creates a new inbound instance.
-    /// \param message A pointer to the received message.
+    /// \param view A view of the received message in its receive buffer.
     /// \param sequence_number The originating sequence number of the received message.
-    /// \details This instance takes ownership of the message pointer.
+    /// \param timestamp The time at which the message arrived.
+    /// \param origin_timestamp The time at which the sender queued the message in the local clock, or the arrival
+    /// time if it is not known.
     ///
-    inbound(message* message, unsigned int sequence_number);
+    inbound(const message_view& view, unsigned int sequence_number, std::chrono::steady_clock::time_point timestamp, std::chrono::steady_clock::time_point origin_timestamp);
 
     // PROPERTIES
     ///
-    /// \brief p_message Gets a pointer to the received message.
-    /// \return A pointer to the received message.
+    /// \brief p_view Gets a view of the received message.
+    /// \return A view of the received message.
     ///
-    message* p_message() const;
+    const message_view& p_view() const;
     ///
     /// \brief p_sequence_number Gets the originiating sequence number of the received message.
     /// \return The originating sequence number of the received message.
     ///
     unsigned int p_sequence_number() const;
+    ///
+    /// \brief p_timestamp Gets the time at which the message arrived.
+    /// \return The arrival time of the message.
+    ///
+    std::chrono::steady_clock::time_point p_timestamp() const;
+    ///
+    /// \brief p_origin_timestamp Gets the time at which the sender queued the message.
+    /// \return The time at which the sender queued the message in the local clock, or the arrival time if it is not known.
+    ///
+    std::chrono::steady_clock::time_point p_origin_timestamp() const;
+    ///
+    /// \brief p_has_call Gets if the message belongs to a call.
+    /// \return TRUE if the message is a call's request or response, otherwise FALSE.
+    ///
+    bool p_has_call() const;
+    ///
+    /// \brief p_call Gets the message's call field.
+    /// \return The call ID, with the highest bit set if the message is a response.
+    ///
+    unsigned short p_call() const;
+    ///
+    /// \brief p_call Sets the message's call field, marking it as belonging to a call.
+    /// \param value The call ID, with the highest bit set if the message is a response.
+    ///
+    void p_call(unsigned short value);
 
 private:
     ///
-    /// \brief m_message Stores a pointer to the recieved message.
+    /// \brief m_view Stores a view of the received message, which holds its receive buffer.
     ///
-    message* m_message;
+    message_view m_view;
     ///
     /// \brief m_sequence_number Stores the originating sequence number of the received message.
     ///
     unsigned int m_sequence_number;
+    ///
+    /// \brief m_timestamp Stores the time at which the message arrived.
+    ///
+    std::chrono::steady_clock::time_point m_timestamp;
+    ///
+    /// \brief m_origin_timestamp Stores the time at which the sender queued the message.
+    ///
+    std::chrono::steady_clock::time_point m_origin_timestamp;
+    ///
+    /// \brief m_has_call Stores if the message belongs to a call.
+    ///
+    bool m_has_call;
+    ///
+    /// \brief m_call Stores the message's call field.
+    ///
+    unsigned short m_call;
 };
 
 }}
 
+#ifdef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/inbound.inl"
+#endif
+
 #endif // INBOUND_H
@@ -0,0 +1,137 @@
+/// \file journal.h
+/// \brief Defines the serial_communicator::utility::journal class.
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "serial_communicator/message.h"
+
+#include <string>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Keeps outbound messages in a memory-mapped log file until they are acknowledged.
+/// \details Messages are appended to a ring in the file, and marked as acknowledged once their receipts arrive.
+/// Acknowledged messages at the front of the ring are removed to make room.  Messages are loaded from the ring into
+/// memory a few at a time, so that any number of messages can wait in the file while the link is down.  The file
+/// outlives the process, so messages that were never acknowledged are loaded again when it is reopened.
+///
+class journal
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief journal Opens a journal file, or creates it if it does not exist.
+    /// \param path The path of the journal file.
+    /// \param size The size of a new journal file's ring, in bytes.  An existing file keeps its size.
+    /// \details Throws std::invalid_argument if the size can not hold a single record, or std::runtime_error if the file
+    /// can not be opened or mapped.
+    ///
+    journal(std::string path, unsigned long size);
+    ~journal();
+
+    // METHODS
+    ///
+    /// \brief append Appends a message to the journal.
+    /// \param message The message to append.
+    /// \param loaded Indicates that the message will be held in memory, so it is not loaded from the journal.  Only
+    /// valid when no other messages are waiting to be loaded.
+    /// \param position Outputs the position of the message in the journal, which identifies it until acknowledged.
+    /// \return TRUE if the message was appended, or FALSE if the journal is full.
+    ///
+    bool append(const message& message, bool loaded, unsigned long long& position);
+    ///
+    /// \brief next Loads the next message that is waiting in the journal.
+    /// \param message Outputs the message.
+    /// \param position Outputs the position of the message in the journal.
+    /// \return TRUE if a message was loaded, or FALSE if no messages are waiting.
+    ///
+    bool next(message& message, unsigned long long& position);
+    ///
+    /// \brief acknowledge Marks a message as acknowledged, and removes acknowledged messages from the front of the journal.
+    /// \param position The position of the message in the journal.
+    ///
+    void acknowledge(unsigned long long position);
+    ///
+    /// \brief rewind Makes every message that has not been acknowledged wait to be loaded again.
+    /// \details Used when messages held in memory are removed from it before being acknowledged.
+    ///
+    void rewind();
+
+    // PROPERTIES
+    ///
+    /// \brief p_waiting Gets if messages are waiting in the journal to be loaded.
+    /// \return TRUE if messages are waiting, otherwise FALSE.
+    ///
+    bool p_waiting() const;
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief The header at the start of a journal file.
+    ///
+    struct file_header
+    {
+        char magic[8];                      ///< Identifies the file as a journal file.
+        unsigned long long capacity;        ///< The size of the ring following the header, in bytes.
+        unsigned long long head;            ///< The offset of the oldest record in the ring.
+        unsigned long long used;            ///< The number of bytes in use in the ring.
+    };
+    ///
+    /// \brief The header preceding each message in the ring.
+    ///
+    struct record_header
+    {
+        unsigned int length;                ///< The data length of the message, or m_wrap_marker if the ring wraps here.
+        unsigned short id;                  ///< The ID of the message.
+        unsigned char priority;             ///< The priority of the message.
+        unsigned char node;                 ///< The bus node the message is sent to.
+        unsigned char acknowledged;         ///< Set once the message's receipt has arrived.
+        unsigned char reserved[7];          ///< Reserved for alignment.
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_wrap_marker Marks that the rest of the ring is unused and records continue at its start.
+    ///
+    static const unsigned int m_wrap_marker = 0xFFFFFFFF;
+
+    // VARIABLES
+    ///
+    /// \brief m_fd The journal file's descriptor.
+    ///
+    int m_fd;
+    ///
+    /// \brief m_map_size The size of the mapping, in bytes.
+    ///
+    unsigned long m_map_size;
+    ///
+    /// \brief m_header The file header within the mapping.
+    ///
+    file_header* m_header;
+    ///
+    /// \brief m_ring The ring within the mapping.
+    ///
+    unsigned char* m_ring;
+    ///
+    /// \brief m_loaded The number of bytes from the head of the ring that have been loaded into memory.
+    ///
+    unsigned long long m_loaded;
+
+    // METHODS
+    ///
+    /// \brief record_size Gets the ring space taken by the record at an offset.
+    /// \param offset The offset of the record.
+    /// \return The number of bytes the record takes, including padding or the skipped end of the ring.
+    ///
+    unsigned long long record_size(unsigned long long offset) const;
+    ///
+    /// \brief is_record Checks if a message record, rather than the skipped end of the ring, is at an offset.
+    /// \param offset The offset to check.
+    /// \return TRUE if a message record is at the offset, otherwise FALSE.
+    ///
+    bool is_record(unsigned long long offset) const;
+};
+}}
+
+#endif // JOURNAL_H
@@ -0,0 +1,176 @@
+/// \file link.h
+/// \brief Defines the serial_communicator::utility::link class.
+#ifndef LINK_H
+#define LINK_H
+
+#include "serial_communicator/transport.h"
+#include "serial_communicator/utility/negotiator.h"
+
+#include <chrono>
+#include <vector>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Provides management of a single physical link used by a communicator.
+/// \details A link tracks the estimated transmit backlog of its port so that packets can be scheduled
+/// across several links by baud rate and load, and tracks receipt timeouts so that a link which stops
+/// responding can be failed over.
+///
+class link
+{
+public:
+    // CONSTRUCTORS
+    ///
+    /// \brief link Creates a new link instance.
+    /// \param transport The transport to communicate over. The link takes ownership of the pointer.
+    ///
+    link(serial_communicator::transport* transport);
+    ~link();
+
+    // METHODS
+    ///
+    /// \brief write Writes bytes to the link.
+    /// \param buffer The buffer of bytes to write.
+    /// \param length The number of bytes to write.
+    /// \details The link's transmit backlog is extended by the time the bytes take to transmit over the transport.
+    ///
+    void write(const unsigned char* buffer, unsigned int length);
+    ///
+    /// \brief write Writes several buffers to the link, in order, as one contiguous stream of bytes.
+    /// \param vectors The buffers to write.
+    /// \param count The number of buffers to write.
+    ///
+    void write(const iovec* vectors, unsigned int count);
+    ///
+    /// \brief read Reads bytes from the link.
+    /// \param buffer The pre-allocated buffer to store read bytes in.
+    /// \param length The maximum number of bytes to read.
+    /// \return The number of bytes read, which is less than length if the read timed out.
+    ///
+    unsigned long read(unsigned char* buffer, unsigned int length);
+    ///
+    /// \brief available Gets the number of bytes that have arrived and can be read without blocking.
+    /// \return The number of bytes available.
+    ///
+    unsigned long available();
+    ///
+    /// \brief completion_time Estimates when a packet would finish transmitting if written to the link now.
+    /// \param length The length of the packet in bytes.
+    /// \return The estimated completion time of the packet.
+    ///
+    std::chrono::steady_clock::time_point completion_time(unsigned int length) const;
+    ///
+    /// \brief quiet_time Estimates when the link will have been quiet in both directions for a gap.
+    /// \param gap The length of the gap in byte times.
+    /// \return The end of the gap after the last byte written and the last byte read.
+    ///
+    std::chrono::steady_clock::time_point quiet_time(unsigned int gap) const;
+    ///
+    /// \brief mark_timeout Informs the link that a message transmitted over it timed out waiting for a receipt.
+    /// \details The link is failed after several consecutive timeouts.
+    ///
+    void mark_timeout();
+    ///
+    /// \brief mark_received Informs the link that a valid packet was received over it.
+    /// \details This restores a failed link.
+    ///
+    void mark_received();
+    ///
+    /// \brief start_negotiation Starts negotiating the link's baud rate with the remote communicator.
+    /// \param bauds The baud rates that the link may run at.
+    /// \return TRUE if negotiation was started, or FALSE if the link's transport does not have a baud rate.
+    ///
+    bool start_negotiation(const std::vector<unsigned int>& bauds);
+    ///
+    /// \brief stop_negotiation Stops negotiating the link's baud rate.  The link remains at its current rate.
+    ///
+    void stop_negotiation();
+    ///
+    /// \brief set_baud Changes the baud rate of the link's transport.
+    /// \param baud The new baud rate.
+    ///
+    void set_baud(unsigned int baud);
+
+    // PROPERTIES
+    ///
+    /// \brief p_usable Checks if the link should be used for transmitting.
+    /// \return TRUE if the link is up, or if it is failed and due to be probed again, otherwise FALSE.
+    ///
+    bool p_usable() const;
+    ///
+    /// \brief p_paused Gets if the link must not carry messages because its baud rate is being changed.
+    /// \return TRUE if the link is paused, otherwise FALSE.
+    ///
+    bool p_paused() const;
+    ///
+    /// \brief p_drained Gets if all bytes written to the link are estimated to have been transmitted.
+    /// \return TRUE if the link's transmit backlog has drained, otherwise FALSE.
+    ///
+    bool p_drained() const;
+    ///
+    /// \brief p_negotiator Gets the link's baud rate negotiator.
+    /// \return The negotiator, or nullptr if the link's baud rate is not being negotiated.
+    ///
+    utility::negotiator* p_negotiator() const;
+    ///
+    /// \brief p_failed Gets if the link has been failed.
+    /// \return TRUE if the link is failed, otherwise FALSE.
+    ///
+    bool p_failed() const;
+    ///
+    /// \brief p_closed Gets if the remote end of the link's transport has closed it.
+    /// \return TRUE if the link is closed, otherwise FALSE.
+    /// \details Closed links are never written to, since writing to a closed socket raises SIGPIPE.
+    ///
+    bool p_closed() const;
+    ///
+    /// \brief p_file_descriptor Gets a file descriptor that can be polled for the link's readability.
+    /// \return The file descriptor, or -1 if the link can not be polled.
+    ///
+    int p_file_descriptor() const;
+
+private:
+    // CONSTANTS
+    ///
+    /// \brief m_max_timeouts The number of consecutive receipt timeouts after which the link is failed.
+    ///
+    const unsigned char m_max_timeouts = 3;
+    ///
+    /// \brief m_probe_interval The interval at which a failed link is probed with traffic again, in milliseconds.
+    ///
+    const unsigned int m_probe_interval = 1000;
+
+    // VARIABLES
+    ///
+    /// \brief m_transport The link's transport.
+    ///
+    serial_communicator::transport* m_transport;
+    ///
+    /// \brief m_busy_timestamp Stores the estimated time at which all written bytes will have been transmitted.
+    ///
+    std::chrono::steady_clock::time_point m_busy_timestamp;
+    ///
+    /// \brief m_read_timestamp Stores the last time at which bytes were read.
+    ///
+    std::chrono::steady_clock::time_point m_read_timestamp;
+    ///
+    /// \brief m_n_timeouts Stores the number of consecutive receipt timeouts.
+    ///
+    unsigned char m_n_timeouts;
+    ///
+    /// \brief m_failed Stores if the link has been failed.
+    ///
+    bool m_failed;
+    ///
+    /// \brief m_probe_timestamp Stores the last time a failed link was failed or probed.
+    ///
+    std::chrono::steady_clock::time_point m_probe_timestamp;
+    ///
+    /// \brief m_negotiator Stores the link's baud rate negotiator, or nullptr if the baud rate is not negotiated.
+    ///
+    utility::negotiator* m_negotiator;
+};
+}}
+
+#endif // LINK_H
@@ -0,0 +1,310 @@
+/// \file negotiator.h
+/// \brief Defines the serial_communicator::utility::negotiator class.
+#ifndef NEGOTIATOR_H
+#define NEGOTIATOR_H
+
+#include <chrono>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Negotiates the baud rate of a single link with the remote communicator.
+/// \details The negotiator watches the link's checksum failures and receipt timeouts over fixed windows.  After
+/// several clean windows it proposes the next higher baud rate, and when errors become too frequent it proposes
+/// the next lower one.  A change is agreed with a request and accept exchange, after which both ends switch once
+/// their last bytes at the old rate have drained.  The initiator then confirms the link at the new rate, and both
+/// ends revert to the old rate if confirmation does not complete.  Requests and confirms are resent until answered.  Rates that fail are held off for a growing
+/// interval.  If a link at a negotiated rate sees only errors, both ends fall back to the rate they started at.
+///
+/// The negotiator does not perform any I/O.  It is driven by handle() for received control packets and poll() for
+/// timed duties, and reports the control packets to send and the rates to switch to.
+///
+class negotiator
+{
+public:
+    // ENUMERATIONS
+    ///
+    /// \brief Enumerates the commands carried by control packets.
+    ///
+    enum class command
+    {
+        REQUEST = 1,    ///< Proposes a baud rate to the remote negotiator.
+        ACCEPT = 2,     ///< Agrees to a proposed baud rate.  Both ends switch once the accept has been transmitted.
+        REJECT = 3,     ///< Refuses a proposed baud rate.
+        CONFIRM = 4,    ///< Checks the link after switching, sent at the new baud rate.
+        CONFIRMED = 5   ///< Answers a confirm, completing the change.
+    };
+    ///
+    /// \brief Enumerates the actions requested by poll().
+    ///
+    enum class action
+    {
+        NONE = 0,       ///< Nothing needs to be done.
+        SEND = 1,       ///< A control packet should be sent over the link.
+        SWITCH = 2      ///< The link should be switched to a new baud rate.
+    };
+
+    // STRUCTURES
+    ///
+    /// \brief The contents of a control packet.
+    ///
+    struct control
+    {
+        ///
+        /// \brief command The control command.
+        ///
+        negotiator::command command;
+        ///
+        /// \brief baud The baud rate the command refers to.
+        ///
+        unsigned int baud;
+        ///
+        /// \brief nonce Identifies the negotiation that the command belongs to.
+        ///
+        unsigned int nonce;
+    };
+
+    // CONSTRUCTORS
+    ///
+    /// \brief negotiator Creates a new negotiator instance.
+    /// \param bauds The baud rates that the link may run at.  The remote negotiator must use the same rates.
+    /// \param baud The baud rate that the link is running at, which is fallen back to if the link loses sync.
+    ///
+    negotiator(std::vector<unsigned int> bauds, unsigned int baud);
+
+    // METHODS
+    ///
+    /// \brief mark_received Informs the negotiator that a packet was received over the link.
+    /// \param checksum_ok Indicates if the packet's checksum matched.
+    ///
+    void mark_received(bool checksum_ok);
+    ///
+    /// \brief mark_timeout Informs the negotiator that a message sent over the link timed out waiting for a receipt.
+    ///
+    void mark_timeout();
+    ///
+    /// \brief handle Handles a control packet received from the remote negotiator.
+    /// \param control The received control packet.
+    ///
+    void handle(const control& control);
+    ///
+    /// \brief poll Performs the negotiator's timed duties.
+    /// \param drained Indicates if all bytes written to the link have been transmitted.
+    /// \param output Outputs the control packet to send for SEND, or the baud rate to switch to for SWITCH.
+    /// \return The action to perform.  poll() should be called again until it returns NONE.
+    ///
+    action poll(bool drained, control& output);
+
+    // PROPERTIES
+    ///
+    /// \brief p_baud Gets the baud rate that the link is running at.
+    /// \return The baud rate.
+    ///
+    unsigned int p_baud() const;
+    ///
+    /// \brief p_paused Gets if messages should be held off the link while a change is in progress.
+    /// \return TRUE if the link should not carry messages, otherwise FALSE.
+    ///
+    bool p_paused() const;
+    ///
+    /// \brief p_poll_delay Gets how long until poll() next has work to do.
+    /// \return The delay in milliseconds.
+    ///
+    unsigned int p_poll_delay() const;
+
+private:
+    // ENUMERATIONS
+    ///
+    /// \brief Enumerates the states of a negotiation.
+    ///
+    enum class state
+    {
+        IDLE = 0,       ///< No change is in progress.
+        REQUESTED = 1,  ///< A request has been sent and is awaiting a reply.
+        ACCEPTED = 2,   ///< A change has been agreed, and is waiting for the link to drain before switching.
+        CONFIRMING = 3, ///< The initiator has switched and is confirming the link.
+        VERIFYING = 4   ///< The responder has switched and is waiting for the initiator's confirm.
+    };
+
+    // CONSTANTS
+    ///
+    /// \brief m_window The length of the windows that errors are counted over, in milliseconds.
+    ///
+    const unsigned int m_window = 1000;
+    ///
+    /// \brief m_clean_windows The number of consecutive windows without errors before a higher rate is proposed.
+    ///
+    const unsigned int m_clean_windows = 5;
+    ///
+    /// \brief m_min_errors The minimum number of errors in a window before a lower rate is proposed.
+    ///
+    const unsigned int m_min_errors = 3;
+    ///
+    /// \brief m_max_error_percent The percentage of packets in error in a window above which a lower rate is proposed.
+    ///
+    const unsigned int m_max_error_percent = 5;
+    ///
+    /// \brief m_max_silent_errors The number of consecutive errors at a negotiated rate, together with the sync
+    /// timeout passing without a valid packet, after which the link is assumed to have lost sync.
+    ///
+    const unsigned int m_max_silent_errors = 5;
+    ///
+    /// \brief m_sync_timeout The time without a valid packet after which a link seeing errors is assumed to have lost
+    /// sync and falls back to its starting rate, in milliseconds.
+    ///
+    const unsigned int m_sync_timeout = 2000;
+    ///
+    /// \brief m_request_timeout The time to wait for a reply to a request, in milliseconds.
+    /// \details An unanswered request may have been accepted, with the accept lost after the remote end switched, so
+    /// the initiator switches anyway and relies on confirmation to decide.
+    ///
+    const unsigned int m_request_timeout = 500;
+    ///
+    /// \brief m_resend_interval The interval at which requests and confirms are resent until answered, in milliseconds.
+    ///
+    const unsigned int m_resend_interval = 100;
+    ///
+    /// \brief m_confirm_timeout The time the initiator confirms the link for before reverting, in milliseconds.
+    /// \details The responder waits twice as long, so that it does not revert while the initiator is still confirming.
+    ///
+    const unsigned int m_confirm_timeout = 1000;
+    ///
+    /// \brief m_min_hold The initial time a failed rate is held off for, in milliseconds.
+    ///
+    const unsigned int m_min_hold = 10000;
+    ///
+    /// \brief m_max_hold The longest time a failed rate is held off for, in milliseconds.
+    ///
+    const unsigned int m_max_hold = 300000;
+
+    // VARIABLES
+    ///
+    /// \brief m_bauds Stores the baud rates the link may run at, in ascending order.
+    ///
+    std::vector<unsigned int> m_bauds;
+    ///
+    /// \brief m_base Stores the index of the starting baud rate.
+    ///
+    unsigned int m_base;
+    ///
+    /// \brief m_index Stores the index of the current baud rate.
+    ///
+    unsigned int m_index;
+    ///
+    /// \brief m_previous Stores the index of the baud rate to revert to if a change is not confirmed.
+    ///
+    unsigned int m_previous;
+    ///
+    /// \brief m_target Stores the index of the baud rate being negotiated.
+    ///
+    unsigned int m_target;
+    ///
+    /// \brief m_state Stores the state of the negotiation.
+    ///
+    state m_state;
+    ///
+    /// \brief m_initiator Stores if this end initiated the negotiation in progress.
+    ///
+    bool m_initiator;
+    ///
+    /// \brief m_nonce Stores the nonce of the negotiation in progress.
+    ///
+    unsigned int m_nonce;
+    ///
+    /// \brief m_state_timestamp Stores when the negotiation entered its current state.
+    ///
+    std::chrono::steady_clock::time_point m_state_timestamp;
+    ///
+    /// \brief m_send_timestamp Stores when the last request or confirm was sent.
+    ///
+    std::chrono::steady_clock::time_point m_send_timestamp;
+    ///
+    /// \brief m_outgoing Stores control packets waiting to be sent.
+    ///
+    std::deque<control> m_outgoing;
+    ///
+    /// \brief m_n_received Stores the number of valid packets received in the current window.
+    ///
+    unsigned int m_n_received;
+    ///
+    /// \brief m_n_errors Stores the number of checksum failures and receipt timeouts in the current window.
+    ///
+    unsigned int m_n_errors;
+    ///
+    /// \brief m_n_silent_errors Stores the number of errors since the last valid packet.
+    ///
+    unsigned int m_n_silent_errors;
+    ///
+    /// \brief m_received_timestamp Stores when the last valid packet was received.
+    ///
+    std::chrono::steady_clock::time_point m_received_timestamp;
+    ///
+    /// \brief m_n_clean_windows Stores the number of consecutive windows without errors.
+    ///
+    unsigned int m_n_clean_windows;
+    ///
+    /// \brief m_window_timestamp Stores when the current window started.
+    ///
+    std::chrono::steady_clock::time_point m_window_timestamp;
+    ///
+    /// \brief m_ceiling Stores the index of the lowest rate that recently failed.
+    ///
+    unsigned int m_ceiling;
+    ///
+    /// \brief m_hold Stores the time that a failed rate is held off for, in milliseconds.
+    ///
+    unsigned int m_hold;
+    ///
+    /// \brief m_hold_timestamp Stores when the failed rate may be proposed again.
+    ///
+    std::chrono::steady_clock::time_point m_hold_timestamp;
+    ///
+    /// \brief m_random Generates nonces.
+    ///
+    std::mt19937 m_random;
+
+    // METHODS
+    ///
+    /// \brief request Starts negotiating a new baud rate.
+    /// \param index The index of the baud rate to propose.
+    ///
+    void request(unsigned int index);
+    ///
+    /// \brief finish Ends the negotiation in progress and starts a new window.
+    /// \param success Indicates if the link is running at the negotiated rate.  Otherwise the rate is held off.
+    ///
+    void finish(bool success);
+    ///
+    /// \brief hold Holds off proposing a rate that failed, for longer each time a rate fails.
+    /// \param index The index of the rate that failed.
+    ///
+    void hold(unsigned int index);
+    ///
+    /// \brief lost_sync Checks if the link appears to have lost sync with the remote end at a negotiated rate.
+    /// \return TRUE if the link should fall back to its starting rate, otherwise FALSE.
+    ///
+    bool lost_sync() const;
+    ///
+    /// \brief evaluate Decides if a new rate should be proposed at the end of a window.
+    ///
+    void evaluate();
+    ///
+    /// \brief index_of Finds the index of a baud rate.
+    /// \param baud The baud rate to find.
+    /// \return The index of the baud rate, or the number of baud rates if it is not listed.
+    ///
+    unsigned int index_of(unsigned int baud) const;
+    ///
+    /// \brief remaining Gets the time remaining until a duration has elapsed since a timestamp.
+    /// \param timestamp The timestamp.
+    /// \param duration The duration in milliseconds.
+    /// \return The remaining time in milliseconds, or 0 if the duration has elapsed.
+    ///
+    unsigned int remaining(std::chrono::steady_clock::time_point timestamp, unsigned int duration) const;
+};
+}}
+
+#endif // NEGOTIATOR_H
@@ -5,6 +5,7 @@
 
 #include "serial_communicator/message.h"
 #include "serial_communicator/message_status.h"
+#include "serial_communicator/utility/link.h"
 
 #include <chrono>
 
@@ -19,21 +20,29 @@ public:
     // CONSTRUCTORS
     ///
     /// \brief outbound Initializes a new outbound instance.
-    /// \param message The outbound message.
+    /// \param message The outbound message. This instance takes ownership of the message pointer.
     /// \param sequence_number The originating sequence number of the outbound message.
     /// \param receipt_required A flag indicating if receipt is required for the outbound message.
     /// \param tracker A tracker for external observation of an outgoing message's status.
     ///
     outbound(message* message, unsigned int sequence_number, bool receipt_required, message_status* tracker);
-    ~outbound();
+    ///
+    /// \brief outbound Initializes a new outbound instance that stores the message directly.
+    /// \param message The outbound message to move from.
+    /// \param sequence_number The originating sequence number of the outbound message.
+    /// \param receipt_required A flag indicating if receipt is required for the outbound message.
+    /// \param tracker A tracker for external observation of an outgoing message's status.
+    ///
+    outbound(message&& message, unsigned int sequence_number, bool receipt_required, message_status* tracker);
 
     // METHODS
     ///
     /// \brief mark_transmitted Instrucst the outgoing message that it has been transmitted.
+    /// \param link The link that the message was transmitted over.
     /// \details Call this method any time the message is transmitted.  It informs the instance
     /// to update counters and timestamps related to retransmission.
     ///
-    void mark_transmitted();
+    void mark_transmitted(utility::link* link);
     ///
     /// \brief update_status Updates the internal status and tracker to a new message status.
     /// \param status The new status to set.
@@ -46,6 +55,17 @@ public:
     ///
     bool timeout_elapsed(unsigned int timeout) const;
     ///
+    /// \brief timeout_remaining Gets the time remaining until a specified timeout elapses since the message was last transmitted.
+    /// \param timeout The length of the timeout period in milliseconds.
+    /// \return The time remaining in milliseconds, or zero if the timeout has already elapsed.
+    ///
+    unsigned int timeout_remaining(unsigned int timeout) const;
+    ///
+    /// \brief elapsed Gets the time elapsed since the message was last transmitted, or since it was queued if it has not been transmitted.
+    /// \return The elapsed time in microseconds.
+    ///
+    unsigned long long elapsed() const;
+    ///
     /// \brief can_retransmit Checks if the message can be retransmitted, or if it has reached its max transmissions.
     /// \param transmit_limit The maximum allowed transmissions of the message.
     /// \return TRUE if the message may be retransmitted, otherwise FALSE.
@@ -78,13 +98,68 @@ public:
     /// \return The current status of the message.
     ///
     message_status p_status() const;
+    ///
+    /// \brief p_link Gets the link that the message was last transmitted over.
+    /// \return The link that the message was last transmitted over, or nullptr if it has not been transmitted.
+    ///
+    utility::link* p_link() const;
+    ///
+    /// \brief p_queue_timestamp Gets the time at which the message was queued.
+    /// \return The time at which the message was queued.
+    ///
+    std::chrono::steady_clock::time_point p_queue_timestamp() const;
+    ///
+    /// \brief p_transmit_timestamp Gets the time at which the message was last transmitted.
+    /// \return The time at which the message was last transmitted, or queued if it has not been transmitted.
+    ///
+    std::chrono::steady_clock::time_point p_transmit_timestamp() const;
+    ///
+    /// \brief p_has_call Gets if the message belongs to a call.
+    /// \return TRUE if the message is a call's request or response, otherwise FALSE.
+    ///
+    bool p_has_call() const;
+    ///
+    /// \brief p_call Gets the message's call field.
+    /// \return The call ID, with the highest bit set if the message is a response.
+    ///
+    unsigned short p_call() const;
+    ///
+    /// \brief p_call Sets the message's call field, marking it as belonging to a call.
+    /// \param value The call ID, with the highest bit set if the message is a response.
+    ///
+    void p_call(unsigned short value);
+    ///
+    /// \brief p_journal_position Gets the position of the message in the communicator's journal.
+    /// \return The position, or m_not_journaled if the message is only held in memory.
+    ///
+    unsigned long long p_journal_position() const;
+    ///
+    /// \brief p_journal_position Sets the position of the message in the communicator's journal.
+    /// \param value The position, or m_not_journaled if the message is only held in memory.
+    ///
+    void p_journal_position(unsigned long long value);
+
+    // CONSTANTS
+    ///
+    /// \brief m_not_journaled Marks a message that is not kept in a journal.
+    ///
+    static const unsigned long long m_not_journaled = ~0ULL;
 
 private:
+    // METHODS
+    ///
+    /// \brief initialize Initializes the outbound instance's state.
+    /// \param sequence_number The originating sequence number of the outbound message.
+    /// \param receipt_required A flag indicating if receipt is required for the outbound message.
+    /// \param tracker A tracker for external observation of an outgoing message's status.
+    ///
+    void initialize(unsigned int sequence_number, bool receipt_required, message_status* tracker);
+
     // VARIABLES
     ///
     /// \brief m_message Stores the outgoing message.
     ///
-    message* m_message;
+    message m_message;
     ///
     /// \brief m_sequence_number Stores the originating sequence number of the outgoing message.
     ///
@@ -102,14 +177,38 @@ private:
     ///
     message_status* m_tracker;
     ///
+    /// \brief m_queue_timestamp Stores the time at which the message was queued.
+    ///
+    std::chrono::steady_clock::time_point m_queue_timestamp;
+    ///
     /// \brief m_transmit_timestamp Stores the last time in which the message was transmitted.
     ///
-    std::chrono::high_resolution_clock::time_point m_transmit_timestamp;
+    std::chrono::steady_clock::time_point m_transmit_timestamp;
     ///
     /// \brief m_n_transmissions Stores the total number of times the message has been transmitted.
     ///
     unsigned char m_n_transmissions;
+    ///
+    /// \brief m_link Stores the link that the message was last transmitted over.
+    ///
+    utility::link* m_link;
+    ///
+    /// \brief m_has_call Stores if the message belongs to a call.
+    ///
+    bool m_has_call;
+    ///
+    /// \brief m_call Stores the message's call field.
+    ///
+    unsigned short m_call;
+    ///
+    /// \brief m_journal_position Stores the position of the message in the journal, or m_not_journaled.
+    ///
+    unsigned long long m_journal_position;
 };
 }}
 
+#ifdef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/outbound.inl"
+#endif
+
 #endif // OUTBOUND_H
@@ -0,0 +1,83 @@
+/// \file reed_solomon.h
+/// \brief Defines the serial_communicator::utility::reed_solomon class.
+#ifndef REED_SOLOMON_H
+#define REED_SOLOMON_H
+
+#include <sys/uio.h>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief Encodes and decodes Reed-Solomon codewords over bytes, for forward error correction.
+/// \details Codewords are systematic: the data is followed by its parity bytes, and may be shortened to any length
+/// up to 255 bytes.  A codeword with n parity bytes is corrected from up to n / 2 bytes in error, in any positions
+/// and with any number of flipped bits in each.
+///
+class reed_solomon
+{
+public:
+    // CONSTANTS
+    ///
+    /// \brief m_max_codeword_length The longest codeword in bytes, including its parity.
+    ///
+    static const unsigned int m_max_codeword_length = 255;
+    ///
+    /// \brief m_max_parity The largest number of parity bytes in a codeword.
+    ///
+    static const unsigned int m_max_parity = 64;
+
+    // METHODS
+    ///
+    /// \brief encode Calculates the parity of a codeword.
+    /// \param segments The segments of the codeword's data, in order.
+    /// \param n_segments The number of segments.
+    /// \param n_parity The number of parity bytes, up to m_max_parity.
+    /// \param parity Outputs the parity bytes.
+    /// \details The data and parity together must be no longer than m_max_codeword_length.
+    ///
+    static void encode(const iovec* segments, unsigned int n_segments, unsigned int n_parity, unsigned char* parity);
+    ///
+    /// \brief decode Corrects a codeword in place.
+    /// \param codeword The data of the codeword, followed by its parity.
+    /// \param length The length of the codeword in bytes, including its parity.
+    /// \param n_parity The number of parity bytes, up to m_max_parity.
+    /// \return The number of bytes corrected, or -1 if there were too many errors to correct.  The codeword is only
+    /// changed if it was corrected.
+    ///
+    static int decode(unsigned char* codeword, unsigned int length, unsigned int n_parity);
+
+private:
+    // STRUCTURES
+    ///
+    /// \brief The arithmetic tables of the byte field, and the generator polynomial of each number of parity bytes.
+    ///
+    struct field
+    {
+        ///
+        /// \brief field Builds the tables.
+        ///
+        field();
+        ///
+        /// \brief exp Stores the powers of the field's generator, twice over so that sums of logarithms need no reduction.
+        ///
+        unsigned char exp[512];
+        ///
+        /// \brief log Stores the logarithm of each non-zero byte.
+        ///
+        unsigned int log[256];
+        ///
+        /// \brief generators Stores the generator polynomial of each number of parity bytes, highest power first.
+        ///
+        unsigned char generators[m_max_parity + 1][m_max_parity + 1];
+    };
+
+    // METHODS
+    ///
+    /// \brief tables Gets the tables, which are built on first use.
+    /// \return The tables.
+    ///
+    static const field& tables();
+};
+}}
+
+#endif // REED_SOLOMON_H
@@ -0,0 +1,116 @@
+/// \file rx_buffer.h
+/// \brief Defines the serial_communicator::utility::rx_buffer class.
+#ifndef RX_BUFFER_H
+#define RX_BUFFER_H
+
+#include <atomic>
+
+namespace serial_communicator {
+namespace utility {
+///
+/// \brief A reference counted buffer that holds a single received packet.
+/// \details Buffers are obtained with acquire() and returned with release() once every holder is finished with
+/// them.  Released buffers are kept in a shared pool and handed out again by later acquisitions, so that steady
+/// state reception does not allocate.
+///
+class rx_buffer
+{
+public:
+    // FACTORIES
+    ///
+    /// \brief acquire Acquires a buffer with room for a packet.
+    /// \param length The length of the packet in bytes.
+    /// \return A buffer of at least the requested length, holding a single reference.
+    ///
+    static rx_buffer* acquire(unsigned int length);
+
+    // METHODS
+    ///
+    /// \brief retain Adds a reference to the buffer.
+    ///
+    void retain();
+    ///
+    /// \brief release Removes a reference from the buffer.
+    /// \details When the last reference is removed, the buffer is returned to the pool and must no longer be used.
+    ///
+    void release();
+
+    // PROPERTIES
+    ///
+    /// \brief p_data Gets the buffer's bytes.
+    /// \return A pointer to the buffer's bytes.
+    ///
+    unsigned char* p_data();
+    ///
+    /// \brief p_data Gets the buffer's bytes.
+    /// \return A pointer to the buffer's bytes.
+    ///
+    const unsigned char* p_data() const;
+    ///
+    /// \brief p_length Gets the length of the packet held in the buffer.
+    /// \return The length of the packet in bytes.
+    ///
+    unsigned int p_length() const;
+    ///
+    /// \brief p_source Gets the bus node that the packet was sent from.
+    /// \return The source node, or 0xFF if the packet was not addressed.
+    ///
+    unsigned char p_source() const;
+    ///
+    /// \brief p_destination Gets the bus node that the packet was sent to.
+    /// \return The destination node, or 0xFF if the packet was broadcast or not addressed.
+    ///
+    unsigned char p_destination() const;
+    ///
+    /// \brief p_addresses Sets the bus nodes that the packet was sent from and to.
+    /// \param source The source node.
+    /// \param destination The destination node.
+    ///
+    void p_addresses(unsigned char source, unsigned char destination);
+
+private:
+    // CONSTRUCTORS
+    rx_buffer(unsigned int capacity);
+    ~rx_buffer();
+
+    // STRUCTURES
+    ///
+    /// \brief Holds released buffers for reuse.
+    ///
+    struct pool;
+    ///
+    /// \brief instance Gets the shared pool of released buffers.
+    /// \return The shared pool.
+    ///
+    static pool& instance();
+
+    // VARIABLES
+    ///
+    /// \brief m_data Stores the buffer's bytes.
+    ///
+    unsigned char* m_data;
+    ///
+    /// \brief m_capacity Stores the allocated size of the buffer in bytes.
+    ///
+    unsigned int m_capacity;
+    ///
+    /// \brief m_length Stores the length of the packet held in the buffer.
+    ///
+    unsigned int m_length;
+    ///
+    /// \brief m_source Stores the bus node that the packet was sent from.
+    ///
+    unsigned char m_source;
+    ///
+    /// \brief m_destination Stores the bus node that the packet was sent to.
+    ///
+    unsigned char m_destination;
+    ///
+    /// \brief m_references Stores the number of holders of the buffer.
+    ///
+    std::atomic<unsigned int> m_references;
+};
+
+}}
+
+#endif // RX_BUFFER_H
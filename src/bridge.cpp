@@ -0,0 +1,368 @@
+#include "serial_communicator/bridge.h"
+
+#include <pluginlib/class_list_macros.h>
+
+#include <chrono>
+#include <exception>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+bridge::bridge()
+{
+    bridge::m_communicator = nullptr;
+    bridge::m_diagnostics = nullptr;
+    bridge::m_diagnostics_period = 0;
+    bridge::m_running = false;
+}
+bridge::~bridge()
+{
+    // Stop the thread, and release any services waiting for a response.
+    bridge::m_running = false;
+    bridge::m_responses_condition.notify_all();
+    if(bridge::m_thread.joinable())
+    {
+        bridge::m_thread.join();
+    }
+
+    // Clean up services, diagnostics, and the communicator.
+    for(unsigned int i = 0; i < bridge::m_services.size(); i++)
+    {
+        delete bridge::m_services[i];
+    }
+    delete bridge::m_diagnostics;
+    delete bridge::m_communicator;
+}
+
+// METHODS
+void bridge::onInit()
+{
+    ros::NodeHandle& private_node = bridge::getPrivateNodeHandle();
+
+    if(!bridge::create_communicator(private_node))
+    {
+        return;
+    }
+
+    // Set up diagnostics.  They are published from the thread that spins the communicator.
+    private_node.param<double>("diagnostics_period", bridge::m_diagnostics_period, 1.0);
+    if(bridge::m_diagnostics_period > 0)
+    {
+        bridge::m_diagnostics = new diagnostics(bridge::getNodeHandle(), bridge::getName());
+    }
+
+    bridge::create_publishers(private_node);
+    bridge::create_subscribers(private_node);
+    bridge::create_services(private_node);
+
+    // Start the thread.
+    bridge::m_running = true;
+    bridge::m_thread = std::thread(&bridge::worker, this);
+}
+bool bridge::create_communicator(ros::NodeHandle& node_handle)
+{
+    int data_bits = node_handle.param<int>("data_bits", 8);
+    int parity_bits = node_handle.param<int>("parity_bits", 0);
+    int stop_bits = node_handle.param<int>("stop_bits", 1);
+
+    // A single port is given by port and baud, and a bonded set of ports by ports and bauds.
+    try
+    {
+        std::vector<std::string> ports;
+        std::vector<int> bauds;
+        std::string port;
+        if(node_handle.getParam("ports", ports) && node_handle.getParam("bauds", bauds))
+        {
+            bridge::m_communicator = new communicator(ports, std::vector<unsigned int>(bauds.begin(), bauds.end()), data_bits, parity_bits, stop_bits);
+        }
+        else if(node_handle.getParam("port", port))
+        {
+            bridge::m_communicator = new communicator(port, node_handle.param<int>("baud", 115200), data_bits, parity_bits, stop_bits);
+        }
+        else
+        {
+            NODELET_FATAL("no port or ports parameter was given");
+            return false;
+        }
+    }
+    catch(const std::exception& error)
+    {
+        NODELET_FATAL("failed to open communicator: %s", error.what());
+        return false;
+    }
+
+    // Apply optional settings.
+    int value;
+    if(node_handle.getParam("queue_size", value))
+    {
+        bridge::m_communicator->p_queue_size(static_cast<unsigned short>(value));
+    }
+    if(node_handle.getParam("receipt_timeout", value))
+    {
+        bridge::m_communicator->p_receipt_timeout(static_cast<unsigned int>(value));
+    }
+    if(node_handle.getParam("max_transmissions", value))
+    {
+        bridge::m_communicator->p_max_transmissions(static_cast<unsigned char>(value));
+    }
+    bridge::m_communicator->p_timestamps(node_handle.param<bool>("timestamps", false));
+    std::vector<int> negotiate_bauds;
+    if(node_handle.getParam("negotiate_bauds", negotiate_bauds))
+    {
+        if(!bridge::m_communicator->start_negotiation(std::vector<unsigned int>(negotiate_bauds.begin(), negotiate_bauds.end())))
+        {
+            NODELET_WARN("baud rate negotiation is not supported by the communicator's transports");
+        }
+    }
+
+    return true;
+}
+void bridge::create_publishers(ros::NodeHandle& node_handle)
+{
+    XmlRpc::XmlRpcValue list;
+    if(!node_handle.getParam("publishers", list))
+    {
+        return;
+    }
+    if(list.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+        NODELET_ERROR("publishers parameter must be a list");
+        return;
+    }
+
+    for(int i = 0; i < list.size(); i++)
+    {
+        int id;
+        std::string topic;
+        int queue_size = 10;
+        if(!bridge::member(list[i], "id", id) || !bridge::member(list[i], "topic", topic))
+        {
+            NODELET_ERROR("publisher %d must have an id and a topic", i);
+            continue;
+        }
+        bridge::member(list[i], "queue_size", queue_size);
+
+        bridge::m_publishers[static_cast<unsigned short>(id)] = bridge::getNodeHandle().advertise<RawMessage>(topic, queue_size);
+    }
+}
+void bridge::create_subscribers(ros::NodeHandle& node_handle)
+{
+    XmlRpc::XmlRpcValue list;
+    if(!node_handle.getParam("subscribers", list))
+    {
+        return;
+    }
+    if(list.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+        NODELET_ERROR("subscribers parameter must be a list");
+        return;
+    }
+
+    for(int i = 0; i < list.size(); i++)
+    {
+        int id;
+        std::string topic;
+        int queue_size = 10;
+        bool receipt_required = false;
+        if(!bridge::member(list[i], "id", id) || !bridge::member(list[i], "topic", topic))
+        {
+            NODELET_ERROR("subscriber %d must have an id and a topic", i);
+            continue;
+        }
+        bridge::member(list[i], "queue_size", queue_size);
+        bridge::member(list[i], "receipt_required", receipt_required);
+
+        subscription subscription;
+        subscription.id = static_cast<unsigned short>(id);
+        subscription.receipt_required = receipt_required;
+        bridge::m_subscribers.push_back(bridge::getNodeHandle().subscribe<RawMessage>(topic, queue_size, boost::bind(&bridge::forward, this, _1, subscription)));
+    }
+}
+void bridge::create_services(ros::NodeHandle& node_handle)
+{
+    XmlRpc::XmlRpcValue list;
+    if(!node_handle.getParam("services", list))
+    {
+        return;
+    }
+    if(list.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+        NODELET_ERROR("services parameter must be a list");
+        return;
+    }
+
+    for(int i = 0; i < list.size(); i++)
+    {
+        int request_id;
+        int response_id;
+        int timeout = 1000;
+        std::string name;
+        if(!bridge::member(list[i], "request_id", request_id) || !bridge::member(list[i], "response_id", response_id) || !bridge::member(list[i], "service", name))
+        {
+            NODELET_ERROR("service %d must have a request_id, a response_id, and a service", i);
+            continue;
+        }
+        bridge::member(list[i], "timeout", timeout);
+
+        // Responses are matched by ID alone, so each response ID may only belong to one service.
+        bool duplicate = false;
+        for(unsigned int j = 0; j < bridge::m_services.size(); j++)
+        {
+            duplicate = duplicate || bridge::m_services[j]->response_id == response_id;
+        }
+        if(duplicate)
+        {
+            NODELET_ERROR("service %s shares response ID %d with another service", name.c_str(), response_id);
+            continue;
+        }
+
+        service* new_service = new service();
+        new_service->request_id = static_cast<unsigned short>(request_id);
+        new_service->response_id = static_cast<unsigned short>(response_id);
+        new_service->timeout = static_cast<unsigned int>(timeout);
+        // Calls block until the response arrives, so they are handled on the multi-threaded queue.
+        new_service->server = bridge::getMTNodeHandle().advertiseService<Transaction::Request, Transaction::Response>(name, boost::bind(&bridge::call, this, _1, _2, new_service));
+        bridge::m_services.push_back(new_service);
+    }
+}
+void bridge::worker()
+{
+    std::chrono::steady_clock::time_point diagnostics_timestamp = std::chrono::steady_clock::now();
+
+    while(bridge::m_running)
+    {
+        // Spin whenever work is pending, and periodically so that timed duties are never missed.
+        bridge::m_communicator->wait(100);
+        bridge::m_communicator->spin();
+
+        // Route all received messages.
+        std::chrono::steady_clock::time_point timestamp;
+        for(message_view view = bridge::m_communicator->receive_view(timestamp); view.p_valid(); view = bridge::m_communicator->receive_view(timestamp))
+        {
+            bridge::route(view, timestamp);
+        }
+
+        // Publish diagnostics.
+        if(bridge::m_diagnostics && std::chrono::duration<double>(std::chrono::steady_clock::now() - diagnostics_timestamp).count() >= bridge::m_diagnostics_period)
+        {
+            bridge::m_diagnostics->publish(bridge::m_communicator->p_statistics());
+            diagnostics_timestamp = std::chrono::steady_clock::now();
+        }
+    }
+}
+void bridge::route(const message_view& view, std::chrono::steady_clock::time_point timestamp)
+{
+    // Hand the message to a service if one is waiting for it.
+    {
+        std::lock_guard<std::mutex> responses_lock(bridge::m_responses_mutex);
+        auto response = bridge::m_responses.find(view.p_id());
+        if(response != bridge::m_responses.end() && !response->second.p_valid())
+        {
+            response->second = view;
+            bridge::m_responses_condition.notify_all();
+            return;
+        }
+    }
+
+    auto publisher = bridge::m_publishers.find(view.p_id());
+    if(publisher == bridge::m_publishers.end())
+    {
+        NODELET_WARN_THROTTLE(10, "received message with unmapped ID %u", view.p_id());
+        return;
+    }
+
+    // Publish by shared pointer, so that the data is only copied out of the receive buffer here.
+    RawMessage::Ptr output = boost::make_shared<RawMessage>();
+    // Stamp with the time the message was sent, carried from the steady clock into ROS time.
+    output->stamp = ros::Time::now() - ros::Duration(std::chrono::duration<double>(std::chrono::steady_clock::now() - timestamp).count());
+    output->id = view.p_id();
+    output->priority = view.p_priority();
+    output->data.resize(view.p_data_length());
+    view.get_bytes(0, output->data.data(), view.p_data_length());
+    publisher->second.publish(output);
+}
+void bridge::forward(const RawMessage::ConstPtr& input, subscription subscription)
+{
+    if(input->data.size() > 0xFFFF)
+    {
+        NODELET_ERROR_THROTTLE(10, "dropped message for ID %u with %lu bytes of data", subscription.id, input->data.size());
+        return;
+    }
+
+    message output(subscription.id, static_cast<unsigned short>(input->data.size()));
+    output.p_priority(input->priority);
+    output.set_bytes(0, input->data.data(), output.p_data_length());
+    if(!bridge::m_communicator->send(std::move(output), subscription.receipt_required))
+    {
+        NODELET_WARN_THROTTLE(10, "dropped message for ID %u because the transmit queue is full", subscription.id);
+    }
+}
+bool bridge::call(Transaction::Request& request, Transaction::Response& response, service* service)
+{
+    std::lock_guard<std::mutex> call_lock(service->mutex);
+
+    response.success = false;
+    if(request.data.size() > 0xFFFF)
+    {
+        NODELET_ERROR("request for service ID %u has %lu bytes of data", service->request_id, request.data.size());
+        return false;
+    }
+
+    // Wait for the response before sending, so that a fast response is not published instead.
+    {
+        std::lock_guard<std::mutex> responses_lock(bridge::m_responses_mutex);
+        bridge::m_responses[service->response_id] = message_view();
+    }
+
+    message output(service->request_id, static_cast<unsigned short>(request.data.size()));
+    output.p_priority(request.priority);
+    output.set_bytes(0, request.data.data(), output.p_data_length());
+    bool sent = bridge::m_communicator->send(std::move(output), true);
+
+    std::unique_lock<std::mutex> responses_lock(bridge::m_responses_mutex);
+    if(sent)
+    {
+        message_view& awaited = bridge::m_responses[service->response_id];
+        bridge::m_responses_condition.wait_for(responses_lock, std::chrono::milliseconds(service->timeout), [&]{return awaited.p_valid() || !bridge::m_running;});
+    }
+    message_view reply = bridge::m_responses[service->response_id];
+    bridge::m_responses.erase(service->response_id);
+    responses_lock.unlock();
+
+    if(reply.p_valid())
+    {
+        response.success = true;
+        response.data.resize(reply.p_data_length());
+        reply.get_bytes(0, response.data.data(), reply.p_data_length());
+    }
+    return true;
+}
+bool bridge::member(XmlRpc::XmlRpcValue& entry, const std::string& name, int& value) const
+{
+    if(entry.getType() != XmlRpc::XmlRpcValue::TypeStruct || !entry.hasMember(name) || entry[name].getType() != XmlRpc::XmlRpcValue::TypeInt)
+    {
+        return false;
+    }
+    value = static_cast<int>(entry[name]);
+    return true;
+}
+bool bridge::member(XmlRpc::XmlRpcValue& entry, const std::string& name, bool& value) const
+{
+    if(entry.getType() != XmlRpc::XmlRpcValue::TypeStruct || !entry.hasMember(name) || entry[name].getType() != XmlRpc::XmlRpcValue::TypeBoolean)
+    {
+        return false;
+    }
+    value = static_cast<bool>(entry[name]);
+    return true;
+}
+bool bridge::member(XmlRpc::XmlRpcValue& entry, const std::string& name, std::string& value) const
+{
+    if(entry.getType() != XmlRpc::XmlRpcValue::TypeStruct || !entry.hasMember(name) || entry[name].getType() != XmlRpc::XmlRpcValue::TypeString)
+    {
+        return false;
+    }
+    value = static_cast<std::string>(entry[name]);
+    return true;
+}
+
+PLUGINLIB_EXPORT_CLASS(serial_communicator::bridge, nodelet::Nodelet)
@@ -0,0 +1,166 @@
+#include "serial_communicator/utility/byte_order.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTE_ORDER_X86
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace serial_communicator::utility;
+
+namespace {
+// Swaps each value in a block one at a time.
+template <unsigned int SIZE>
+void swap_scalar(unsigned char* output, const unsigned char* input, unsigned long count)
+{
+    for(unsigned long i = 0; i < count; i++)
+    {
+        typename byte_order<SIZE>::type value;
+        std::memcpy(&value, input + i * SIZE, SIZE);
+        value = byte_order<SIZE>::from_big_endian(value);
+        std::memcpy(output + i * SIZE, &value, SIZE);
+    }
+}
+
+#ifdef BYTE_ORDER_X86
+// Gets the byte shuffle that reverses each SIZE byte value within 16 bytes.
+template <unsigned int SIZE>
+__attribute__((target("ssse3")))
+__m128i shuffle_mask()
+{
+    char mask[16];
+    for(unsigned int i = 0; i < 16; i++)
+    {
+        mask[i] = static_cast<char>((i / SIZE) * SIZE + (SIZE - 1 - i % SIZE));
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+// Swaps a block 16 bytes at a time.
+template <unsigned int SIZE>
+__attribute__((target("ssse3")))
+void swap_ssse3(unsigned char* output, const unsigned char* input, unsigned long count)
+{
+    const __m128i mask = shuffle_mask<SIZE>();
+    const unsigned long per_vector = 16 / SIZE;
+    unsigned long i = 0;
+    for(; i + per_vector <= count; i += per_vector)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * SIZE));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * SIZE), _mm_shuffle_epi8(block, mask));
+    }
+    swap_scalar<SIZE>(output + i * SIZE, input + i * SIZE, count - i);
+}
+
+// Swaps a block 32 bytes at a time.
+template <unsigned int SIZE>
+__attribute__((target("avx2")))
+void swap_avx2(unsigned char* output, const unsigned char* input, unsigned long count)
+{
+    // The shuffle works within each 128 bit lane, so the same mask is used for both.
+    const __m128i lane_mask = shuffle_mask<SIZE>();
+    const __m256i mask = _mm256_broadcastsi128_si256(lane_mask);
+    const unsigned long per_vector = 32 / SIZE;
+    unsigned long i = 0;
+    for(; i + per_vector <= count; i += per_vector)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i * SIZE));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i * SIZE), _mm256_shuffle_epi8(block, mask));
+    }
+    swap_scalar<SIZE>(output + i * SIZE, input + i * SIZE, count - i);
+}
+#elif defined(__ARM_NEON)
+// Swaps a block 16 bytes at a time.
+template <unsigned int SIZE>
+void swap_neon(unsigned char* output, const unsigned char* input, unsigned long count)
+{
+    const unsigned long per_vector = 16 / SIZE;
+    unsigned long i = 0;
+    for(; i + per_vector <= count; i += per_vector)
+    {
+        uint8x16_t block = vld1q_u8(input + i * SIZE);
+        switch(SIZE)
+        {
+        case 2:
+            block = vrev16q_u8(block);
+            break;
+        case 4:
+            block = vrev32q_u8(block);
+            break;
+        case 8:
+            block = vrev64q_u8(block);
+            break;
+        }
+        vst1q_u8(output + i * SIZE, block);
+    }
+    swap_scalar<SIZE>(output + i * SIZE, input + i * SIZE, count - i);
+}
+#endif
+
+// Stores the swap kernel for each value size.
+struct kernel_set
+{
+    void (*size_2)(unsigned char*, const unsigned char*, unsigned long);
+    void (*size_4)(unsigned char*, const unsigned char*, unsigned long);
+    void (*size_8)(unsigned char*, const unsigned char*, unsigned long);
+};
+
+// Selects the fastest kernels that the processor supports.
+kernel_set select_kernels()
+{
+#ifdef BYTE_ORDER_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return {swap_avx2<2>, swap_avx2<4>, swap_avx2<8>};
+    }
+    if(__builtin_cpu_supports("ssse3"))
+    {
+        return {swap_ssse3<2>, swap_ssse3<4>, swap_ssse3<8>};
+    }
+#elif defined(__ARM_NEON)
+    return {swap_neon<2>, swap_neon<4>, swap_neon<8>};
+#endif
+    return {swap_scalar<2>, swap_scalar<4>, swap_scalar<8>};
+}
+}
+
+void serial_communicator::utility::convert_big_endian(unsigned char* output, const unsigned char* input, unsigned int size, unsigned long count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+#if __BYTE_ORDER == __BIG_ENDIAN
+    // The host is already big endian.
+    size = 1;
+#endif
+    static const kernel_set kernels = select_kernels();
+    switch(size)
+    {
+    case 1:
+    {
+        if(output != input)
+        {
+            std::memmove(output, input, count);
+        }
+        break;
+    }
+    case 2:
+    {
+        kernels.size_2(output, input, count);
+        break;
+    }
+    case 4:
+    {
+        kernels.size_4(output, input, count);
+        break;
+    }
+    case 8:
+    {
+        kernels.size_8(output, input, count);
+        break;
+    }
+    }
+}
@@ -0,0 +1,196 @@
+#include "serial_communicator/utility/capture.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace serial_communicator::utility;
+
+namespace {
+// Identifies capture files.
+const char capture_magic[8] = {'S', 'C', 'C', 'A', 'P', '0', '0', '1'};
+
+// Rounds a length up to the record alignment.
+unsigned long long align(unsigned long long length)
+{
+    return (length + 7) & ~7ULL;
+}
+}
+
+// CONSTRUCTORS
+capture::capture(std::string path, unsigned long size)
+{
+    // Create and size the file.
+    unsigned long long capacity = align(size);
+    capture::m_map_size = sizeof(file_header) + capacity;
+    capture::m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(capture::m_fd < 0 || ftruncate(capture::m_fd, static_cast<off_t>(capture::m_map_size)) < 0)
+    {
+        throw std::runtime_error("failed to create capture file " + path);
+    }
+
+    // Map the file.
+    void* map = mmap(nullptr, capture::m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, capture::m_fd, 0);
+    if(map == MAP_FAILED)
+    {
+        close(capture::m_fd);
+        throw std::runtime_error("failed to map capture file " + path);
+    }
+    capture::m_header = static_cast<file_header*>(map);
+    capture::m_ring = static_cast<unsigned char*>(map) + sizeof(file_header);
+
+    // Initialize the header.
+    std::memcpy(capture::m_header->magic, capture_magic, sizeof(capture_magic));
+    capture::m_header->capacity = capacity;
+    capture::m_header->head = 0;
+    capture::m_header->used = 0;
+}
+capture::~capture()
+{
+    msync(capture::m_header, capture::m_map_size, MS_ASYNC);
+    munmap(capture::m_header, capture::m_map_size);
+    close(capture::m_fd);
+}
+
+// METHODS
+void capture::record(direction direction, unsigned char link, const unsigned char* packet, unsigned int length)
+{
+    unsigned long long capacity = capture::m_header->capacity;
+    unsigned long long size = align(sizeof(record_header) + length);
+    if(size > capacity)
+    {
+        // The packet can never fit.
+        return;
+    }
+
+    // Find the write position, wrapping to the start of the ring if the record does not fit before the end.
+    unsigned long long position = (capture::m_header->head + capture::m_header->used) % capacity;
+    if(capacity - position < size)
+    {
+        unsigned long long skip = capacity - position;
+        capture::make_room(skip);
+        if(skip >= sizeof(unsigned int))
+        {
+            unsigned int marker = capture::m_wrap_marker;
+            std::memcpy(&capture::m_ring[position], &marker, sizeof(marker));
+        }
+        capture::m_header->used += skip;
+        position = 0;
+    }
+    capture::make_room(size);
+
+    // Write the record.
+    record_header header;
+    header.length = length;
+    header.direction = static_cast<unsigned char>(direction);
+    header.link = link;
+    header.reserved = 0;
+    header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::memcpy(&capture::m_ring[position], &header, sizeof(header));
+    std::memcpy(&capture::m_ring[position + sizeof(header)], packet, length);
+
+    // Publish the record after it has been written.
+    capture::m_header->used += size;
+}
+bool capture::load(std::string path, std::vector<frame>& frames)
+{
+    // Open and map the file.
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) < 0 || static_cast<unsigned long>(file_stat.st_size) < sizeof(file_header))
+    {
+        close(fd);
+        return false;
+    }
+    unsigned long map_size = static_cast<unsigned long>(file_stat.st_size);
+    void* map = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // Validate the header.
+    const file_header* header = static_cast<const file_header*>(map);
+    const unsigned char* ring = static_cast<const unsigned char*>(map) + sizeof(file_header);
+    bool valid = std::memcmp(header->magic, capture_magic, sizeof(capture_magic)) == 0 &&
+                 header->capacity <= map_size - sizeof(file_header) &&
+                 header->head < header->capacity && header->used <= header->capacity;
+
+    // Walk the records from oldest to newest.
+    unsigned long long offset = header->head;
+    unsigned long long remaining = valid ? header->used : 0;
+    while(remaining > 0)
+    {
+        unsigned long long size = capture::record_size(ring, header->capacity, offset);
+        if(size > remaining)
+        {
+            valid = false;
+            break;
+        }
+        if(header->capacity - offset >= sizeof(record_header))
+        {
+            record_header record;
+            std::memcpy(&record, &ring[offset], sizeof(record));
+            if(record.length != capture::m_wrap_marker)
+            {
+                // Guard against a corrupted length, which record_size can not report.
+                if(sizeof(record_header) + record.length > header->capacity - offset || sizeof(record_header) + record.length > remaining)
+                {
+                    valid = false;
+                    break;
+                }
+                frame output;
+                output.timestamp = record.timestamp;
+                output.direction = static_cast<direction>(record.direction);
+                output.link = record.link;
+                output.bytes.assign(&ring[offset + sizeof(record)], &ring[offset + sizeof(record) + record.length]);
+                frames.push_back(output);
+            }
+        }
+        offset = (offset + size) % header->capacity;
+        remaining -= size;
+    }
+
+    munmap(map, map_size);
+    return valid;
+}
+
+// PRIVATE METHODS
+void capture::make_room(unsigned long long length)
+{
+    unsigned long long capacity = capture::m_header->capacity;
+    while(capacity - capture::m_header->used < length)
+    {
+        // Drop the oldest record.
+        unsigned long long size = capture::record_size(capture::m_ring, capacity, capture::m_header->head);
+        capture::m_header->head = (capture::m_header->head + size) % capacity;
+        capture::m_header->used -= size;
+    }
+}
+unsigned long long capture::record_size(const unsigned char* ring, unsigned long long capacity, unsigned long long offset)
+{
+    // Records never straddle the end of the ring, so a short remainder or marker means the ring wraps here.
+    unsigned long long remainder = capacity - offset;
+    if(remainder < sizeof(record_header))
+    {
+        return remainder;
+    }
+    unsigned int length;
+    std::memcpy(&length, &ring[offset], sizeof(length));
+    if(length == capture::m_wrap_marker)
+    {
+        return remainder;
+    }
+    unsigned long long size = align(sizeof(record_header) + length);
+    // Guard against a corrupted length.
+    return size <= remainder ? size : remainder;
+}
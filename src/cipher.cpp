@@ -0,0 +1,116 @@
+#include "serial_communicator/utility/cipher.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <chrono>
+#include <cstring>
+#include <endian.h>
+#include <stdexcept>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+cipher::cipher(serial_communicator::encryption algorithm, const std::vector<unsigned char>& key)
+{
+    if(key.size() != cipher::m_key_length)
+    {
+        throw std::invalid_argument("cipher key must be 32 bytes");
+    }
+
+    // Set up a context in each direction, so that only the nonce changes from packet to packet.
+    const EVP_CIPHER* evp_cipher = algorithm == serial_communicator::encryption::AES_256_GCM ? EVP_aes_256_gcm() : EVP_chacha20_poly1305();
+    cipher::m_encrypt = EVP_CIPHER_CTX_new();
+    cipher::m_decrypt = EVP_CIPHER_CTX_new();
+    if(cipher::m_encrypt == nullptr || cipher::m_decrypt == nullptr ||
+       EVP_EncryptInit_ex(cipher::m_encrypt, evp_cipher, nullptr, key.data(), nullptr) != 1 ||
+       EVP_DecryptInit_ex(cipher::m_decrypt, evp_cipher, nullptr, key.data(), nullptr) != 1)
+    {
+        EVP_CIPHER_CTX_free(cipher::m_encrypt);
+        EVP_CIPHER_CTX_free(cipher::m_decrypt);
+        throw std::runtime_error("cipher could not be initialized");
+    }
+
+    // Peers sharing the key count through the same range, so only the salt keeps their nonces apart.  It must not
+    // come from a generator that processes seed alike.
+    unsigned char salt[4];
+    if(RAND_bytes(salt, sizeof(salt)) != 1)
+    {
+        EVP_CIPHER_CTX_free(cipher::m_encrypt);
+        EVP_CIPHER_CTX_free(cipher::m_decrypt);
+        throw std::runtime_error("cipher salt could not be generated");
+    }
+    std::memcpy(&(cipher::m_salt), salt, sizeof(salt));
+
+    // Start the counter at the wall clock time so that it keeps increasing across restarts.
+    cipher::m_counter = static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    for(unsigned int i = 0; i < 256; i++)
+    {
+        cipher::m_windows[i].valid = false;
+        cipher::m_windows[i].highest = 0;
+        cipher::m_windows[i].received = 0;
+    }
+}
+cipher::~cipher()
+{
+    EVP_CIPHER_CTX_free(cipher::m_encrypt);
+    EVP_CIPHER_CTX_free(cipher::m_decrypt);
+}
+
+// METHODS
+void cipher::seal(const unsigned char* aad, unsigned int aad_length, const iovec* segments, unsigned int n_segments, unsigned char* ciphertext, unsigned char* nonce, unsigned char* tag)
+{
+    // The nonce is the salt followed by the counter, both big endian.
+    unsigned int be_salt = htobe32(cipher::m_salt);
+    unsigned long long be_counter = htobe64(cipher::m_counter++);
+    std::memcpy(&nonce[0], &be_salt, 4);
+    std::memcpy(&nonce[4], &be_counter, 8);
+
+    int n_written = 0;
+    EVP_EncryptInit_ex(cipher::m_encrypt, nullptr, nullptr, nullptr, nonce);
+    EVP_EncryptUpdate(cipher::m_encrypt, nullptr, &n_written, aad, static_cast<int>(aad_length));
+    unsigned int position = 0;
+    for(unsigned int i = 0; i < n_segments; i++)
+    {
+        EVP_EncryptUpdate(cipher::m_encrypt, &ciphertext[position], &n_written, static_cast<const unsigned char*>(segments[i].iov_base), static_cast<int>(segments[i].iov_len));
+        position += static_cast<unsigned int>(n_written);
+    }
+    EVP_EncryptFinal_ex(cipher::m_encrypt, &ciphertext[position], &n_written);
+    EVP_CIPHER_CTX_ctrl(cipher::m_encrypt, EVP_CTRL_AEAD_GET_TAG, cipher::m_tag_length, tag);
+}
+bool cipher::open(const unsigned char* aad, unsigned int aad_length, unsigned char* data, unsigned int length, const unsigned char* nonce, const unsigned char* tag)
+{
+    int n_written = 0;
+    unsigned char expected_tag[cipher::m_tag_length];
+    std::memcpy(expected_tag, tag, cipher::m_tag_length);
+    EVP_DecryptInit_ex(cipher::m_decrypt, nullptr, nullptr, nullptr, nonce);
+    EVP_DecryptUpdate(cipher::m_decrypt, nullptr, &n_written, aad, static_cast<int>(aad_length));
+    EVP_DecryptUpdate(cipher::m_decrypt, data, &n_written, data, static_cast<int>(length));
+    EVP_CIPHER_CTX_ctrl(cipher::m_decrypt, EVP_CTRL_AEAD_SET_TAG, cipher::m_tag_length, expected_tag);
+    return EVP_DecryptFinal_ex(cipher::m_decrypt, data + n_written, &n_written) == 1;
+}
+bool cipher::accept(unsigned char source, const unsigned char* nonce)
+{
+    unsigned long long be_counter;
+    std::memcpy(&be_counter, &nonce[4], 8);
+    unsigned long long counter = be64toh(be_counter);
+
+    window& recent = cipher::m_windows[source];
+    if(recent.valid == false || counter > recent.highest)
+    {
+        // Slide the window up to the new highest counter.
+        unsigned long long shift = recent.valid ? counter - recent.highest : 64;
+        recent.received = shift >= 64 ? 1 : (recent.received << shift) | 1;
+        recent.highest = counter;
+        recent.valid = true;
+        return true;
+    }
+    unsigned long long age = recent.highest - counter;
+    if(age >= 64 || (recent.received & (1ULL << age)) != 0)
+    {
+        return false;
+    }
+    recent.received |= 1ULL << age;
+    return true;
+}
@@ -0,0 +1,143 @@
+#include "serial_communicator/utility/clock_sync.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+clock_sync::clock_sync()
+{
+    clock_sync::m_samples.reserve(clock_sync::m_max_samples);
+    clock_sync::m_position = 0;
+    clock_sync::m_reference = 0;
+    clock_sync::m_offset = 0;
+    clock_sync::m_drift = 0;
+    clock_sync::m_delay = 0;
+    clock_sync::m_latest = 0;
+}
+
+// METHODS
+void clock_sync::add_sample(std::chrono::steady_clock::time_point transmitted, long long remote_received, long long remote_transmitted, std::chrono::steady_clock::time_point received)
+{
+    long long t1 = clock_sync::to_remote(transmitted);
+    long long t4 = clock_sync::to_remote(received);
+
+    // The remote clock is assumed to sit midway through the round trip, less the time the remote end held the message.
+    sample current;
+    current.local = t1 + (t4 - t1) / 2;
+    current.offset = ((remote_received - t1) + (remote_transmitted - t4)) / 2;
+    current.delay = (t4 - t1) - (remote_transmitted - remote_received);
+    if(current.delay < 0)
+    {
+        // Only possible if the remote times are nonsense.
+        return;
+    }
+
+    // Overwrite the oldest sample once full.
+    if(clock_sync::m_samples.size() < clock_sync::m_max_samples)
+    {
+        clock_sync::m_samples.push_back(current);
+    }
+    else
+    {
+        clock_sync::m_samples[clock_sync::m_position] = current;
+        clock_sync::m_position = (clock_sync::m_position + 1) % clock_sync::m_max_samples;
+    }
+    clock_sync::m_latest = current.local;
+
+    clock_sync::fit();
+}
+std::chrono::steady_clock::time_point clock_sync::to_local(long long remote) const
+{
+    // Solve local = remote - (offset + drift * (local - reference)) for local, relative to the reference.
+    double relative = static_cast<double>(remote - clock_sync::m_reference) - clock_sync::m_offset;
+    long long local = clock_sync::m_reference + static_cast<long long>(std::llround(relative / (1.0 + clock_sync::m_drift)));
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::microseconds(local)));
+}
+long long clock_sync::to_remote(std::chrono::steady_clock::time_point local)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(local.time_since_epoch()).count();
+}
+
+// PROPERTIES
+bool clock_sync::p_synchronized() const
+{
+    return !clock_sync::m_samples.empty();
+}
+long long clock_sync::p_offset() const
+{
+    return static_cast<long long>(std::llround(clock_sync::m_offset + clock_sync::m_drift * static_cast<double>(clock_sync::m_latest - clock_sync::m_reference)));
+}
+double clock_sync::p_drift() const
+{
+    return clock_sync::m_drift * 1000000.0;
+}
+long long clock_sync::p_delay() const
+{
+    return clock_sync::m_delay;
+}
+
+// PRIVATE METHODS
+void clock_sync::fit()
+{
+    // Only use samples that were delayed little more than the fastest, which were least disturbed by queueing.
+    clock_sync::m_delay = clock_sync::m_samples.front().delay;
+    for(unsigned int i = 1; i < clock_sync::m_samples.size(); i++)
+    {
+        clock_sync::m_delay = std::min(clock_sync::m_delay, clock_sync::m_samples[i].delay);
+    }
+    long long max_delay = 2 * clock_sync::m_delay + clock_sync::m_delay_margin;
+
+    // Fit offset against local time about the mean local time, which keeps the sums small.
+    unsigned int n_used = 0;
+    long long first = 0;
+    long long last = 0;
+    double mean_local = 0;
+    double mean_offset = 0;
+    for(unsigned int i = 0; i < clock_sync::m_samples.size(); i++)
+    {
+        const sample& current = clock_sync::m_samples[i];
+        if(current.delay > max_delay)
+        {
+            continue;
+        }
+        if(n_used == 0)
+        {
+            first = current.local;
+            last = current.local;
+        }
+        first = std::min(first, current.local);
+        last = std::max(last, current.local);
+        n_used++;
+        // Accumulate relative to the latest sample to keep precision.
+        mean_local += static_cast<double>(current.local - clock_sync::m_latest);
+        mean_offset += static_cast<double>(current.offset);
+    }
+    mean_local /= n_used;
+    mean_offset /= n_used;
+
+    // Drift is only fit once the samples span enough time for it to stand out from the delay jitter.
+    double drift = 0;
+    if(n_used >= 4 && last - first >= clock_sync::m_min_fit_span)
+    {
+        double covariance = 0;
+        double variance = 0;
+        for(unsigned int i = 0; i < clock_sync::m_samples.size(); i++)
+        {
+            const sample& current = clock_sync::m_samples[i];
+            if(current.delay > max_delay)
+            {
+                continue;
+            }
+            double x = static_cast<double>(current.local - clock_sync::m_latest) - mean_local;
+            covariance += x * (static_cast<double>(current.offset) - mean_offset);
+            variance += x * x;
+        }
+        drift = std::max(-clock_sync::m_max_drift, std::min(clock_sync::m_max_drift, covariance / variance));
+    }
+
+    clock_sync::m_reference = clock_sync::m_latest + static_cast<long long>(std::llround(mean_local));
+    clock_sync::m_offset = mean_offset;
+    clock_sync::m_drift = drift;
+}
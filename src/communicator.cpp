@@ -1,4 +1,16 @@
 #include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/serial_transport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 
 using namespace serial_communicator;
 
@@ -6,32 +18,54 @@ using namespace serial_communicator;
 communicator::communicator(std::string port, unsigned int baud, unsigned int data_bits, unsigned int parity_bits, unsigned int stop_bits)
 {
     // Set up the serial port.
-    communicator::m_serial_port = new serial::Serial(port, baud, serial::Timeout::simpleTimeout(30),
-                                                     static_cast<serial::bytesize_t>(data_bits),
-                                                     static_cast<serial::parity_t>(parity_bits),
-                                                     static_cast<serial::stopbits_t>(stop_bits),
-                                                     serial::flowcontrol_t::flowcontrol_none);
-    communicator::m_serial_port->flush();
+    communicator::m_links.push_back(new utility::link(new serial_transport(port, baud, data_bits, parity_bits, stop_bits)));
 
-    // Initialize parameters to default values.
-    communicator::m_queue_size = 10;
-    communicator::m_receipt_timeout = 100;
-    communicator::m_max_transmissions = 5;
+    communicator::initialize();
+}
+communicator::communicator(std::vector<std::string> ports, std::vector<unsigned int> bauds, unsigned int data_bits, unsigned int parity_bits, unsigned int stop_bits)
+{
+    if(ports.empty() || ports.size() != bauds.size())
+    {
+        throw std::invalid_argument("bonded communicator requires one baud rate for each of one or more ports");
+    }
 
-    // Initialize sequence counter.
-    communicator::m_sequence_counter = 0;
+    // Set up a link for each serial port.
+    for(unsigned int i = 0; i < ports.size(); i++)
+    {
+        communicator::m_links.push_back(new utility::link(new serial_transport(ports[i], bauds[i], data_bits, parity_bits, stop_bits)));
+    }
 
-    // Initialize queues.
-    communicator::m_tx_queue = new utility::outbound*[communicator::m_queue_size];
-    communicator::m_rx_queue = new utility::inbound*[communicator::m_queue_size];
-    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    communicator::initialize();
+}
+communicator::communicator(serial_communicator::transport* transport)
+{
+    communicator::m_links.push_back(new utility::link(transport));
+
+    communicator::initialize();
+}
+communicator::communicator(std::vector<serial_communicator::transport*> transports)
+{
+    if(transports.empty())
     {
-        communicator::m_tx_queue[i] = nullptr;
-        communicator::m_rx_queue[i] = nullptr;
+        throw std::invalid_argument("bonded communicator requires one or more transports");
+    }
+
+    // Set up a link for each transport.
+    for(unsigned int i = 0; i < transports.size(); i++)
+    {
+        communicator::m_links.push_back(new utility::link(transports[i]));
     }
+
+    communicator::initialize();
 }
 communicator::~communicator()
 {
+    // Cancel outstanding calls.
+    for(auto pending = communicator::m_calls.begin(); pending != communicator::m_calls.end(); ++pending)
+    {
+        pending->second.callback(call_status::CANCELLED, message_view());
+    }
+
     // Clean up queues.
     for(unsigned short i = 0; i < communicator::m_queue_size; i++)
     {
@@ -47,14 +81,48 @@ communicator::~communicator()
     delete [] communicator::m_tx_queue;
     delete [] communicator::m_rx_queue;
 
-    // Clean up the serial port.
-    communicator::m_serial_port->close();
-    delete communicator::m_serial_port;
+    // Clean up the capture, journal, and cipher.  Closing the journal flushes it to disk.
+    delete communicator::m_capture;
+    delete communicator::m_journal;
+    delete communicator::m_cipher;
+
+    // Clean up event sources.
+    int event_fds[3] = {communicator::m_epoll_fd, communicator::m_queue_fd, communicator::m_timer_fd};
+    for(unsigned int i = 0; i < 3; i++)
+    {
+        if(event_fds[i] >= 0)
+        {
+            close(event_fds[i]);
+        }
+    }
+
+    // Clean up the links and their partially assembled packets.
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        delete communicator::m_readers[i];
+        delete communicator::m_links[i];
+    }
 }
 
 // PUBLIC METHODS
 bool communicator::send(message* message, bool receipt_required, message_status* tracker)
 {
+    if(receipt_required && message->p_node() == 0xFF && communicator::m_node != 0xFF)
+    {
+        delete message;
+        throw std::invalid_argument("broadcast messages can not require receipts");
+    }
+
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+
+    // Messages that require receipts are kept in the journal if there is one.
+    if(receipt_required && communicator::m_journal)
+    {
+        bool journaled = communicator::journal_message(std::move(*message), tracker);
+        delete message;
+        return journaled;
+    }
+
     // Find an open spot in the transmit queue.
     for(unsigned short i = 0; i < communicator::m_queue_size; i++)
     {
@@ -62,22 +130,118 @@ bool communicator::send(message* message, bool receipt_required, message_status*
         {
             // Open space found. Add outbound message and increment sequence counter.
             communicator::m_tx_queue[i] = new utility::outbound(message, communicator::m_sequence_counter++, receipt_required, tracker);
+            // Signal that transmit work is pending.
+            eventfd_write(communicator::m_queue_fd, 1);
             // Quit here.
             return true;
         }
     }
 
     // If this point reached, a spot was not found.
+    communicator::m_statistics.increment(statistics::counter::SEND_REJECTIONS);
     delete message;
     return false;
 }
+bool communicator::send(message&& message, bool receipt_required, message_status* tracker)
+{
+    return communicator::queue(std::move(message), receipt_required, tracker, false, 0);
+}
+bool communicator::call(message&& request, unsigned int timeout, std::function<void(call_status, const message_view&)> callback, bool receipt_required)
+{
+    // Register the call before queueing the request, so that the response can not arrive first.
+    unsigned short call;
+    {
+        std::lock_guard<std::mutex> calls_lock(communicator::m_calls_mutex);
+
+        // Find a call ID that is not in use.  Call IDs leave the response bit clear.
+        unsigned short n_ids = communicator::m_response_bit;
+        if(communicator::m_calls.size() >= n_ids)
+        {
+            return false;
+        }
+        do
+        {
+            call = communicator::m_call_counter;
+            communicator::m_call_counter = (communicator::m_call_counter + 1) % n_ids;
+        } while(communicator::m_calls.count(call) > 0);
+
+        pending_call& pending = communicator::m_calls[call];
+        pending.callback = callback;
+        pending.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    }
+
+    if(communicator::queue(std::move(request), receipt_required, nullptr, true, call) == false)
+    {
+        std::lock_guard<std::mutex> calls_lock(communicator::m_calls_mutex);
+        communicator::m_calls.erase(call);
+        return false;
+    }
+    return true;
+}
+std::future<message_view> communicator::call(message&& request, unsigned int timeout, bool receipt_required)
+{
+    // Complete a promise from the callback.  The promise is shared since std::function must be copyable.
+    std::shared_ptr<std::promise<message_view>> promise = std::make_shared<std::promise<message_view>>();
+    std::future<message_view> future = promise->get_future();
+    bool queued = communicator::call(std::move(request), timeout, [promise](call_status status, const message_view& response)
+    {
+        switch(status)
+        {
+        case call_status::COMPLETED:
+        {
+            promise->set_value(response);
+            break;
+        }
+        case call_status::TIMED_OUT:
+        {
+            promise->set_exception(std::make_exception_ptr(std::runtime_error("call timed out")));
+            break;
+        }
+        case call_status::CANCELLED:
+        {
+            promise->set_exception(std::make_exception_ptr(std::runtime_error("call cancelled")));
+            break;
+        }
+        }
+    }, receipt_required);
+    if(queued == false)
+    {
+        promise->set_exception(std::make_exception_ptr(std::runtime_error("call could not be queued")));
+    }
+    return future;
+}
+message_view communicator::receive_request(unsigned short& call, unsigned short id)
+{
+    std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
+
+    unsigned short location;
+    if(communicator::select_inbound(id, location, true) == false)
+    {
+        return message_view();
+    }
+
+    message_view output = communicator::m_rx_queue[location]->p_view();
+    call = communicator::m_rx_queue[location]->p_call();
+
+    // Remove the inbound entry from the receive queue.
+    delete communicator::m_rx_queue[location];
+    communicator::m_rx_queue[location] = nullptr;
+
+    return output;
+}
+bool communicator::respond(unsigned short call, message&& response, bool receipt_required, message_status* tracker)
+{
+    return communicator::queue(std::move(response), receipt_required, tracker, true, call | communicator::m_response_bit);
+}
 unsigned short communicator::messages_available() const
 {
+    std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
+
     // Count and return total number of messages in receive queue.
     unsigned short n_messages = 0;
     for(unsigned short i = 0; i < communicator::m_queue_size; i++)
     {
-        if(communicator::m_rx_queue[i] != nullptr)
+        if(communicator::m_rx_queue[i] != nullptr && communicator::releasable(communicator::m_rx_queue[i]))
         {
             n_messages++;
         }
@@ -86,107 +250,282 @@ unsigned short communicator::messages_available() const
 }
 message* communicator::receive(unsigned short id)
 {
-    // Find a message with the matching ID that has the highest priority, followed by oldest age.
-    utility::inbound* to_read = nullptr;
-    unsigned short location = 0;
+    std::chrono::steady_clock::time_point timestamp;
+    return communicator::receive(timestamp, id);
+}
+message_view communicator::receive_view(unsigned short id)
+{
+    std::chrono::steady_clock::time_point timestamp;
+    return communicator::receive_view(timestamp, id);
+}
+message* communicator::receive(std::chrono::steady_clock::time_point& timestamp, unsigned short id)
+{
+    std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
 
-    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    unsigned short location;
+    if(communicator::select_inbound(id, location) == false)
     {
-        // Check if there is a valid message at this location.
-        if(communicator::m_rx_queue[i] != nullptr)
-        {
-            // Store local reference to this message.
-            utility::inbound* current = communicator::m_rx_queue[i];
+        return nullptr;
+    }
 
-            // Check if the message has a matching id.
-            if(id == 0xFFFF || current->p_message()->p_id() == id)
-            {
-                // If to_read is currently empty, initialize it.
-                if(to_read == nullptr)
-                {
-                    to_read = current;
-                    location = i;
-                }
-                else
-                {
-                    // Check to see if the current message beats the to_read message in priority.
-                    if(current->p_message()->p_priority() > to_read->p_message()->p_priority())
-                    {
-                        // Replace the to_read message with the current message.
-                        to_read = current;
-                        location = i;
-                    }
-                    // Otherwise, check if priorities are equal.
-                    else if(current->p_message()->p_priority() == to_read->p_message()->p_priority())
-                    {
-                        // Compare age.
-                        if(current->p_sequence_number() < to_read->p_sequence_number())
-                        {
-                            // Replace to_read message with current message.
-                            to_read = current;
-                            location = i;
-                        }
-                    }
-                }
+    // Copy the message out of its receive buffer before the inbound entry is deleted.
+    message* output = communicator::m_rx_queue[location]->p_view().to_message();
+    timestamp = communicator::m_rx_queue[location]->p_origin_timestamp();
 
-            }
-        }
-    }
+    // Remove the inbound entry from the receive queue.
+    delete communicator::m_rx_queue[location];
+    communicator::m_rx_queue[location] = nullptr;
 
-    // Check if a message was actually found.
-    if(to_read == nullptr)
+    // Return the read message.
+    return output;
+}
+message_view communicator::receive_view(std::chrono::steady_clock::time_point& timestamp, unsigned short id)
+{
+    std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
+
+    unsigned short location;
+    if(communicator::select_inbound(id, location) == false)
     {
-        return nullptr;
+        return message_view();
     }
 
-    // If this point has been reached, a valid message has been found to read.
-
-    // Extract the message from the inbound instance before it is deleted.
-    message* output = to_read->p_message();
+    // Take a reference to the receive buffer before the inbound entry releases its own.
+    message_view output = communicator::m_rx_queue[location]->p_view();
+    timestamp = communicator::m_rx_queue[location]->p_origin_timestamp();
 
     // Remove the inbound entry from the receive queue.
     delete communicator::m_rx_queue[location];
     communicator::m_rx_queue[location] = nullptr;
 
-    // Return the read message.
     return output;
 }
 void communicator::spin()
 {
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Reset the event sources, since the pending work is about to be handled.
+    communicator::clear_events();
+
     // First send messages.
     communicator::spin_tx();
 
     // Next, receive messages.
     communicator::spin_rx();
+
+    // Then negotiate baud rates, answering any control packets just received.
+    communicator::spin_negotiation();
+
+    // Time out calls that are still waiting for responses.
+    communicator::spin_calls();
+
+    // Re-arm the event sources for any work that remains.
+    communicator::update_events();
+
+    communicator::m_statistics.record(statistics::timing::SPIN_DURATION, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+bool communicator::wait(int timeout)
+{
+    epoll_event event;
+    int n_events;
+    do
+    {
+        n_events = epoll_wait(communicator::m_epoll_fd, &event, 1, timeout);
+    } while(n_events < 0 && errno == EINTR);
+
+    return n_events > 0;
+}
+void communicator::start_capture(std::string path, unsigned long size)
+{
+    // Captures are only recorded by the spinning thread.
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    delete communicator::m_capture;
+    communicator::m_capture = nullptr;
+    communicator::m_capture = new utility::capture(path, size);
+}
+void communicator::stop_capture()
+{
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    delete communicator::m_capture;
+    communicator::m_capture = nullptr;
+}
+void communicator::start_journal(std::string path, unsigned long size)
+{
+    // Open the journal before taking the lock, as reopening a large journal reads it from disk.
+    utility::journal* journal = new utility::journal(path, size);
+
+    // The journal is shared by senders and the spinning thread under the transmit lock.
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+
+    // Messages held from a previous journal are sent as ordinary messages from now on.
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        if(communicator::m_tx_queue[i] != nullptr)
+        {
+            communicator::m_tx_queue[i]->p_journal_position(utility::outbound::m_not_journaled);
+        }
+    }
+    delete communicator::m_journal;
+    communicator::m_journal = journal;
+
+    // Send any messages left in a reopened journal.
+    communicator::load_journal();
+}
+void communicator::stop_journal()
+{
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        if(communicator::m_tx_queue[i] != nullptr)
+        {
+            communicator::m_tx_queue[i]->p_journal_position(utility::outbound::m_not_journaled);
+        }
+    }
+    delete communicator::m_journal;
+    communicator::m_journal = nullptr;
+}
+bool communicator::start_negotiation(std::vector<unsigned int> bauds)
+{
+    // Negotiators are only driven by the spinning thread.
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    // Every node on a bus must share one baud rate, which a pair of nodes can not negotiate.
+    if(communicator::m_node != 0xFF)
+    {
+        return false;
+    }
+
+    bool started = true;
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        if(communicator::m_links[i]->start_negotiation(bauds) == false)
+        {
+            started = false;
+        }
+    }
+    return started;
+}
+void communicator::stop_negotiation()
+{
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        communicator::m_links[i]->stop_negotiation();
+    }
+}
+void communicator::start_encryption(std::vector<unsigned char> key, serial_communicator::encryption algorithm)
+{
+    // The cipher is only used by the spinning thread.  The key is checked before the lock is taken.
+    utility::cipher* cipher = new utility::cipher(algorithm, key);
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    delete communicator::m_cipher;
+    communicator::m_cipher = cipher;
+}
+void communicator::stop_encryption()
+{
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    delete communicator::m_cipher;
+    communicator::m_cipher = nullptr;
+}
+void communicator::start_error_correction(unsigned int min_parity, unsigned int max_parity)
+{
+    if(max_parity > utility::reed_solomon::m_max_parity || min_parity > max_parity)
+    {
+        throw std::invalid_argument("error correction parity bounds are out of range");
+    }
+
+    // Readers are only used by the spinning thread.
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    communicator::m_correcting = true;
+    communicator::m_min_parity = min_parity;
+    communicator::m_max_parity = max_parity;
+    for(unsigned int i = 0; i < communicator::m_readers.size(); i++)
+    {
+        communicator::m_readers[i]->p_front_parity(communicator::m_front_parity);
+    }
+}
+void communicator::stop_error_correction()
+{
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    communicator::m_correcting = false;
+    for(unsigned int i = 0; i < communicator::m_readers.size(); i++)
+    {
+        communicator::m_readers[i]->p_front_parity(0);
+    }
 }
 
 // PUBLIC PROPERTIES
 unsigned short communicator::p_queue_size()
 {
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
     return communicator::m_queue_size;
 }
 void communicator::p_queue_size(unsigned short value)
 {
+    // Take all locks, in order, so that no spin, send, or receive is in progress during the resize.
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+    std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
+
     // Check if a resize is necessary.
     if(value != communicator::m_queue_size)
     {
         // Resize the queues.
-        // Create new queues.
+        // Create new queues filled with nullptrs.
         utility::outbound** new_tx = new utility::outbound*[value];
         utility::inbound** new_rx = new utility::inbound*[value];
-
-        // Copy current queues into new queues.
-        for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+        for(unsigned short i = 0; i < value; i++)
         {
-            new_tx[i] = communicator::m_tx_queue[i];
-            new_rx[i] = communicator::m_rx_queue[i];
+            new_tx[i] = nullptr;
+            new_rx[i] = nullptr;
         }
 
-        // Fill any remaining space with nullptrs.
-        for(unsigned short i = communicator::m_queue_size; i < value; i++)
+        // Compact current queue entries into the new queues.
+        unsigned short n_tx = 0;
+        unsigned short n_rx = 0;
+        bool dropped_journaled = false;
+        for(unsigned short i = 0; i < communicator::m_queue_size; i++)
         {
-            new_tx[i] = nullptr;
-            new_rx[i] = nullptr;
+            if(communicator::m_tx_queue[i] != nullptr)
+            {
+                if(n_tx < value)
+                {
+                    new_tx[n_tx++] = communicator::m_tx_queue[i];
+                }
+                else if(communicator::m_tx_queue[i]->p_journal_position() != utility::outbound::m_not_journaled)
+                {
+                    // Journaled messages stay in the journal, and are loaded again once there is room.
+                    delete communicator::m_tx_queue[i];
+                    dropped_journaled = true;
+                }
+                else
+                {
+                    // No room left in the shrunken queue.
+                    communicator::m_tx_queue[i]->update_status(message_status::NOTRECEIVED);
+                    communicator::m_statistics.increment(statistics::counter::NOT_RECEIVED);
+                    delete communicator::m_tx_queue[i];
+                }
+            }
+            if(communicator::m_rx_queue[i] != nullptr)
+            {
+                if(n_rx < value)
+                {
+                    new_rx[n_rx++] = communicator::m_rx_queue[i];
+                }
+                else
+                {
+                    // No room left in the shrunken queue.
+                    delete communicator::m_rx_queue[i];
+                }
+            }
         }
 
         // Delete old queues and replace them.
@@ -197,6 +536,16 @@ void communicator::p_queue_size(unsigned short value)
 
         // Update the queue size variable.
         communicator::m_queue_size = value;
+
+        // Refill the queue from the journal, which its dropped messages must be loaded from again.
+        if(communicator::m_journal)
+        {
+            if(dropped_journaled)
+            {
+                communicator::m_journal->rewind();
+            }
+            communicator::load_journal();
+        }
     }
 }
 unsigned int communicator::p_receipt_timeout()
@@ -215,57 +564,309 @@ void communicator::p_max_transmissions(unsigned char value)
 {
     communicator::m_max_transmissions = value;
 }
-
-// PRIVATE METHODS
-void communicator::spin_tx()
+unsigned int communicator::p_reorder_window()
 {
-    // Send the message with the highest priority or age.
-
-    // First, find the message with the highest priority or age.
-    utility::outbound* to_send = nullptr;
-    unsigned short location = 0;
-    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
-    {
-        // Check if this address has a valid outbound message in it.
-        if(communicator::m_tx_queue[i] != nullptr)
-        {
-            // Get local reference to the current message.
-            utility::outbound* current = communicator::m_tx_queue[i];
+    return communicator::m_reorder_window;
+}
+void communicator::p_reorder_window(unsigned int value)
+{
+    communicator::m_reorder_window = value;
+}
+bool communicator::p_timestamps()
+{
+    return communicator::m_timestamps;
+}
+void communicator::p_timestamps(bool value)
+{
+    communicator::m_timestamps = value;
+}
+unsigned char communicator::p_node()
+{
+    return communicator::m_node;
+}
+void communicator::p_node(unsigned char value)
+{
+    // Readers are only used by the spinning thread.
+    std::lock_guard<std::mutex> spin_lock(communicator::m_spin_mutex);
+
+    communicator::m_node = value;
+    for(unsigned int i = 0; i < communicator::m_readers.size(); i++)
+    {
+        communicator::m_readers[i]->p_node(value);
+    }
+}
+int communicator::p_file_descriptor() const
+{
+    return communicator::m_epoll_fd;
+}
+const serial_communicator::statistics& communicator::p_statistics() const
+{
+    return communicator::m_statistics;
+}
+serial_communicator::statistics& communicator::p_statistics()
+{
+    return communicator::m_statistics;
+}
+
+// PRIVATE METHODS
+void communicator::initialize()
+{
+    // Initialize parameters to default values.
+    communicator::m_queue_size = 10;
+    communicator::m_receipt_timeout = 100;
+    communicator::m_max_transmissions = 5;
+    communicator::m_reorder_window = 10;
+    communicator::m_timestamps = false;
+    communicator::m_node = 0xFF;
+
+    // Initialize sequence counter and history.
+    communicator::m_sequence_counter = 0;
+    communicator::m_call_counter = 0;
+    communicator::m_rx_history.reserve(32);
+    communicator::m_rx_history_position = 0;
+
+    // Initialize capture and encryption.
+    communicator::m_capture = nullptr;
+    communicator::m_journal = nullptr;
+    communicator::m_cipher = nullptr;
+    communicator::m_sealed.resize(256);
+    communicator::m_correcting = false;
+    communicator::m_min_parity = 0;
+    communicator::m_max_parity = 0;
 
-            // Check if this outbound is actively awaiting for receipt (e.g. hasn't yet timed out)
-            if(current->p_status() == message_status::VERIFYING && current->timeout_elapsed(communicator::m_receipt_timeout) == false)
+    // Initialize queues.
+    communicator::m_tx_queue = new utility::outbound*[communicator::m_queue_size];
+    communicator::m_rx_queue = new utility::inbound*[communicator::m_queue_size];
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        communicator::m_tx_queue[i] = nullptr;
+        communicator::m_rx_queue[i] = nullptr;
+    }
+
+    // Set up a packet assembler for each link.
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        communicator::m_readers.push_back(new utility::frame_reader(communicator::m_header_byte, communicator::m_escape_byte, 11,
+                                                                    [this](const unsigned char* front){return communicator::packet_length(front);},
+                                                                    communicator::m_statistics));
+    }
+
+    // Set up event sources.
+    communicator::m_queue_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    communicator::m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    communicator::m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<int> event_fds = {communicator::m_queue_fd, communicator::m_timer_fd};
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        event_fds.push_back(communicator::m_links[i]->p_file_descriptor());
+        communicator::m_polled.push_back(true);
+    }
+    for(unsigned int i = 0; i < event_fds.size(); i++)
+    {
+        if(event_fds[i] >= 0)
+        {
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = event_fds[i];
+            epoll_ctl(communicator::m_epoll_fd, EPOLL_CTL_ADD, event_fds[i], &event);
+        }
+    }
+}
+unsigned char communicator::link_index(const utility::link* link) const
+{
+    return static_cast<unsigned char>(std::find(communicator::m_links.begin(), communicator::m_links.end(), link) - communicator::m_links.begin());
+}
+utility::link* communicator::select_link(unsigned int length, utility::link* previous)
+{
+    // Prefer usable links other than the previous one, then any usable link, then any link at all.
+    // Links that are changing baud rate, or that have been closed, are never used.
+    for(unsigned int pass = 0; pass < 3; pass++)
+    {
+        utility::link* best = nullptr;
+        std::chrono::steady_clock::time_point best_completion;
+        for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+        {
+            utility::link* current = communicator::m_links[i];
+            if(current->p_paused() || current->p_closed() || (pass < 2 && current->p_usable() == false) || (pass == 0 && current == previous))
             {
-                // Message timeout hasn't expired for receipt yet, so no need to resend at this time.
-                // Skip this message.
                 continue;
             }
+            // Pick the link that would finish transmitting the packet first, which weighs baud rate and backlog.
+            std::chrono::steady_clock::time_point completion = current->completion_time(length);
+            if(best == nullptr || completion < best_completion)
+            {
+                best = current;
+                best_completion = completion;
+            }
+        }
+        if(best != nullptr)
+        {
+            return best;
+        }
+    }
+    return nullptr;
+}
+bool communicator::sendable() const
+{
+    // Only links that are changing baud rate or closed are excluded by select_link().
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        if(communicator::m_links[i]->p_paused() == false && communicator::m_links[i]->p_closed() == false)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+unsigned long long communicator::bus_delay()
+{
+    unsigned char node = communicator::m_node;
+    if(node == 0xFF)
+    {
+        return 0;
+    }
 
-            // Check if to_send has a value yet.
-            if(to_send == nullptr)
+    // The bus must be quiet for the turnaround, and then for the slots of every lower node, so that a lower node
+    // that is also waiting starts first and is heard before this node's slot begins.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point free = now;
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        utility::link* link = communicator::m_links[i];
+        if(communicator::m_readers[i]->p_pending() || link->available() > 0)
+        {
+            // Another node is transmitting.
+            return communicator::m_bus_turnaround;
+        }
+        free = std::max(free, link->quiet_time(communicator::m_bus_slot * node) + std::chrono::microseconds(communicator::m_bus_turnaround));
+    }
+    return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::microseconds>(free - now).count());
+}
+bool communicator::select_inbound(unsigned short id, unsigned short& location, bool requests) const
+{
+    // Find a message with the matching ID that has the highest priority, followed by oldest age.
+    utility::inbound* to_read = nullptr;
+    location = 0;
+
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        // Check if there is a valid message at this location that is past the reorder window.
+        if(communicator::m_rx_queue[i] != nullptr && communicator::releasable(communicator::m_rx_queue[i]))
+        {
+            // Store local reference to this message.
+            utility::inbound* current = communicator::m_rx_queue[i];
+
+            // Check if the message has a matching id, and is a request if only requests are wanted.
+            if((id == 0xFFFF || current->p_view().p_id() == id) && (requests == false || current->p_has_call()))
             {
-                // Update to_send with current value.
-                to_send = current;
-                location = i;
+                // If to_read is currently empty, initialize it.
+                if(to_read == nullptr)
+                {
+                    to_read = current;
+                    location = i;
+                }
+                else
+                {
+                    // Check to see if the current message beats the to_read message in priority.
+                    if(current->p_view().p_priority() > to_read->p_view().p_priority())
+                    {
+                        // Replace the to_read message with the current message.
+                        to_read = current;
+                        location = i;
+                    }
+                    // Otherwise, check if priorities are equal.
+                    else if(current->p_view().p_priority() == to_read->p_view().p_priority())
+                    {
+                        // Compare age.
+                        if(current->p_sequence_number() < to_read->p_sequence_number())
+                        {
+                            // Replace to_read message with current message.
+                            to_read = current;
+                            location = i;
+                        }
+                    }
+                }
+
             }
-            else
+        }
+    }
+
+    // Check if a message was actually found.
+    return to_read != nullptr;
+}
+bool communicator::releasable(const utility::inbound* inbound) const
+{
+    // Only bonded communicators can receive out of order.
+    if(communicator::m_links.size() == 1)
+    {
+        return true;
+    }
+    return std::chrono::steady_clock::now() - inbound->p_timestamp() >= std::chrono::milliseconds(communicator::m_reorder_window);
+}
+void communicator::spin_tx()
+{
+    // Messages wait while every link is changing baud rate.
+    if(communicator::sendable() == false)
+    {
+        return;
+    }
+    // Messages wait for their turn on a bus.  Receipts are sent as soon as their messages arrive, within the turnaround.
+    if(communicator::bus_delay() > 0)
+    {
+        return;
+    }
+
+    // Send the message with the highest priority or age.
+
+    // First, find the message with the highest priority or age.
+    utility::outbound* to_send = nullptr;
+    unsigned short location = 0;
+    {
+        // Outbound entries are only removed by the spinning thread, so the lock is not needed once one is selected.
+        std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+        for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+        {
+            // Check if this address has a valid outbound message in it.
+            if(communicator::m_tx_queue[i] != nullptr)
             {
-                // Check if current message has greater priority.
-                if(current->p_message()->p_priority() > to_send->p_message()->p_priority())
+                // Get local reference to the current message.
+                utility::outbound* current = communicator::m_tx_queue[i];
+
+                // Check if this outbound is actively awaiting for receipt (e.g. hasn't yet timed out)
+                if(current->p_status() == message_status::VERIFYING && current->timeout_elapsed(communicator::m_receipt_timeout) == false)
+                {
+                    // Message timeout hasn't expired for receipt yet, so no need to resend at this time.
+                    // Skip this message.
+                    continue;
+                }
+
+                // Check if to_send has a value yet.
+                if(to_send == nullptr)
                 {
                     // Update to_send with current value.
                     to_send = current;
                     location = i;
                 }
-                // Check if current message has equal priority.
-                else if(current->p_message()->p_priority() == to_send->p_message()->p_priority())
+                else
                 {
-                    // Check if current message has older age.
-                    if(current->p_sequence_number() < to_send->p_sequence_number())
+                    // Check if current message has greater priority.
+                    if(current->p_message()->p_priority() > to_send->p_message()->p_priority())
                     {
                         // Update to_send with current value.
                         to_send = current;
                         location = i;
                     }
+                    // Check if current message has equal priority.
+                    else if(current->p_message()->p_priority() == to_send->p_message()->p_priority())
+                    {
+                        // Check if current message has older age.
+                        if(current->p_sequence_number() < to_send->p_sequence_number())
+                        {
+                            // Update to_send with current value.
+                            to_send = current;
+                            location = i;
+                        }
+                    }
                 }
             }
         }
@@ -296,6 +897,7 @@ void communicator::spin_tx()
             // Receipt is not required.
             // Update status to sent and delete from queue.
             to_send->update_status(message_status::SENT);
+            std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
             delete communicator::m_tx_queue[location];
             communicator::m_tx_queue[location] = nullptr;
         }
@@ -303,8 +905,14 @@ void communicator::spin_tx()
     else
     {
         // Message has been sent at least once and has timed out waiting for a receipt.
-        // Check if message can be resent.
-        if(to_send->can_retransmit(communicator::m_max_transmissions))
+        // Count the timeout against the link it was sent over.
+        to_send->p_link()->mark_timeout();
+        if(to_send->p_link()->p_negotiator())
+        {
+            to_send->p_link()->p_negotiator()->mark_timeout();
+        }
+        // Check if message can be resent.  Journaled messages are resent until they are received.
+        if(to_send->p_journal_position() != utility::outbound::m_not_journaled || to_send->can_retransmit(communicator::m_max_transmissions))
         {
             // Message can be resent.
             communicator::tx(to_send);
@@ -314,6 +922,8 @@ void communicator::spin_tx()
             // Message has already been sent the maximum number of times.
             // Update status and delete.
             to_send->update_status(message_status::NOTRECEIVED);
+            communicator::m_statistics.increment(statistics::counter::NOT_RECEIVED);
+            std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
             delete communicator::m_tx_queue[location];
             communicator::m_tx_queue[location] = nullptr;
         }
@@ -321,55 +931,117 @@ void communicator::spin_tx()
 }
 void communicator::spin_rx()
 {
-    // Read bytes until header byte is found or timed out.
-    // Do this directly from the serial port since the header is not concerned with escape bytes.
-    unsigned char read_byte = 0;
-    while(read_byte != communicator::m_header_byte)
+    // Receive a packet from each link.
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
     {
-        unsigned long n_read = communicator::m_serial_port->read(&read_byte, 1);
-        if(n_read < 1)
+        communicator::spin_rx(communicator::m_links[i], communicator::m_readers[i]);
+
+        // A closed link's descriptor stays readable with nothing to read, which would wake wait() forever, so it is
+        // only polled while the link is open.
+        int fd = communicator::m_links[i]->p_file_descriptor();
+        bool closed = communicator::m_links[i]->p_closed();
+        if(fd >= 0 && closed == communicator::m_polled[i])
         {
-            // Timeout has occured, quit.
-            return;
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            epoll_ctl(communicator::m_epoll_fd, closed ? EPOLL_CTL_DEL : EPOLL_CTL_ADD, fd, &event);
+            communicator::m_polled[i] = closed == false;
         }
     }
-
-    // If this point reached, a valid header has been found.
-    // Message data length is needed.  Read beginning of packet into temporary array to get to length.
-    // 1 header, 4 sequence, 1 receipt, 2 message id, 1 priority, 2 data length. Read next 10 bytes.
-    unsigned char packet_front[11];
-    packet_front[0] = read_byte;
-    // Use rx method for rest of reads to handle escape bytes.
-    if(communicator::rx(&packet_front[1], 10) == false)
+}
+void communicator::spin_rx(utility::link* link, utility::frame_reader* reader)
+{
+    // Assemble a packet from the bytes already read, reading the bytes that have since arrived if needed.
+    // Partially assembled packets are kept by the reader until the rest arrives in a later spin.
+    unsigned int packet_length = 0;
+    std::chrono::steady_clock::time_point arrival;
+    utility::rx_buffer* buffer = reader->next(packet_length, arrival);
+    if(buffer == nullptr && reader->fill(link))
+    {
+        buffer = reader->next(packet_length, arrival);
+    }
+    if(buffer == nullptr)
     {
-        // Timeout has occurred, quit.
         return;
     }
+    unsigned char* packet = buffer->p_data();
 
-    // Extract the data length from the end of packet_front.
-    unsigned short data_length = be16toh(*reinterpret_cast<unsigned short*>(&packet_front[9]));
+    // Extract the data length and fields from the front of the packet.
+    unsigned short data_length = 0;
+    std::memcpy(&data_length, &packet[9], 2);
+    data_length = be16toh(data_length);
+    // Messages belonging to calls carry a call field, and timestamped packets their timestamps, between the data and
+    // the checksum.
+    bool called = (packet[5] & communicator::m_call_flag) != 0;
+    unsigned int n_call_bytes = called ? 2 : 0;
+    bool timestamped = (packet[5] & communicator::m_timestamp_flag) != 0;
+    bool sealed = (packet[5] & communicator::m_sealed_flag) != 0;
+    communicator::receipt_type type = static_cast<communicator::receipt_type>(packet[5] & ~(communicator::m_timestamp_flag | communicator::m_call_flag | communicator::m_sealed_flag));
+    // Offset of the timestamps within the packet.
+    unsigned int timestamps_offset = 11 + data_length + n_call_bytes;
 
-    // Form the final packet array.
-    unsigned int packet_length = 11 + data_length + 1;
-    unsigned char* packet = new unsigned char[packet_length];
-    // Copy the front of the packet into the final packet.
-    std::memcpy(packet, packet_front, 11);
-    // Read the remaining bytes into the packet.
-    if(communicator::rx(&packet[11], data_length + 1) == false)
+    // If this point is reached, a full packet has been read.
+    communicator::m_statistics.increment(statistics::counter::PACKETS_RECEIVED);
+    if(communicator::m_capture)
     {
-        // Timeout has occurred, quit.
-        return;
+        communicator::m_capture->record(utility::capture::direction::RX, communicator::link_index(link), packet, packet_length);
     }
 
-    // If this point is reached, a full packet has been read.
+    // While encrypting, only sealed packets are accepted, and they are opened in place.  Packets that are not
+    // authentic are dropped without a receipt, since they can not be trusted to say which message they are.
+    if(communicator::m_cipher || sealed)
+    {
+        bool authentic = false;
+        if(communicator::m_cipher && sealed)
+        {
+            // The front and the nodes are authenticated, and everything between the front and the nonce is encrypted.
+            unsigned char aad[13];
+            std::memcpy(aad, packet, 11);
+            aad[11] = buffer->p_destination();
+            aad[12] = buffer->p_source();
+            const unsigned char* nonce = &packet[packet_length - utility::cipher::m_tag_length - utility::cipher::m_nonce_length];
+            const unsigned char* tag = &packet[packet_length - utility::cipher::m_tag_length];
+            unsigned int encrypted_length = packet_length - 11 - utility::cipher::m_nonce_length - utility::cipher::m_tag_length;
+            authentic = communicator::m_cipher->open(aad, 13, &packet[11], encrypted_length, nonce, tag);
+            if(authentic && communicator::m_cipher->accept(buffer->p_source(), nonce) == false)
+            {
+                communicator::m_statistics.increment(statistics::counter::REPLAYS);
+                buffer->release();
+                return;
+            }
+        }
+        if(authentic == false)
+        {
+            communicator::m_statistics.increment(statistics::counter::AUTHENTICATION_FAILURES);
+            buffer->release();
+            return;
+        }
+    }
 
-    // Validate the checksum.
-    bool checksum_ok = packet[packet_length-1] == communicator::checksum(packet, packet_length-1);
+    // Validate the checksum, which sealed packets replace with their tag.
+    // Packets on a bus also cover their addresses, which are 0xFF and cancel out otherwise.
+    bool checksum_ok = sealed || packet[packet_length-1] == (communicator::checksum(packet, packet_length-1) ^ buffer->p_source() ^ buffer->p_destination());
+    if(!checksum_ok)
+    {
+        communicator::m_statistics.increment(statistics::counter::CHECKSUM_FAILURES);
+    }
     // Extract sequence number from the packet.
-    unsigned int sequence_number = be32toh(*reinterpret_cast<unsigned int*>(&packet[1]));
+    unsigned int sequence_number = 0;
+    std::memcpy(&sequence_number, &packet[1], 4);
+    sequence_number = be32toh(sequence_number);
+    // Any valid packet shows that the link is working.
+    if(checksum_ok)
+    {
+        link->mark_received();
+    }
+    if(link->p_negotiator())
+    {
+        link->p_negotiator()->mark_received(checksum_ok);
+    }
 
     // Handle receipts
-    switch(static_cast<communicator::receipt_type>(packet[5]))
+    switch(type)
     {
     case communicator::receipt_type::NOT_REQUIRED:
     {
@@ -380,8 +1052,10 @@ void communicator::spin_rx()
     {
         // Draft and send a receipt message outside of the typical outbound/tx_queue.
         // Receipt messages do not need to be tracked.
-        unsigned char receipt[12];
+        unsigned char receipt[28];
+        unsigned int receipt_length = 12;
         // Copy header(1), sequence(4), receipt(1), id(2), and priority(1) back into receipt.  Then add zero data length (2) and checksum (1).
+        // The receipt field is replaced below, so receipts never belong to calls.
         std::memcpy(receipt, packet, 9);
         // Update the receipt field.
         if(checksum_ok)
@@ -395,10 +1069,24 @@ void communicator::spin_rx()
         // No data fields.
         receipt[9] = 0;
         receipt[10] = 0;
+        // Answer timestamped messages with the times the message arrived and the receipt is sent.
+        if(timestamped)
+        {
+            receipt[5] |= communicator::m_timestamp_flag;
+            unsigned long long be_received = htobe64(utility::clock_sync::to_remote(arrival));
+            unsigned long long be_transmitted = htobe64(utility::clock_sync::to_remote(std::chrono::steady_clock::now()));
+            std::memcpy(&receipt[11], &be_received, 8);
+            std::memcpy(&receipt[19], &be_transmitted, 8);
+            receipt_length = 28;
+        }
         // Set checksum.
-        receipt[11] = communicator::checksum(receipt, 11);
-        // Write message.
-        communicator::tx(receipt, 12);
+        receipt[receipt_length - 1] = communicator::checksum(receipt, receipt_length - 1);
+        // Write message, unless every link is changing baud rate, in which case the sender retransmits.
+        utility::link* receipt_link = communicator::select_link(receipt_length);
+        if(receipt_link != nullptr)
+        {
+            communicator::tx(receipt, receipt_length, receipt_link, buffer->p_source());
+        }
         break;
     }
     case communicator::receipt_type::RECEIVED:
@@ -406,6 +1094,7 @@ void communicator::spin_rx()
         // If checksum is ok, remove the associated message from the TXQ if it is still in there.
         if(checksum_ok)
         {
+            std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
             for(unsigned short i = 0; i < communicator::m_queue_size; i++)
             {
                 if(communicator::m_tx_queue[i] != nullptr)
@@ -413,8 +1102,24 @@ void communicator::spin_rx()
                     utility::outbound* current = communicator::m_tx_queue[i];
                     if(current->p_sequence_number() == sequence_number)
                     {
+                        // Synchronize clocks from the round trip.  Only a message's first transmission is certain
+                        // to be the one that the receipt answers.  Nodes on a bus each have their own clock.
+                        if(timestamped && current->p_n_transmissions() == 1 && communicator::m_node == 0xFF)
+                        {
+                            unsigned long long be_received;
+                            unsigned long long be_transmitted;
+                            std::memcpy(&be_received, &packet[timestamps_offset], 8);
+                            std::memcpy(&be_transmitted, &packet[timestamps_offset + 8], 8);
+                            communicator::m_clock.add_sample(current->p_transmit_timestamp(), static_cast<long long>(be64toh(be_received)), static_cast<long long>(be64toh(be_transmitted)), arrival);
+                        }
                         // Update the message's status.
                         current->update_status(message_status::RECEIVED);
+                        communicator::m_statistics.record(statistics::timing::TIME_TO_RECEIPT, current->elapsed());
+                        // Remove it from the journal, if it was journaled.
+                        if(current->p_journal_position() != utility::outbound::m_not_journaled)
+                        {
+                            communicator::m_journal->acknowledge(current->p_journal_position());
+                        }
                         // Remove it from the queue.
                         delete communicator::m_tx_queue[i];
                         communicator::m_tx_queue[i] = nullptr;
@@ -431,179 +1136,867 @@ void communicator::spin_rx()
         // Find the associated message based on sequence number and immediately resend it.
         if(checksum_ok)
         {
-            for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+            utility::outbound* current = nullptr;
+            unsigned short location = 0;
             {
-                if(communicator::m_tx_queue[i] != nullptr)
+                std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+                for(unsigned short i = 0; i < communicator::m_queue_size; i++)
                 {
-                    utility::outbound* current = communicator::m_tx_queue[i];
-                    if(current->p_sequence_number() == sequence_number)
+                    if(communicator::m_tx_queue[i] != nullptr && communicator::m_tx_queue[i]->p_sequence_number() == sequence_number)
                     {
-                        // Check if message can be resent.
-                        if(current->can_retransmit(communicator::m_max_transmissions))
-                        {
-                            // Message can be resent.
-                            communicator::tx(current);
-                        }
-                        else
-                        {
-                            // Message has already been sent the maximum number of times.
-                            // Update status and delete.
-                            current->update_status(message_status::NOTRECEIVED);
-                            delete communicator::m_tx_queue[i];
-                            communicator::m_tx_queue[i] = nullptr;
-                        }
+                        current = communicator::m_tx_queue[i];
+                        location = i;
                         // Quit the for loop.
                         break;
                     }
                 }
             }
+            // If no link can carry the message now, it is resent once its receipt times out.
+            if(current != nullptr && communicator::sendable())
+            {
+                // Check if message can be resent.  Journaled messages are resent until they are received.
+                if(current->p_journal_position() != utility::outbound::m_not_journaled || current->can_retransmit(communicator::m_max_transmissions))
+                {
+                    // Message can be resent.
+                    communicator::tx(current);
+                }
+                else
+                {
+                    // Message has already been sent the maximum number of times.
+                    // Update status and delete.
+                    current->update_status(message_status::NOTRECEIVED);
+                    communicator::m_statistics.increment(statistics::counter::NOT_RECEIVED);
+                    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+                    delete communicator::m_tx_queue[location];
+                    communicator::m_tx_queue[location] = nullptr;
+                }
+            }
         }
         break;
     }
+    case communicator::receipt_type::CONTROL:
+    {
+        // Control packets carry a command in the ID field, followed by a baud rate and nonce as data.
+        utility::negotiator* negotiator = link->p_negotiator();
+        if(checksum_ok && data_length == 8)
+        {
+            unsigned short be_command;
+            unsigned int be_baud;
+            unsigned int be_nonce;
+            std::memcpy(&be_command, &packet[6], 2);
+            std::memcpy(&be_baud, &packet[11], 4);
+            std::memcpy(&be_nonce, &packet[15], 4);
+            utility::negotiator::control control;
+            control.command = static_cast<utility::negotiator::command>(be16toh(be_command));
+            control.baud = be32toh(be_baud);
+            control.nonce = be32toh(be_nonce);
+            if(negotiator != nullptr)
+            {
+                negotiator->handle(control);
+            }
+            else if(control.command == utility::negotiator::command::REQUEST)
+            {
+                // Refuse requests when not negotiating, so that the remote end does not switch regardless.
+                control.command = utility::negotiator::command::REJECT;
+                communicator::tx(control, link);
+            }
+        }
+        break;
+    }
+    }
+
+    // Receipts and control packets are not messages, and only need to be handled above.
+    bool is_receipt = type == communicator::receipt_type::RECEIVED ||
+                      type == communicator::receipt_type::CHECKSUM_MISMATCH ||
+                      type == communicator::receipt_type::CONTROL;
+
+    // When bonded, a message retransmitted over a different link may arrive more than once.
+    // Each node on a bus numbers its own messages.
+    bool is_duplicate = false;
+    unsigned long long origin_sequence = (static_cast<unsigned long long>(buffer->p_source()) << 32) | sequence_number;
+    if(checksum_ok && !is_receipt && communicator::m_links.size() > 1)
+    {
+        is_duplicate = std::find(communicator::m_rx_history.begin(), communicator::m_rx_history.end(), origin_sequence) != communicator::m_rx_history.end();
+        if(is_duplicate)
+        {
+            communicator::m_statistics.increment(statistics::counter::DUPLICATES);
+        }
+        else
+        {
+            // Record the sequence number, overwriting the oldest once the history is full.
+            if(communicator::m_rx_history.size() < communicator::m_rx_history.capacity())
+            {
+                communicator::m_rx_history.push_back(origin_sequence);
+            }
+            else
+            {
+                communicator::m_rx_history[communicator::m_rx_history_position] = origin_sequence;
+                communicator::m_rx_history_position = (communicator::m_rx_history_position + 1) % communicator::m_rx_history.size();
+            }
+        }
     }
 
+    // Hand responses straight to their calls.
+    unsigned short call = 0;
+    if(called)
+    {
+        unsigned short be_call;
+        std::memcpy(&be_call, &packet[11 + data_length], 2);
+        call = be16toh(be_call);
+    }
+    if(checksum_ok && !is_receipt && !is_duplicate && called && (call & communicator::m_response_bit))
+    {
+        // Responses to calls that have timed out are dropped.
+        pending_call pending;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> calls_lock(communicator::m_calls_mutex);
+            auto entry = communicator::m_calls.find(call & ~communicator::m_response_bit);
+            if(entry != communicator::m_calls.end())
+            {
+                pending = std::move(entry->second);
+                communicator::m_calls.erase(entry);
+                found = true;
+            }
+        }
+        if(found)
+        {
+            pending.callback(call_status::COMPLETED, message_view(buffer, 6));
+        }
+    }
     // Lastly, put packet into inbound message in the rx_queue.
-    if(checksum_ok)
+    else if(checksum_ok && !is_receipt && !is_duplicate)
     {
+        // Convert the sender's timestamp to the local clock once the clocks are synchronized.  A message can not
+        // have been sent after it arrived, which bounds the estimate.
+        std::chrono::steady_clock::time_point origin = arrival;
+        if(timestamped && communicator::m_clock.p_synchronized())
+        {
+            unsigned long long be_origin;
+            std::memcpy(&be_origin, &packet[timestamps_offset], 8);
+            origin = std::min(communicator::m_clock.to_local(static_cast<long long>(be64toh(be_origin))), arrival);
+        }
+
+        std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
         // Find an open position in the RXQ.
+        bool queued = false;
         for(unsigned short i = 0; i < communicator::m_queue_size; i++)
         {
             if(communicator::m_rx_queue[i] == nullptr)
             {
-                // Extract the message from the packet.
-                message* msg = new message(&packet[6]);
-                // Add new inbound to the rx_queue.
-                communicator::m_rx_queue[i] = new utility::inbound(msg, sequence_number);
+                // Add new inbound to the rx_queue, viewing the message within the packet.
+                communicator::m_rx_queue[i] = new utility::inbound(message_view(buffer, 6), sequence_number, arrival, origin);
+                if(called)
+                {
+                    communicator::m_rx_queue[i]->p_call(call);
+                }
+                queued = true;
 
                 // Exit for loop.
                 break;
             }
         }
+        if(!queued)
+        {
+            communicator::m_statistics.increment(statistics::counter::RX_QUEUE_DROPS);
+        }
     }
 
-    // Delete the packet.
-    delete [] packet;
+    // Release the packet, which remains in use by its inbound entry if queued.
+    buffer->release();
 }
-void communicator::tx(utility::outbound* message)
+void communicator::spin_negotiation()
 {
-    // Serialize the packet without escapes.
-    // First, get total packet length = message length + 7 (1 header, 4 sequence, 1 receipt, 1 checksum)
-    unsigned int packet_size = message->p_message()->p_message_length() + 7;
-    // Create packet.
-    unsigned char* packet = new unsigned char[packet_size];
-    // Write the header, sequence, and receipt.
-    packet[0] = communicator::m_header_byte;
-    unsigned int be_sequence = htobe32(message->p_sequence_number());
-    std::memcpy(&packet[1], &be_sequence, 4);
-    packet[5] = message->p_receipt_required();
-    // Write the message bytes.
-    message->p_message()->serialize(&packet[6]);
-    // Calculate and add CRC.
-    packet[packet_size-1] = communicator::checksum(packet, packet_size - 1);
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        utility::link* link = communicator::m_links[i];
+        utility::negotiator* negotiator = link->p_negotiator();
+        if(negotiator == nullptr)
+        {
+            continue;
+        }
 
-    // Write to the serial port.
-    communicator::tx(packet, packet_size);
+        // Carry out the negotiator's actions until it has nothing left to do.
+        utility::negotiator::control control;
+        utility::negotiator::action action;
+        while((action = negotiator->poll(link->p_drained(), control)) != utility::negotiator::action::NONE)
+        {
+            if(action == utility::negotiator::action::SEND)
+            {
+                communicator::tx(control, link);
+            }
+            else
+            {
+                link->set_baud(control.baud);
+                communicator::m_statistics.increment(statistics::counter::BAUD_CHANGES);
+            }
+        }
+    }
+}
+void communicator::spin_calls()
+{
+    // Collect the calls that have timed out, and complete them once the calls are unlocked.
+    std::vector<pending_call> timed_out;
+    {
+        std::lock_guard<std::mutex> calls_lock(communicator::m_calls_mutex);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for(auto pending = communicator::m_calls.begin(); pending != communicator::m_calls.end();)
+        {
+            if(pending->second.deadline <= now)
+            {
+                timed_out.push_back(std::move(pending->second));
+                pending = communicator::m_calls.erase(pending);
+            }
+            else
+            {
+                ++pending;
+            }
+        }
+    }
+    for(unsigned int i = 0; i < timed_out.size(); i++)
+    {
+        timed_out[i].callback(call_status::TIMED_OUT, message_view());
+    }
+}
+bool communicator::queue(message&& message, bool receipt_required, message_status* tracker, bool has_call, unsigned short call)
+{
+    // Every node on a bus would answer a broadcast at once.
+    if(receipt_required && message.p_node() == 0xFF && communicator::m_node != 0xFF)
+    {
+        throw std::invalid_argument("broadcast messages can not require receipts");
+    }
 
-    // Mark that the message has been sent.
-    message->mark_transmitted();
+    std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+
+    // Messages that require receipts are kept in the journal if there is one.  Calls are answered by a process that
+    // is still waiting, so their requests are not kept past a restart.
+    if(receipt_required && has_call == false && communicator::m_journal)
+    {
+        return communicator::journal_message(std::move(message), tracker);
+    }
+
+    // Find an open spot in the transmit queue.
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        if(communicator::m_tx_queue[i] == nullptr)
+        {
+            // Open space found. Move the message into an outbound and increment sequence counter.
+            communicator::m_tx_queue[i] = new utility::outbound(std::move(message), communicator::m_sequence_counter++, receipt_required, tracker);
+            if(has_call)
+            {
+                communicator::m_tx_queue[i]->p_call(call);
+            }
+            // Signal that transmit work is pending.
+            eventfd_write(communicator::m_queue_fd, 1);
+            // Quit here.
+            return true;
+        }
+    }
+
+    // If this point reached, a spot was not found.
+    communicator::m_statistics.increment(statistics::counter::SEND_REJECTIONS);
+    return false;
+}
+bool communicator::journal_message(message&& message, message_status* tracker)
+{
+    // Journaled messages may only take half of the transmit queue, leaving room for messages that are not journaled.
+    unsigned short n_journaled = 0;
+    unsigned short location = communicator::m_queue_size;
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+    {
+        if(communicator::m_tx_queue[i] == nullptr)
+        {
+            if(location == communicator::m_queue_size)
+            {
+                location = i;
+            }
+        }
+        else if(communicator::m_tx_queue[i]->p_journal_position() != utility::outbound::m_not_journaled)
+        {
+            n_journaled++;
+        }
+    }
+    // Messages are held in order, so the message is only held if none are waiting in the journal before it.
+    bool hold = location < communicator::m_queue_size && n_journaled < (communicator::m_queue_size + 1) / 2 && communicator::m_journal->p_waiting() == false;
+
+    unsigned long long position;
+    if(communicator::m_journal->append(message, hold, position) == false)
+    {
+        // The journal is full.
+        communicator::m_statistics.increment(statistics::counter::SEND_REJECTIONS);
+        return false;
+    }
 
-    // Delete the packet.
-    delete [] packet;
+    if(hold)
+    {
+        communicator::m_tx_queue[location] = new utility::outbound(std::move(message), communicator::m_sequence_counter++, true, tracker);
+        communicator::m_tx_queue[location]->p_journal_position(position);
+        // Signal that transmit work is pending.
+        eventfd_write(communicator::m_queue_fd, 1);
+    }
+    else if(tracker)
+    {
+        // The message waits in the journal, where its tracker can not follow it.
+        *tracker = message_status::QUEUED;
+    }
+    return true;
 }
-void communicator::tx(unsigned char *buffer, unsigned int length)
+void communicator::load_journal()
 {
-    // Check if escapes are needed.
-    unsigned int n_escapes = 0;
-    // Only check after the header.
-    for(unsigned int i = 1; i < length; i++)
+    if(communicator::m_journal == nullptr || communicator::m_journal->p_waiting() == false)
+    {
+        return;
+    }
+
+    unsigned short n_journaled = 0;
+    for(unsigned short i = 0; i < communicator::m_queue_size; i++)
     {
-        if(buffer[i] == communicator::m_header_byte || buffer[i] == communicator::m_escape_byte)
+        if(communicator::m_tx_queue[i] != nullptr && communicator::m_tx_queue[i]->p_journal_position() != utility::outbound::m_not_journaled)
         {
-            n_escapes++;
+            n_journaled++;
         }
     }
 
-    // Handle escapes.
-    if(n_escapes > 0)
+    // Fill open spots with the oldest waiting messages, up to the journal's share of the queue.
+    bool loaded = false;
+    for(unsigned short i = 0; i < communicator::m_queue_size && n_journaled < (communicator::m_queue_size + 1) / 2; i++)
     {
-        // Escapes needed.
-        unsigned char* esc_buffer = new unsigned char[length + n_escapes];
-        unsigned int esc_write_position = 0;
-        // Copy the header byte first since it should not be escaped.
-        esc_buffer[esc_write_position++] = buffer[0];
-        // Only check after the header.
-        for(unsigned int i = 1; i < length; i++)
+        if(communicator::m_tx_queue[i] != nullptr)
         {
-            if(buffer[i] == communicator::m_header_byte || buffer[i] == communicator::m_escape_byte)
+            continue;
+        }
+        serial_communicator::message message(static_cast<unsigned short>(0));
+        unsigned long long position;
+        bool found = false;
+        while(found == false && communicator::m_journal->next(message, position))
+        {
+            // After a rewind, messages that are still held are passed over.
+            found = true;
+            for(unsigned short j = 0; j < communicator::m_queue_size && found; j++)
             {
-                // Insert escape.
-                esc_buffer[esc_write_position++] = communicator::m_escape_byte;
-                // Copy in byte decremented by one.
-                esc_buffer[esc_write_position++] = buffer[i] - 1;
+                found = communicator::m_tx_queue[j] == nullptr || communicator::m_tx_queue[j]->p_journal_position() != position;
             }
-            else
+        }
+        if(found == false)
+        {
+            break;
+        }
+        communicator::m_tx_queue[i] = new utility::outbound(std::move(message), communicator::m_sequence_counter++, true, nullptr);
+        communicator::m_tx_queue[i]->p_journal_position(position);
+        n_journaled++;
+        loaded = true;
+    }
+
+    if(loaded)
+    {
+        // Signal that transmit work is pending.
+        eventfd_write(communicator::m_queue_fd, 1);
+    }
+}
+void communicator::clear_events()
+{
+    // Drain the queue eventfd.
+    eventfd_t value;
+    eventfd_read(communicator::m_queue_fd, &value);
+
+    // Disarm the timer, which also clears any expiration.
+    itimerspec timer = {};
+    timerfd_settime(communicator::m_timer_fd, 0, &timer, nullptr);
+}
+void communicator::update_events()
+{
+    // Determine if any work is pending now, or when the earliest receipt timeout or reorder window elapses.
+    // The queue depths are sampled along the way.
+    bool pending = false;
+    bool timed = false;
+    unsigned int earliest = 0;
+    unsigned long long depth = 0;
+    // Messages can not be sent while every link is changing baud rate, so only the negotiation timing matters.
+    bool sendable = communicator::sendable();
+    // Messages waiting for their turn on a bus are sent once it comes.
+    unsigned long long bus_delay = sendable ? communicator::bus_delay() : 0;
+    {
+        std::lock_guard<std::mutex> tx_lock(communicator::m_tx_mutex);
+        // Receipts free room in the transmit queue for messages waiting in the journal.
+        communicator::load_journal();
+        for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+        {
+            utility::outbound* current = communicator::m_tx_queue[i];
+            if(current == nullptr)
+            {
+                continue;
+            }
+            depth++;
+            if(sendable == false)
+            {
+                continue;
+            }
+            if(current->p_status() != message_status::VERIFYING)
+            {
+                // Message is waiting to be sent.
+                if(bus_delay == 0)
+                {
+                    pending = true;
+                }
+                else
+                {
+                    unsigned int bus_delay_ms = static_cast<unsigned int>((bus_delay + 999) / 1000);
+                    if(timed == false || bus_delay_ms < earliest)
+                    {
+                        earliest = bus_delay_ms;
+                        timed = true;
+                    }
+                }
+                continue;
+            }
+            unsigned int remaining = current->timeout_remaining(communicator::m_receipt_timeout);
+            if(timed == false || remaining < earliest)
+            {
+                earliest = remaining;
+                timed = true;
+            }
+        }
+    }
+    communicator::m_statistics.sample(statistics::gauge::TX_QUEUE_DEPTH, depth);
+    depth = 0;
+    {
+        std::lock_guard<std::mutex> rx_lock(communicator::m_rx_mutex);
+        for(unsigned short i = 0; i < communicator::m_queue_size; i++)
+        {
+            utility::inbound* current = communicator::m_rx_queue[i];
+            if(current == nullptr)
+            {
+                continue;
+            }
+            depth++;
+            if(communicator::releasable(current))
+            {
+                continue;
+            }
+            // Message is being held for reordering.
+            long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - current->p_timestamp()).count();
+            long remaining = static_cast<long>(communicator::m_reorder_window) - elapsed;
+            unsigned int remaining_ms = remaining > 0 ? static_cast<unsigned int>(remaining) : 0;
+            if(timed == false || remaining_ms < earliest)
+            {
+                earliest = remaining_ms;
+                timed = true;
+            }
+        }
+    }
+    communicator::m_statistics.sample(statistics::gauge::RX_QUEUE_DEPTH, depth);
+    {
+        // Outstanding calls time out.
+        std::lock_guard<std::mutex> calls_lock(communicator::m_calls_mutex);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for(auto pending = communicator::m_calls.begin(); pending != communicator::m_calls.end(); ++pending)
+        {
+            long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(pending->second.deadline - now).count() + 1;
+            unsigned int remaining_ms = remaining > 0 ? static_cast<unsigned int>(remaining) : 0;
+            if(timed == false || remaining_ms < earliest)
+            {
+                earliest = remaining_ms;
+                timed = true;
+            }
+        }
+    }
+    for(unsigned int i = 0; i < communicator::m_links.size(); i++)
+    {
+        // Bytes already read from a link may hold further packets, which its file descriptor no longer signals.
+        if(communicator::m_readers[i]->p_pending())
+        {
+            pending = true;
+        }
+        // Closed links are checked again from time to time, since some transports can be reopened.
+        if(communicator::m_polled[i] == false && communicator::m_links[i]->p_file_descriptor() >= 0)
+        {
+            if(timed == false || communicator::m_closed_poll_interval < earliest)
             {
-                // Copy buffer byte in.
-                esc_buffer[esc_write_position++] = buffer[i];
+                earliest = communicator::m_closed_poll_interval;
+                timed = true;
             }
         }
+        // Negotiating links have timed duties of their own.
+        const utility::negotiator* negotiator = communicator::m_links[i]->p_negotiator();
+        if(negotiator != nullptr)
+        {
+            unsigned int delay = negotiator->p_poll_delay();
+            if(timed == false || delay < earliest)
+            {
+                earliest = delay;
+                timed = true;
+            }
+        }
+    }
+
+    if(pending || (timed && earliest == 0))
+    {
+        // Work can be done immediately.
+        eventfd_write(communicator::m_queue_fd, 1);
+    }
+    else if(timed)
+    {
+        // Arm the timer for the earliest deadline.
+        itimerspec timer = {};
+        timer.it_value.tv_sec = earliest / 1000;
+        timer.it_value.tv_nsec = static_cast<long>(earliest % 1000) * 1000000L;
+        timerfd_settime(communicator::m_timer_fd, 0, &timer, nullptr);
+    }
+}
+void communicator::tx(utility::outbound* message)
+{
+    // Frame the message without copying its data.
+    // The front of the packet holds 1 header, 4 sequence, 1 receipt, 2 message id, 1 priority, and 2 data length.
+    const serial_communicator::message* contents = message->p_message();
+    unsigned char front[11];
+    front[0] = communicator::m_header_byte;
+    unsigned int be_sequence = htobe32(message->p_sequence_number());
+    std::memcpy(&front[1], &be_sequence, 4);
+    front[5] = message->p_receipt_required();
+    // Messages belonging to calls carry their call field after the data.
+    unsigned short be_call = 0;
+    if(message->p_has_call())
+    {
+        front[5] |= communicator::m_call_flag;
+        be_call = htobe16(message->p_call());
+    }
+    // Timestamped messages carry the time they were queued between the data and the checksum.
+    bool timestamped = communicator::m_timestamps;
+    unsigned long long be_timestamp = 0;
+    if(timestamped)
+    {
+        front[5] |= communicator::m_timestamp_flag;
+        be_timestamp = htobe64(utility::clock_sync::to_remote(message->p_queue_timestamp()));
+    }
+    unsigned short be_id = htobe16(contents->p_id());
+    std::memcpy(&front[6], &be_id, 2);
+    front[8] = contents->p_priority();
+    unsigned short be_data_length = htobe16(contents->p_data_length());
+    std::memcpy(&front[9], &be_data_length, 2);
+    // The checksum covers the front and data, and trails the packet.
+    unsigned char trailer = communicator::checksum(front, 11) ^ communicator::checksum(contents->p_data(), contents->p_data_length());
+    unsigned int packet_size = contents->p_message_length() + 7;
+    if(message->p_has_call())
+    {
+        trailer ^= communicator::checksum(reinterpret_cast<unsigned char*>(&be_call), 2);
+        packet_size += 2;
+    }
+    if(timestamped)
+    {
+        trailer ^= communicator::checksum(reinterpret_cast<unsigned char*>(&be_timestamp), 8);
+        packet_size += 8;
+    }
 
-        // Write the escaped buffer.
-        communicator::m_serial_port->write(esc_buffer, length + n_escapes);
-        // Delete the escaped buffer.
-        delete [] esc_buffer;
+    // Record how long the message waited to be sent, or that it is being retransmitted.
+    if(message->p_n_transmissions() == 0)
+    {
+        communicator::m_statistics.record(statistics::timing::TIME_IN_QUEUE, message->elapsed());
     }
     else
     {
-        // Escapes not needed.  Write buffer as is.
-        communicator::m_serial_port->write(buffer, length);
+        communicator::m_statistics.increment(statistics::counter::RETRANSMISSIONS);
+    }
+
+    // Write to the serial port, avoiding the link a retransmitted message was previously sent over.
+    utility::link* link = communicator::select_link(packet_size, message->p_link());
+    iovec segments[5] = {{front, 11}, {const_cast<unsigned char*>(contents->p_data()), contents->p_data_length()}};
+    unsigned int n_segments = 2;
+    if(message->p_has_call())
+    {
+        segments[n_segments++] = {&be_call, 2};
     }
+    if(timestamped)
+    {
+        segments[n_segments++] = {&be_timestamp, 8};
+    }
+    segments[n_segments++] = {&trailer, 1};
+    communicator::tx(segments, n_segments, link, contents->p_node());
+
+    // Mark that the message has been sent.
+    message->mark_transmitted(link);
 }
-bool communicator::rx(unsigned char* buffer, unsigned int length)
+void communicator::tx(unsigned char *buffer, unsigned int length, utility::link* link, unsigned char destination)
 {
-    // Create global flag for unescaping the next byte, even across different read segments.
-    bool unescape_next = false;
-    // Block read until length bytes have been satisfied after escapements.
-    unsigned int current_length = 0;
-    while(current_length < length)
+    iovec segment = {buffer, length};
+    communicator::tx(&segment, 1, link, destination);
+}
+void communicator::tx(const iovec* segments, unsigned int n_segments, utility::link* link, unsigned char destination)
+{
+    if(communicator::m_cipher == nullptr)
     {
-        // Read in the remaining length into a temporary buffer.
-        unsigned int remaining_length = length - current_length;
-        unsigned char* temp_buffer = new unsigned char[remaining_length];
-        unsigned long n_read = communicator::m_serial_port->read(temp_buffer, remaining_length);
-        if(n_read < remaining_length)
+        communicator::write_packet(segments, n_segments, link, destination, true);
+        return;
+    }
+
+    // Seal the packet by encrypting everything between the front and the checksum, which is left out.
+    // First split the segments into the front and the bytes to encrypt.
+    unsigned int length = 0;
+    for(unsigned int i = 0; i < n_segments; i++)
+    {
+        length += static_cast<unsigned int>(segments[i].iov_len);
+    }
+    unsigned char front[11];
+    iovec plaintext[8];
+    unsigned int n_plaintext = 0;
+    unsigned int position = 0;
+    for(unsigned int i = 0; i < n_segments && n_plaintext < 8; i++)
+    {
+        const unsigned char* segment = static_cast<const unsigned char*>(segments[i].iov_base);
+        unsigned int start = position;
+        unsigned int end = position + static_cast<unsigned int>(segments[i].iov_len);
+        if(start < 11)
         {
-            // Quit due to timeout.
-            return false;
+            std::memcpy(&front[start], segment, std::min(end, 11u) - start);
+        }
+        unsigned int plaintext_start = std::max(start, 11u);
+        unsigned int plaintext_end = std::min(end, length - 1);
+        if(plaintext_start < plaintext_end)
+        {
+            plaintext[n_plaintext].iov_base = const_cast<unsigned char*>(segment + (plaintext_start - start));
+            plaintext[n_plaintext].iov_len = plaintext_end - plaintext_start;
+            n_plaintext++;
+        }
+        position = end;
+    }
+    front[5] |= communicator::m_sealed_flag;
+
+    // Authenticate the front and the nodes, which are 0xFF when not on a bus.
+    bool addressed = communicator::m_node != 0xFF;
+    unsigned char aad[13];
+    std::memcpy(aad, front, 11);
+    aad[11] = addressed ? destination : 0xFF;
+    aad[12] = communicator::m_node;
+    unsigned int sealed_length = length - 12;
+    if(communicator::m_sealed.size() < sealed_length)
+    {
+        communicator::m_sealed.resize(sealed_length);
+    }
+    unsigned char nonce[utility::cipher::m_nonce_length];
+    unsigned char tag[utility::cipher::m_tag_length];
+    communicator::m_cipher->seal(aad, 13, plaintext, n_plaintext, communicator::m_sealed.data(), nonce, tag);
+
+    iovec sealed[4] = {{front, 11}, {communicator::m_sealed.data(), sealed_length}, {nonce, sizeof(nonce)}, {tag, sizeof(tag)}};
+    communicator::write_packet(sealed, 4, link, destination, false);
+}
+void communicator::write_packet(const iovec* segments, unsigned int n_segments, utility::link* link, unsigned char destination, bool checksummed)
+{
+    // Gather the bytes after the header.  On a bus, the addresses follow the header so that other nodes can skip the
+    // packet early.
+    unsigned char source = communicator::m_node;
+    bool addressed = source != 0xFF;
+    unsigned char addresses[2] = {destination, source};
+    unsigned char trailer = 0;
+    iovec packet[16];
+    unsigned int n_packet = 0;
+    if(addressed)
+    {
+        packet[n_packet++] = {addresses, 2};
+    }
+    unsigned int length = 0;
+    for(unsigned int i = 0; i < n_segments && n_packet < 15; i++)
+    {
+        unsigned char* segment = static_cast<unsigned char*>(segments[i].iov_base);
+        unsigned int segment_length = static_cast<unsigned int>(segments[i].iov_len);
+        // Skip the header at the start of the first segment.
+        unsigned int skip = (i == 0 && segment_length > 0) ? 1 : 0;
+        if(addressed && checksummed && i == n_segments - 1 && segment_length > skip)
+        {
+            // Extend the trailing checksum over the addresses.
+            packet[n_packet++] = {segment + skip, segment_length - skip - 1};
+            trailer = segment[segment_length - 1] ^ destination ^ source;
+            packet[n_packet++] = {&trailer, 1};
         }
-        // Read through the temporary buffer and extract bytes into the actual buffer.
-        for(unsigned int i = 0; i < remaining_length; i++)
+        else
+        {
+            packet[n_packet++] = {segment + skip, segment_length - skip};
+        }
+        length += segment_length;
+    }
+
+    // Write the header as is, and escape everything after it.
+    utility::escape_writer writer(link, communicator::m_header_byte, communicator::m_escape_byte);
+    writer.append_header();
+    if(communicator::m_correcting)
+    {
+        // Take the packet's bytes in order, as segments of up to the given length.
+        unsigned int position = 0;
+        unsigned int offset = 0;
+        auto take = [&](unsigned int n_bytes, iovec* taken)
         {
-            if(temp_buffer[i] == communicator::m_escape_byte)
+            unsigned int n_taken = 0;
+            while(n_bytes > 0 && position < n_packet)
             {
-                // Mark the escape flag.
-                unescape_next = true;
+                unsigned int n_left = static_cast<unsigned int>(packet[position].iov_len) - offset;
+                unsigned int n_take = std::min(n_left, n_bytes);
+                if(n_take > 0)
+                {
+                    taken[n_taken++] = {static_cast<unsigned char*>(packet[position].iov_base) + offset, n_take};
+                }
+                offset += n_take;
+                n_bytes -= n_take;
+                if(offset == packet[position].iov_len)
+                {
+                    position++;
+                    offset = 0;
+                }
             }
-            else
+            return n_taken;
+        };
+
+        // The addresses, the front after its header, and the number of parity bytes in the rest of the packet form
+        // a codeword of their own, so the packet can be measured and filtered even if its front was corrupted.
+        unsigned int front_length = (addressed ? 2 : 0) + 10;
+        unsigned int body_length = length - 11;
+        unsigned int parity = communicator::select_parity(link, body_length);
+        iovec front_segments[16];
+        unsigned int n_front_segments = take(front_length, front_segments);
+        unsigned char front[2 + 10 + 1 + 4];
+        for(unsigned int i = 0, j = 0; i < n_front_segments; j += static_cast<unsigned int>(front_segments[i++].iov_len))
+        {
+            std::memcpy(&front[j], front_segments[i].iov_base, front_segments[i].iov_len);
+        }
+        front[front_length] = static_cast<unsigned char>(parity);
+        iovec front_codeword = {front, front_length + 1};
+        utility::reed_solomon::encode(&front_codeword, 1, communicator::m_front_parity, &front[front_length + 1]);
+        writer.append(front, front_length + 1 + communicator::m_front_parity);
+
+        // The rest of the packet is written as codewords of up to 255 bytes, each followed by its parity.
+        unsigned int block_length = utility::reed_solomon::m_max_codeword_length - parity;
+        unsigned int n_blocks = parity == 0 ? 1 : (body_length + block_length - 1) / block_length;
+        if(communicator::m_parity.size() < n_blocks * parity)
+        {
+            communicator::m_parity.resize(n_blocks * parity);
+        }
+        for(unsigned int block = 0; block < n_blocks; block++)
+        {
+            iovec data[16];
+            unsigned int n_data = take(parity == 0 ? body_length : std::min(block_length, body_length - block * block_length), data);
+            for(unsigned int i = 0; i < n_data; i++)
+            {
+                writer.append(static_cast<const unsigned char*>(data[i].iov_base), static_cast<unsigned int>(data[i].iov_len));
+            }
+            if(parity != 0)
             {
-                // Copy byte.
-                // Unescaping is adding 1 to the value. Can use cast of unescape_next bool.
-                buffer[current_length++] = temp_buffer[i] + static_cast<unsigned char>(unescape_next);
-                // Set unescape flag.
-                unescape_next = false;
+                unsigned char* block_parity = &communicator::m_parity[block * parity];
+                utility::reed_solomon::encode(data, n_data, parity, block_parity);
+                writer.append(block_parity, parity);
             }
         }
+    }
+    else
+    {
+        for(unsigned int i = 0; i < n_packet; i++)
+        {
+            writer.append(static_cast<const unsigned char*>(packet[i].iov_base), static_cast<unsigned int>(packet[i].iov_len));
+        }
+    }
+    writer.flush();
+
+    communicator::m_statistics.increment(statistics::counter::PACKETS_SENT);
+    communicator::m_statistics.increment(statistics::counter::BYTES_SENT, writer.p_n_bytes());
+    communicator::m_statistics.increment(statistics::counter::ESCAPES_INSERTED, writer.p_n_escapes());
 
-        delete [] temp_buffer;
+    // Captures store the unescaped packet contiguously, so it is only assembled when capturing.
+    if(communicator::m_capture)
+    {
+        std::vector<unsigned char> packet;
+        packet.reserve(length);
+        for(unsigned int i = 0; i < n_segments; i++)
+        {
+            const unsigned char* segment = static_cast<const unsigned char*>(segments[i].iov_base);
+            packet.insert(packet.end(), segment, segment + segments[i].iov_len);
+        }
+        communicator::m_capture->record(utility::capture::direction::TX, communicator::link_index(link), packet.data(), length);
     }
+}
+void communicator::tx(const utility::negotiator::control& control, utility::link* link)
+{
+    // Control packets are framed as messages without a sequence number, with the command as the ID and the baud rate
+    // and nonce as 8 bytes of data.
+    unsigned char packet[20];
+    packet[0] = communicator::m_header_byte;
+    std::memset(&packet[1], 0, 4);
+    packet[5] = static_cast<unsigned char>(communicator::receipt_type::CONTROL);
+    unsigned short be_command = htobe16(static_cast<unsigned short>(control.command));
+    std::memcpy(&packet[6], &be_command, 2);
+    packet[8] = 0;
+    unsigned short be_data_length = htobe16(8);
+    std::memcpy(&packet[9], &be_data_length, 2);
+    unsigned int be_baud = htobe32(control.baud);
+    std::memcpy(&packet[11], &be_baud, 4);
+    unsigned int be_nonce = htobe32(control.nonce);
+    std::memcpy(&packet[15], &be_nonce, 4);
+    packet[19] = communicator::checksum(packet, 19);
 
-    // If this point is reached, current_length = length.
-    return true;
+    communicator::tx(packet, 20, link);
+}
+unsigned int communicator::select_parity(utility::link* link, unsigned int length) const
+{
+    // Expect the errors in a codeword to follow the error rate measured over the link, and add enough parity to
+    // correct three standard deviations more than the expected number.
+    double error_rate = communicator::m_readers[communicator::link_index(link)]->p_error_rate();
+    unsigned int codeword_length = length + communicator::m_max_parity;
+    if(codeword_length > utility::reed_solomon::m_max_codeword_length)
+    {
+        codeword_length = utility::reed_solomon::m_max_codeword_length;
+    }
+    double n_expected = codeword_length * error_rate;
+    unsigned int parity = 2 * static_cast<unsigned int>(std::ceil(n_expected + 3.0 * std::sqrt(n_expected)));
+    return std::max(communicator::m_min_parity, std::min(parity, communicator::m_max_parity));
+}
+unsigned int communicator::packet_length(const unsigned char* front) const
+{
+    // 1 header, 4 sequence, 1 receipt, 2 message id, 1 priority, 2 data length, then the data, any call field and
+    // timestamps, and 1 checksum.
+    unsigned short data_length = 0;
+    std::memcpy(&data_length, &front[9], 2);
+    unsigned int n_call_bytes = (front[5] & communicator::m_call_flag) != 0 ? 2 : 0;
+    // Sealed packets end with a nonce and tag in place of the checksum.
+    unsigned int n_trailer_bytes = (front[5] & communicator::m_sealed_flag) != 0 ? utility::cipher::m_nonce_length + utility::cipher::m_tag_length : 1;
+    return 11 + be16toh(data_length) + n_call_bytes + communicator::timestamps_length(front[5]) + n_trailer_bytes;
 }
-unsigned char communicator::checksum(unsigned char* data, unsigned int length)
+unsigned int communicator::timestamps_length(unsigned char receipt) const
 {
-    unsigned char checksum = 0;
-    for(unsigned int i = 0 ; i < length; i++)
+    if((receipt & communicator::m_timestamp_flag) == 0)
+    {
+        return 0;
+    }
+    switch(static_cast<communicator::receipt_type>(receipt & ~(communicator::m_timestamp_flag | communicator::m_call_flag | communicator::m_sealed_flag)))
+    {
+    case communicator::receipt_type::NOT_REQUIRED:
+    case communicator::receipt_type::REQUIRED:
+    {
+        // The time the message was queued.
+        return 8;
+    }
+    case communicator::receipt_type::RECEIVED:
+    case communicator::receipt_type::CHECKSUM_MISMATCH:
+    {
+        // The times the message arrived and the receipt was sent.
+        return 16;
+    }
+    default:
+    {
+        return 0;
+    }
+    }
+}
+unsigned char communicator::checksum(const unsigned char* data, unsigned int length)
+{
+    // XOR eight bytes at a time, then fold the word down to a byte.
+    unsigned long long word = 0;
+    unsigned int i = 0;
+    for(; i + 8 <= length; i += 8)
+    {
+        unsigned long long chunk;
+        std::memcpy(&chunk, &data[i], 8);
+        word ^= chunk;
+    }
+    word ^= word >> 32;
+    word ^= word >> 16;
+    word ^= word >> 8;
+    unsigned char checksum = static_cast<unsigned char>(word);
+    for(; i < length; i++)
     {
         checksum ^= data[i];
     }
@@ -0,0 +1,180 @@
+#include "serial_communicator/transport/descriptor_transport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+descriptor_transport::descriptor_transport(int fd)
+{
+    descriptor_transport::m_fd = fd;
+    descriptor_transport::m_closed = false;
+}
+descriptor_transport::~descriptor_transport()
+{
+    if(descriptor_transport::m_fd >= 0)
+    {
+        close(descriptor_transport::m_fd);
+    }
+}
+
+// METHODS
+unsigned long descriptor_transport::read(unsigned char* buffer, unsigned long length)
+{
+    // Read until length bytes have been read, or the read timeout elapses.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(descriptor_transport::m_read_timeout);
+    unsigned long n_read = 0;
+    while(n_read < length)
+    {
+        // Wait for bytes within the remaining time.
+        long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        pollfd poll_fd = {descriptor_transport::m_fd, POLLIN, 0};
+        int n_ready = poll(&poll_fd, 1, remaining > 0 ? static_cast<int>(remaining) : 0);
+        if(n_ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n_ready < 1)
+        {
+            // Timeout or error.
+            break;
+        }
+
+        ssize_t result = ::read(descriptor_transport::m_fd, &buffer[n_read], length - n_read);
+        if(result < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            continue;
+        }
+        if(result == 0)
+        {
+            // End of stream.
+            descriptor_transport::m_closed = true;
+            break;
+        }
+        if(result < 0)
+        {
+            // Error.
+            break;
+        }
+        n_read += static_cast<unsigned long>(result);
+    }
+    return n_read;
+}
+unsigned long descriptor_transport::write(const unsigned char* buffer, unsigned long length)
+{
+    // Write until all bytes have been written.
+    unsigned long n_written = 0;
+    while(n_written < length)
+    {
+        ssize_t result = ::write(descriptor_transport::m_fd, &buffer[n_written], length - n_written);
+        if(result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(result < 0 && errno == EAGAIN)
+        {
+            // Wait for space in a non-blocking descriptor.
+            pollfd poll_fd = {descriptor_transport::m_fd, POLLOUT, 0};
+            poll(&poll_fd, 1, -1);
+            continue;
+        }
+        if(result < 0)
+        {
+            break;
+        }
+        n_written += static_cast<unsigned long>(result);
+    }
+    return n_written;
+}
+unsigned long descriptor_transport::write(const iovec* vectors, unsigned int count)
+{
+    // Gather the buffers in batches, since writev() may need to be resumed part way through a buffer.
+    const unsigned int batch_size = 64;
+    iovec batch[batch_size];
+    unsigned long n_written = 0;
+    for(unsigned int start = 0; start < count; start += batch_size)
+    {
+        unsigned int n_batch = std::min(batch_size, count - start);
+        std::copy(vectors + start, vectors + start + n_batch, batch);
+        unsigned int current = 0;
+        while(current < n_batch)
+        {
+            ssize_t result = ::writev(descriptor_transport::m_fd, &batch[current], static_cast<int>(n_batch - current));
+            if(result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(result < 0 && errno == EAGAIN)
+            {
+                // Wait for space in a non-blocking descriptor.
+                pollfd poll_fd = {descriptor_transport::m_fd, POLLOUT, 0};
+                poll(&poll_fd, 1, -1);
+                continue;
+            }
+            if(result < 0)
+            {
+                return n_written;
+            }
+            n_written += static_cast<unsigned long>(result);
+
+            // Skip the buffers that were completely written, and advance into a partially written one.
+            unsigned long remaining = static_cast<unsigned long>(result);
+            while(current < n_batch && remaining >= batch[current].iov_len)
+            {
+                remaining -= batch[current].iov_len;
+                current++;
+            }
+            if(current < n_batch)
+            {
+                batch[current].iov_base = static_cast<unsigned char*>(batch[current].iov_base) + remaining;
+                batch[current].iov_len -= remaining;
+            }
+        }
+    }
+    return n_written;
+}
+unsigned long descriptor_transport::available()
+{
+    int n_available = 0;
+    if(ioctl(descriptor_transport::m_fd, FIONREAD, &n_available) < 0)
+    {
+        return 0;
+    }
+    if(n_available > 0)
+    {
+        descriptor_transport::m_closed = false;
+        return static_cast<unsigned long>(n_available);
+    }
+
+    // A descriptor that polls as readable or hung up with nothing to read has been closed by its remote end.  Bytes
+    // may arrive between the two checks, so they are counted again before deciding.
+    pollfd poll_fd = {descriptor_transport::m_fd, POLLIN | POLLRDHUP, 0};
+    bool signalled = poll(&poll_fd, 1, 0) > 0 && (poll_fd.revents & (POLLIN | POLLHUP | POLLRDHUP | POLLERR)) != 0;
+    if(signalled && ioctl(descriptor_transport::m_fd, FIONREAD, &n_available) == 0 && n_available > 0)
+    {
+        descriptor_transport::m_closed = false;
+        return static_cast<unsigned long>(n_available);
+    }
+    descriptor_transport::m_closed = signalled;
+    return 0;
+}
+
+// PROPERTIES
+int descriptor_transport::p_file_descriptor() const
+{
+    return descriptor_transport::m_fd;
+}
+unsigned long descriptor_transport::p_byte_time() const
+{
+    // File descriptors are not rate limited.
+    return 0;
+}
+bool descriptor_transport::p_closed() const
+{
+    return descriptor_transport::m_closed;
+}
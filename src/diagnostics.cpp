@@ -0,0 +1,79 @@
+#include "serial_communicator/diagnostics.h"
+
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+using namespace serial_communicator;
+
+namespace {
+// Names of the statistics, in enumeration order.
+const char* counter_names[] = {"bytes_sent", "bytes_received", "packets_sent", "packets_received", "escapes_inserted",
+                               "checksum_failures", "retransmissions", "not_received", "rx_queue_drops", "send_rejections",
+                               "duplicates", "baud_changes", "framing_errors", "packets_filtered",
+                               "authentication_failures", "replays", "bytes_corrected", "correction_failures"};
+const char* gauge_names[] = {"tx_queue_depth", "rx_queue_depth"};
+const char* timing_names[] = {"time_in_queue_us", "time_to_receipt_us", "spin_duration_us"};
+static_assert(sizeof(counter_names) / sizeof(counter_names[0]) == statistics::m_n_counters, "Every counter needs a name.");
+static_assert(sizeof(gauge_names) / sizeof(gauge_names[0]) == statistics::m_n_gauges, "Every gauge needs a name.");
+static_assert(sizeof(timing_names) / sizeof(timing_names[0]) == statistics::m_n_timings, "Every timing needs a name.");
+
+// Adds a key value pair to a diagnostic status.
+template <typename T>
+void add_value(diagnostic_msgs::DiagnosticStatus& status, std::string key, T value)
+{
+    diagnostic_msgs::KeyValue key_value;
+    key_value.key = key;
+    key_value.value = std::to_string(value);
+    status.values.push_back(key_value);
+}
+}
+
+// CONSTRUCTORS
+diagnostics::diagnostics(ros::NodeHandle& node_handle, std::string name)
+{
+    diagnostics::m_publisher = node_handle.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+    diagnostics::m_name = name;
+}
+
+// METHODS
+void diagnostics::publish(const statistics& statistics)
+{
+    diagnostic_msgs::DiagnosticStatus status;
+    status.level = diagnostic_msgs::DiagnosticStatus::OK;
+    status.name = "serial_communicator: " + diagnostics::m_name;
+    status.hardware_id = diagnostics::m_name;
+    status.message = "OK";
+
+    // Add counters and gauges.
+    for(unsigned int i = 0; i < statistics::m_n_counters; i++)
+    {
+        add_value(status, counter_names[i], statistics.p_counter(static_cast<statistics::counter>(i)));
+    }
+    for(unsigned int i = 0; i < statistics::m_n_gauges; i++)
+    {
+        add_value(status, gauge_names[i], statistics.p_gauge(static_cast<statistics::gauge>(i)));
+    }
+
+    // Add timing summaries.
+    for(unsigned int i = 0; i < statistics::m_n_timings; i++)
+    {
+        const utility::histogram& histogram = statistics.p_histogram(static_cast<statistics::timing>(i));
+        std::string name = timing_names[i];
+        add_value(status, name + "_count", histogram.p_count());
+        add_value(status, name + "_mean", histogram.p_mean());
+        add_value(status, name + "_p50", histogram.percentile(50.0));
+        add_value(status, name + "_p99", histogram.percentile(99.0));
+        add_value(status, name + "_max", histogram.p_max());
+    }
+
+    // Warn when messages are failing to be delivered.
+    if(statistics.p_counter(statistics::counter::NOT_RECEIVED) > 0 || statistics.p_counter(statistics::counter::RX_QUEUE_DROPS) > 0)
+    {
+        status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+        status.message = "Messages have been lost";
+    }
+
+    diagnostic_msgs::DiagnosticArray array;
+    array.header.stamp = ros::Time::now();
+    array.status.push_back(status);
+    diagnostics::m_publisher.publish(array);
+}
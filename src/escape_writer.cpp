@@ -0,0 +1,152 @@
+#include "serial_communicator/utility/escape_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+escape_writer::escape_writer(utility::link* link, unsigned char header_byte, unsigned char escape_byte)
+{
+    escape_writer::m_link = link;
+    escape_writer::m_header_byte = header_byte;
+    escape_writer::m_escape_byte = escape_byte;
+    escape_writer::m_n_vectors = 0;
+    escape_writer::m_staging_length = 0;
+    escape_writer::m_n_bytes = 0;
+    escape_writer::m_n_escapes = 0;
+}
+
+// METHODS
+void escape_writer::append_header()
+{
+    escape_writer::stage(&(escape_writer::m_header_byte), 1);
+}
+void escape_writer::append(const unsigned char* data, unsigned int length)
+{
+    unsigned int position = 0;
+    while(position < length)
+    {
+        // Find the end of the run of bytes that do not need escaping.
+        unsigned int end = position;
+        while(end < length && data[end] != escape_writer::m_header_byte && data[end] != escape_writer::m_escape_byte)
+        {
+            end++;
+        }
+
+        // Write long runs in place, and copy short ones.
+        unsigned int run = end - position;
+        if(run >= escape_writer::m_min_reference)
+        {
+            escape_writer::reference(&data[position], run);
+        }
+        else if(run > 0)
+        {
+            escape_writer::stage(&data[position], run);
+        }
+
+        // Escape the bytes that ended the run, sending each decremented by one.  Escapes are gathered in batches
+        // so that densely escaped data is not staged two bytes at a time.
+        unsigned char escaped[64];
+        unsigned int n_escaped = 0;
+        while(end < length && n_escaped < sizeof(escaped) && (data[end] == escape_writer::m_header_byte || data[end] == escape_writer::m_escape_byte))
+        {
+            escaped[n_escaped++] = escape_writer::m_escape_byte;
+            escaped[n_escaped++] = static_cast<unsigned char>(data[end] - 1);
+            end++;
+        }
+        if(n_escaped > 0)
+        {
+            escape_writer::stage(escaped, n_escaped);
+            escape_writer::m_n_escapes += n_escaped / 2;
+        }
+        position = end;
+    }
+}
+void escape_writer::flush()
+{
+    if(escape_writer::m_n_vectors > 0)
+    {
+        escape_writer::m_link->write(escape_writer::m_vectors, escape_writer::m_n_vectors);
+    }
+    escape_writer::m_n_vectors = 0;
+    escape_writer::m_staging_length = 0;
+}
+
+// PROPERTIES
+unsigned long escape_writer::p_n_bytes() const
+{
+    return escape_writer::m_n_bytes;
+}
+unsigned long escape_writer::p_n_escapes() const
+{
+    return escape_writer::m_n_escapes;
+}
+
+// PRIVATE METHODS
+void escape_writer::stage(const unsigned char* data, unsigned int length)
+{
+    // Most copies are escape sequences and short runs that continue the last staged buffer.
+    if(escape_writer::m_n_vectors > 0 && length <= escape_writer::m_staging_size - escape_writer::m_staging_length)
+    {
+        iovec& last = escape_writer::m_vectors[escape_writer::m_n_vectors - 1];
+        unsigned char* destination = &escape_writer::m_staging[escape_writer::m_staging_length];
+        if(static_cast<unsigned char*>(last.iov_base) + last.iov_len == destination)
+        {
+            std::memcpy(destination, data, length);
+            last.iov_len += length;
+            escape_writer::m_staging_length += length;
+            escape_writer::m_n_bytes += length;
+            return;
+        }
+    }
+
+    while(length > 0)
+    {
+        // Write out the gathered buffers once the staging area is full.
+        if(escape_writer::m_staging_length == escape_writer::m_staging_size)
+        {
+            escape_writer::flush();
+        }
+
+        unsigned char* destination = &escape_writer::m_staging[escape_writer::m_staging_length];
+
+        // Extend the last buffer if it ends where this copy starts, otherwise gather a new one.
+        iovec* last = escape_writer::m_n_vectors > 0 ? &escape_writer::m_vectors[escape_writer::m_n_vectors - 1] : nullptr;
+        bool extend = last != nullptr && static_cast<unsigned char*>(last->iov_base) + last->iov_len == destination;
+        if(!extend && escape_writer::m_n_vectors == escape_writer::m_max_vectors)
+        {
+            escape_writer::flush();
+            continue;
+        }
+
+        unsigned int n_copy = std::min(length, escape_writer::m_staging_size - escape_writer::m_staging_length);
+        std::memcpy(destination, data, n_copy);
+        if(extend)
+        {
+            last->iov_len += n_copy;
+        }
+        else
+        {
+            escape_writer::m_vectors[escape_writer::m_n_vectors].iov_base = destination;
+            escape_writer::m_vectors[escape_writer::m_n_vectors].iov_len = n_copy;
+            escape_writer::m_n_vectors++;
+        }
+
+        escape_writer::m_staging_length += n_copy;
+        escape_writer::m_n_bytes += n_copy;
+        data += n_copy;
+        length -= n_copy;
+    }
+}
+void escape_writer::reference(const unsigned char* data, unsigned int length)
+{
+    if(escape_writer::m_n_vectors == escape_writer::m_max_vectors)
+    {
+        escape_writer::flush();
+    }
+    escape_writer::m_vectors[escape_writer::m_n_vectors].iov_base = const_cast<unsigned char*>(data);
+    escape_writer::m_vectors[escape_writer::m_n_vectors].iov_len = length;
+    escape_writer::m_n_vectors++;
+    escape_writer::m_n_bytes += length;
+}
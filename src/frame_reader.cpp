@@ -0,0 +1,323 @@
+#include "serial_communicator/utility/frame_reader.h"
+#include "serial_communicator/utility/reed_solomon.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+frame_reader::frame_reader(unsigned char header_byte, unsigned char escape_byte, unsigned int front_length, std::function<unsigned int(const unsigned char*)> measure, serial_communicator::statistics& statistics)
+    : m_statistics(statistics)
+{
+    if(front_length < 1 || front_length > frame_reader::m_max_front_length)
+    {
+        throw std::invalid_argument("frame_reader front length is out of range");
+    }
+
+    // Store parameters.
+    frame_reader::m_header_byte = header_byte;
+    frame_reader::m_escape_byte = escape_byte;
+    frame_reader::m_front_length = front_length;
+    frame_reader::m_node = 0xFF;
+    frame_reader::m_front_parity = 0;
+    frame_reader::m_measure = measure;
+
+    // Initialize state.
+    frame_reader::m_chunk_length = 0;
+    frame_reader::m_chunk_position = 0;
+    frame_reader::m_stage = frame_reader::stage::SEARCHING;
+    frame_reader::m_unescape_next = false;
+    frame_reader::m_buffer = nullptr;
+    frame_reader::m_length = 0;
+    frame_reader::m_position = 0;
+    frame_reader::m_parity = 0;
+    frame_reader::m_packet_length = 0;
+    frame_reader::m_error_rate = 0;
+}
+frame_reader::~frame_reader()
+{
+    // Release a partially assembled packet.
+    if(frame_reader::m_buffer)
+    {
+        frame_reader::m_buffer->release();
+    }
+}
+
+// METHODS
+bool frame_reader::fill(utility::link* link)
+{
+    if(frame_reader::p_pending())
+    {
+        return false;
+    }
+
+    // Only read bytes that have already arrived so that reading never waits on the link.
+    unsigned long n_available = std::min<unsigned long>(link->available(), frame_reader::m_chunk_size);
+    if(n_available == 0)
+    {
+        return false;
+    }
+    unsigned long n_read = link->read(frame_reader::m_chunk, static_cast<unsigned int>(n_available));
+    frame_reader::m_statistics.increment(serial_communicator::statistics::counter::BYTES_RECEIVED, n_read);
+    frame_reader::m_chunk_length = static_cast<unsigned int>(n_read);
+    frame_reader::m_chunk_position = 0;
+    return n_read > 0;
+}
+rx_buffer* frame_reader::next(unsigned int& length, std::chrono::steady_clock::time_point& timestamp)
+{
+    while(frame_reader::p_pending())
+    {
+        switch(frame_reader::m_stage)
+        {
+        case frame_reader::stage::SEARCHING:
+        {
+            // Skip to the next header byte.  Header bytes are not escaped, so no unescaping is needed.
+            const unsigned char* start = &frame_reader::m_chunk[frame_reader::m_chunk_position];
+            const void* header = std::memchr(start, frame_reader::m_header_byte, frame_reader::m_chunk_length - frame_reader::m_chunk_position);
+            if(header == nullptr)
+            {
+                frame_reader::m_chunk_position = frame_reader::m_chunk_length;
+                break;
+            }
+            frame_reader::m_chunk_position += static_cast<unsigned int>(static_cast<const unsigned char*>(header) - start) + 1;
+
+            // Timestamps and receipts measure from the header's arrival.
+            frame_reader::m_timestamp = std::chrono::steady_clock::now();
+            frame_reader::m_front[0] = frame_reader::m_header_byte;
+            frame_reader::m_unescape_next = false;
+            if(frame_reader::m_front_parity != 0)
+            {
+                // The addresses are part of the front's codeword, so they are read with it.
+                frame_reader::m_stage = frame_reader::stage::FRONT;
+                frame_reader::m_length = (frame_reader::m_node != 0xFF ? 2 : 0) + frame_reader::m_front_length + frame_reader::m_front_parity;
+                frame_reader::m_position = 0;
+            }
+            else if(frame_reader::m_node != 0xFF)
+            {
+                frame_reader::m_stage = frame_reader::stage::ADDRESSES;
+                frame_reader::m_length = 2;
+                frame_reader::m_position = 0;
+            }
+            else
+            {
+                frame_reader::m_stage = frame_reader::stage::FRONT;
+                frame_reader::m_length = frame_reader::m_front_length;
+                frame_reader::m_position = 1;
+            }
+            break;
+        }
+        case frame_reader::stage::ADDRESSES:
+        {
+            if(frame_reader::unescape(frame_reader::m_addresses) == false || frame_reader::accept_addresses() == false)
+            {
+                break;
+            }
+            frame_reader::m_stage = frame_reader::stage::FRONT;
+            frame_reader::m_length = frame_reader::m_front_length;
+            frame_reader::m_position = 1;
+            break;
+        }
+        case frame_reader::stage::FRONT:
+        {
+            if(frame_reader::m_front_parity == 0)
+            {
+                if(frame_reader::unescape(frame_reader::m_front) == false)
+                {
+                    break;
+                }
+                frame_reader::m_parity = 0;
+            }
+            else if(frame_reader::unescape(frame_reader::m_coded_front) == false || frame_reader::correct_front() == false ||
+                    (frame_reader::m_node != 0xFF && frame_reader::accept_addresses() == false))
+            {
+                break;
+            }
+
+            // The front is complete, so the packet can be measured and given a buffer of its own, with room for the
+            // parity of the rest of the packet.
+            unsigned int packet_length = frame_reader::m_measure(frame_reader::m_front);
+            if(packet_length <= frame_reader::m_front_length)
+            {
+                frame_reader::discard();
+                break;
+            }
+            frame_reader::m_packet_length = packet_length;
+            if(frame_reader::m_parity != 0)
+            {
+                unsigned int body_length = packet_length - frame_reader::m_front_length;
+                unsigned int block_length = reed_solomon::m_max_codeword_length - frame_reader::m_parity;
+                packet_length += frame_reader::m_parity * ((body_length + block_length - 1) / block_length);
+            }
+            frame_reader::m_buffer = rx_buffer::acquire(packet_length);
+            if(frame_reader::m_node != 0xFF)
+            {
+                frame_reader::m_buffer->p_addresses(frame_reader::m_addresses[1], frame_reader::m_addresses[0]);
+            }
+            std::memcpy(frame_reader::m_buffer->p_data(), frame_reader::m_front, frame_reader::m_front_length);
+            frame_reader::m_stage = frame_reader::stage::BODY;
+            frame_reader::m_length = packet_length;
+            frame_reader::m_position = frame_reader::m_front_length;
+            break;
+        }
+        case frame_reader::stage::BODY:
+        {
+            if(frame_reader::unescape(frame_reader::m_buffer->p_data()) == false ||
+               (frame_reader::m_parity != 0 && frame_reader::correct_body() == false))
+            {
+                break;
+            }
+
+            // The packet is complete.  Hand it over and search for the next.
+            rx_buffer* packet = frame_reader::m_buffer;
+            frame_reader::m_buffer = nullptr;
+            frame_reader::m_stage = frame_reader::stage::SEARCHING;
+            length = frame_reader::m_packet_length;
+            timestamp = frame_reader::m_timestamp;
+            return packet;
+        }
+        }
+    }
+
+    return nullptr;
+}
+
+// PROPERTIES
+bool frame_reader::p_pending() const
+{
+    return frame_reader::m_chunk_position < frame_reader::m_chunk_length;
+}
+unsigned char frame_reader::p_node() const
+{
+    return frame_reader::m_node;
+}
+void frame_reader::p_node(unsigned char value)
+{
+    frame_reader::m_node = value;
+}
+unsigned int frame_reader::p_front_parity() const
+{
+    return frame_reader::m_front_parity;
+}
+void frame_reader::p_front_parity(unsigned int value)
+{
+    if(value > frame_reader::m_max_front_parity)
+    {
+        throw std::invalid_argument("frame_reader front parity is out of range");
+    }
+    frame_reader::m_front_parity = value;
+}
+double frame_reader::p_error_rate() const
+{
+    return frame_reader::m_error_rate;
+}
+
+// PRIVATE METHODS
+bool frame_reader::unescape(unsigned char* destination)
+{
+    while(frame_reader::m_position < frame_reader::m_length && frame_reader::m_chunk_position < frame_reader::m_chunk_length)
+    {
+        unsigned char byte = frame_reader::m_chunk[frame_reader::m_chunk_position];
+        if(byte == frame_reader::m_header_byte)
+        {
+            // The packet was cut short.  Leave the header to start the next packet.
+            frame_reader::discard();
+            return false;
+        }
+        frame_reader::m_chunk_position++;
+        if(frame_reader::m_unescape_next)
+        {
+            // Unescaping is adding 1 to the value.
+            destination[frame_reader::m_position++] = byte + 1;
+            frame_reader::m_unescape_next = false;
+        }
+        else if(byte == frame_reader::m_escape_byte)
+        {
+            frame_reader::m_unescape_next = true;
+        }
+        else
+        {
+            destination[frame_reader::m_position++] = byte;
+        }
+    }
+
+    return frame_reader::m_position == frame_reader::m_length;
+}
+bool frame_reader::accept_addresses()
+{
+    // Skip packets for other nodes, and this node's own packets echoed by the bus, by searching for the next header.
+    // Header bytes are escaped within packets, so the skipped bytes need no unescaping.
+    unsigned char destination = frame_reader::m_addresses[0];
+    unsigned char source = frame_reader::m_addresses[1];
+    if((destination != frame_reader::m_node && destination != 0xFF) || source == frame_reader::m_node)
+    {
+        frame_reader::m_statistics.increment(serial_communicator::statistics::counter::PACKETS_FILTERED);
+        frame_reader::m_stage = frame_reader::stage::SEARCHING;
+        return false;
+    }
+    return true;
+}
+bool frame_reader::correct_front()
+{
+    // The codeword holds the addresses on a bus, the front after its header, and the parity level of the rest.
+    unsigned int n_addresses = frame_reader::m_node != 0xFF ? 2 : 0;
+    unsigned int length = n_addresses + frame_reader::m_front_length + frame_reader::m_front_parity;
+    int n_errors = reed_solomon::decode(frame_reader::m_coded_front, length, frame_reader::m_front_parity);
+    frame_reader::record_errors(n_errors, length, frame_reader::m_front_parity);
+    unsigned int parity = frame_reader::m_coded_front[n_addresses + frame_reader::m_front_length - 1];
+    if(n_errors < 0 || parity > reed_solomon::m_max_parity)
+    {
+        frame_reader::discard(serial_communicator::statistics::counter::CORRECTION_FAILURES);
+        return false;
+    }
+    std::memcpy(frame_reader::m_addresses, frame_reader::m_coded_front, n_addresses);
+    std::memcpy(&frame_reader::m_front[1], &frame_reader::m_coded_front[n_addresses], frame_reader::m_front_length - 1);
+    frame_reader::m_parity = parity;
+    return true;
+}
+bool frame_reader::correct_body()
+{
+    // Correct each codeword, and close the gap left by the parity of the codeword before it.
+    unsigned int block_length = reed_solomon::m_max_codeword_length - frame_reader::m_parity;
+    unsigned char* read = frame_reader::m_buffer->p_data() + frame_reader::m_front_length;
+    unsigned char* write = read;
+    unsigned int remaining = frame_reader::m_packet_length - frame_reader::m_front_length;
+    while(remaining > 0)
+    {
+        unsigned int data_length = std::min(remaining, block_length);
+        int n_errors = reed_solomon::decode(read, data_length + frame_reader::m_parity, frame_reader::m_parity);
+        frame_reader::record_errors(n_errors, data_length + frame_reader::m_parity, frame_reader::m_parity);
+        if(n_errors < 0)
+        {
+            frame_reader::discard(serial_communicator::statistics::counter::CORRECTION_FAILURES);
+            return false;
+        }
+        std::memmove(write, read, data_length);
+        read += data_length + frame_reader::m_parity;
+        write += data_length;
+        remaining -= data_length;
+    }
+    return true;
+}
+void frame_reader::record_errors(int n_errors, unsigned int length, unsigned int n_parity)
+{
+    // A codeword that could not be corrected had at least one more error than its parity can correct.
+    unsigned int n_counted = n_errors < 0 ? n_parity / 2 + 1 : static_cast<unsigned int>(n_errors);
+    if(n_errors > 0)
+    {
+        frame_reader::m_statistics.increment(serial_communicator::statistics::counter::BYTES_CORRECTED, static_cast<unsigned long long>(n_errors));
+    }
+    double rate = static_cast<double>(n_counted) / length;
+    frame_reader::m_error_rate += (rate - frame_reader::m_error_rate) * frame_reader::m_error_rate_weight;
+}
+void frame_reader::discard(serial_communicator::statistics::counter reason)
+{
+    frame_reader::m_statistics.increment(reason);
+    if(frame_reader::m_buffer)
+    {
+        frame_reader::m_buffer->release();
+        frame_reader::m_buffer = nullptr;
+    }
+    frame_reader::m_stage = frame_reader::stage::SEARCHING;
+}
@@ -0,0 +1,111 @@
+#include "serial_communicator/utility/histogram.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+histogram::histogram()
+{
+    histogram::reset();
+}
+
+// METHODS
+void histogram::record(unsigned long long value)
+{
+    histogram::m_buckets[histogram::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    histogram::m_count.fetch_add(1, std::memory_order_relaxed);
+    histogram::m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    // Update the extremes.
+    unsigned long long current = histogram::m_min.load(std::memory_order_relaxed);
+    while(value < current && !histogram::m_min.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    current = histogram::m_max.load(std::memory_order_relaxed);
+    while(value > current && !histogram::m_max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+unsigned long long histogram::percentile(double percentile) const
+{
+    // Sum the buckets, since the count may be updated concurrently.
+    unsigned long long counts[histogram::m_n_buckets];
+    unsigned long long total = 0;
+    for(unsigned int i = 0; i < histogram::m_n_buckets; i++)
+    {
+        counts[i] = histogram::m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if(total == 0)
+    {
+        return 0;
+    }
+
+    // Find the bucket containing the percentile's rank.
+    double rank = (percentile / 100.0) * total;
+    unsigned long long target = rank < 1.0 ? 1 : static_cast<unsigned long long>(rank + 0.5);
+    unsigned long long cumulative = 0;
+    for(unsigned int i = 0; i < histogram::m_n_buckets; i++)
+    {
+        cumulative += counts[i];
+        if(cumulative >= target)
+        {
+            // The bucket's highest value can exceed the highest value actually recorded.
+            return std::min(histogram::bucket_value(i), histogram::m_max.load(std::memory_order_relaxed));
+        }
+    }
+    return histogram::m_max.load(std::memory_order_relaxed);
+}
+void histogram::reset()
+{
+    for(unsigned int i = 0; i < histogram::m_n_buckets; i++)
+    {
+        histogram::m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    histogram::m_count.store(0, std::memory_order_relaxed);
+    histogram::m_sum.store(0, std::memory_order_relaxed);
+    histogram::m_min.store(std::numeric_limits<unsigned long long>::max(), std::memory_order_relaxed);
+    histogram::m_max.store(0, std::memory_order_relaxed);
+}
+
+// PROPERTIES
+unsigned long long histogram::p_count() const
+{
+    return histogram::m_count.load(std::memory_order_relaxed);
+}
+unsigned long long histogram::p_min() const
+{
+    return histogram::p_count() > 0 ? histogram::m_min.load(std::memory_order_relaxed) : 0;
+}
+unsigned long long histogram::p_max() const
+{
+    return histogram::m_max.load(std::memory_order_relaxed);
+}
+double histogram::p_mean() const
+{
+    unsigned long long count = histogram::p_count();
+    return count > 0 ? static_cast<double>(histogram::m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+// PRIVATE METHODS
+unsigned int histogram::bucket(unsigned long long value)
+{
+    // Values below 8 have exact buckets.
+    if(value < 8)
+    {
+        return static_cast<unsigned int>(value);
+    }
+    // Otherwise, the bucket is selected by the most significant bit, and the sub-bucket by the next three bits.
+    unsigned int msb = 63 - static_cast<unsigned int>(__builtin_clzll(value));
+    unsigned int sub_bucket = static_cast<unsigned int>(value >> (msb - 3)) & 0x7;
+    return (msb - 2) * 8 + sub_bucket;
+}
+unsigned long long histogram::bucket_value(unsigned int bucket)
+{
+    if(bucket < 8)
+    {
+        return bucket;
+    }
+    unsigned int msb = bucket / 8 + 2;
+    unsigned long long sub_bucket = bucket % 8;
+    unsigned long long lower = (8 + sub_bucket) << (msb - 3);
+    return lower + ((1ULL << (msb - 3)) - 1);
+}
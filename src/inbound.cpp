@@ -1,21 +1,20 @@
 #include "serial_communicator/utility/inbound.h"
 
+// Compile the hot path into the library unless it is inlined into calling code.
+#ifndef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/inbound.inl"
+#endif
+
 using namespace serial_communicator;
 using namespace serial_communicator::utility;
 
 // CONSTRUCTORS
-inbound::inbound(message* message, unsigned int sequence_number)
+inbound::inbound(const message_view& view, unsigned int sequence_number, std::chrono::steady_clock::time_point timestamp, std::chrono::steady_clock::time_point origin_timestamp)
 {
-    inbound::m_message = message;
+    inbound::m_view = view;
     inbound::m_sequence_number = sequence_number;
-}
-
-// PROPERTIES
-message* inbound::p_message() const
-{
-    return inbound::m_message;
-}
-unsigned int inbound::p_sequence_number() const
-{
-    return inbound::m_sequence_number;
+    inbound::m_timestamp = timestamp;
+    inbound::m_origin_timestamp = origin_timestamp;
+    inbound::m_has_call = false;
+    inbound::m_call = 0;
 }
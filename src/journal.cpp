@@ -0,0 +1,210 @@
+#include "serial_communicator/utility/journal.h"
+
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace serial_communicator::utility;
+
+namespace {
+// Identifies journal files.
+const char journal_magic[8] = {'S', 'C', 'J', 'R', 'N', '0', '0', '1'};
+
+// Rounds a length up to the record alignment.
+unsigned long long align(unsigned long long length)
+{
+    return (length + 7) & ~7ULL;
+}
+}
+
+// CONSTRUCTORS
+journal::journal(std::string path, unsigned long size)
+{
+    // The ring must hold at least one record, or positions within it can not be calculated.
+    if(align(size) < sizeof(record_header))
+    {
+        throw std::invalid_argument("journal size must hold at least one record");
+    }
+
+    journal::m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(journal::m_fd < 0)
+    {
+        throw std::runtime_error("failed to open journal file " + path);
+    }
+
+    // Keep an existing journal as it is, or size a new one.
+    struct stat file_stat;
+    file_header existing;
+    bool reopened = fstat(journal::m_fd, &file_stat) == 0 && static_cast<unsigned long>(file_stat.st_size) >= sizeof(file_header) &&
+                    pread(journal::m_fd, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing)) &&
+                    std::memcmp(existing.magic, journal_magic, sizeof(journal_magic)) == 0 &&
+                    existing.capacity + sizeof(file_header) == static_cast<unsigned long long>(file_stat.st_size) &&
+                    existing.capacity >= sizeof(record_header) && existing.head < existing.capacity && existing.used <= existing.capacity;
+    unsigned long long capacity = reopened ? existing.capacity : align(size);
+    journal::m_map_size = sizeof(file_header) + capacity;
+    if(reopened == false && ftruncate(journal::m_fd, static_cast<off_t>(journal::m_map_size)) < 0)
+    {
+        close(journal::m_fd);
+        throw std::runtime_error("failed to create journal file " + path);
+    }
+
+    // Map the file.
+    void* map = mmap(nullptr, journal::m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, journal::m_fd, 0);
+    if(map == MAP_FAILED)
+    {
+        close(journal::m_fd);
+        throw std::runtime_error("failed to map journal file " + path);
+    }
+    journal::m_header = static_cast<file_header*>(map);
+    journal::m_ring = static_cast<unsigned char*>(map) + sizeof(file_header);
+
+    // Initialize a new header.  A reopened journal's messages all wait to be loaded again.
+    if(reopened == false)
+    {
+        std::memcpy(journal::m_header->magic, journal_magic, sizeof(journal_magic));
+        journal::m_header->capacity = capacity;
+        journal::m_header->head = 0;
+        journal::m_header->used = 0;
+    }
+    journal::m_loaded = 0;
+}
+journal::~journal()
+{
+    // Unlike captures, the journal is only useful if it reaches the disk.
+    msync(journal::m_header, journal::m_map_size, MS_SYNC);
+    munmap(journal::m_header, journal::m_map_size);
+    close(journal::m_fd);
+}
+
+// METHODS
+bool journal::append(const message& message, bool loaded, unsigned long long& position)
+{
+    unsigned long long capacity = journal::m_header->capacity;
+    unsigned long long size = align(sizeof(record_header) + message.p_data_length());
+
+    // Find the write position, wrapping to the start of the ring if the record does not fit before the end.
+    // Unacknowledged records are never overwritten, so the journal is full if there is not enough free space.
+    position = (journal::m_header->head + journal::m_header->used) % capacity;
+    unsigned long long skip = capacity - position < size ? capacity - position : 0;
+    if(capacity - journal::m_header->used < skip + size)
+    {
+        return false;
+    }
+    bool was_loaded = journal::m_loaded == journal::m_header->used;
+    if(skip > 0)
+    {
+        if(skip >= sizeof(unsigned int))
+        {
+            unsigned int marker = journal::m_wrap_marker;
+            std::memcpy(&journal::m_ring[position], &marker, sizeof(marker));
+        }
+        journal::m_header->used += skip;
+        position = 0;
+    }
+
+    // Write the record.
+    record_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.length = message.p_data_length();
+    header.id = message.p_id();
+    header.priority = message.p_priority();
+    header.node = message.p_node();
+    std::memcpy(&journal::m_ring[position], &header, sizeof(header));
+    std::memcpy(&journal::m_ring[position + sizeof(header)], message.p_data(), message.p_data_length());
+
+    // Publish the record after it has been written.
+    journal::m_header->used += size;
+    if(loaded && was_loaded)
+    {
+        journal::m_loaded = journal::m_header->used;
+    }
+    return true;
+}
+bool journal::next(message& message, unsigned long long& position)
+{
+    unsigned long long capacity = journal::m_header->capacity;
+    while(journal::m_loaded < journal::m_header->used)
+    {
+        unsigned long long offset = (journal::m_header->head + journal::m_loaded) % capacity;
+        journal::m_loaded += journal::record_size(offset);
+        if(journal::is_record(offset) == false)
+        {
+            continue;
+        }
+        record_header header;
+        std::memcpy(&header, &journal::m_ring[offset], sizeof(header));
+        if(header.acknowledged || header.length > 0xFFFF)
+        {
+            continue;
+        }
+
+        // Load the message.
+        message = serial_communicator::message(header.id, static_cast<unsigned short>(header.length));
+        message.p_priority(header.priority);
+        message.p_node(header.node);
+        std::memcpy(message.p_data(), &journal::m_ring[offset + sizeof(header)], header.length);
+        position = offset;
+        return true;
+    }
+    return false;
+}
+void journal::acknowledge(unsigned long long position)
+{
+    journal::m_ring[position + offsetof(record_header, acknowledged)] = 1;
+
+    // Remove acknowledged records, and the skipped ends of the ring, from the front.
+    unsigned long long capacity = journal::m_header->capacity;
+    while(journal::m_header->used > 0)
+    {
+        // Records that have not been loaded since a rewind stay, even if acknowledged, until they are passed over.
+        unsigned long long head = journal::m_header->head;
+        unsigned long long size = journal::record_size(head);
+        if(size > journal::m_loaded || (journal::is_record(head) && journal::m_ring[head + offsetof(record_header, acknowledged)] == 0))
+        {
+            break;
+        }
+        journal::m_header->head = (head + size) % capacity;
+        journal::m_header->used -= size;
+        journal::m_loaded -= size;
+    }
+}
+void journal::rewind()
+{
+    journal::m_loaded = 0;
+}
+
+// PROPERTIES
+bool journal::p_waiting() const
+{
+    return journal::m_loaded < journal::m_header->used;
+}
+
+// PRIVATE METHODS
+unsigned long long journal::record_size(unsigned long long offset) const
+{
+    // Records never straddle the end of the ring, so a short remainder or marker means the ring wraps here.
+    unsigned long long remainder = journal::m_header->capacity - offset;
+    if(journal::is_record(offset) == false)
+    {
+        return remainder;
+    }
+    unsigned int length;
+    std::memcpy(&length, &journal::m_ring[offset], sizeof(length));
+    unsigned long long size = align(sizeof(record_header) + length);
+    // Guard against a corrupted length.
+    return size <= remainder ? size : remainder;
+}
+bool journal::is_record(unsigned long long offset) const
+{
+    if(journal::m_header->capacity - offset < sizeof(record_header))
+    {
+        return false;
+    }
+    unsigned int length;
+    std::memcpy(&length, &journal::m_ring[offset], sizeof(length));
+    return length != journal::m_wrap_marker;
+}
@@ -0,0 +1,150 @@
+#include "serial_communicator/utility/link.h"
+
+#include <algorithm>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+link::link(serial_communicator::transport* transport)
+{
+    // Store the transport.
+    link::m_transport = transport;
+
+    // Initialize state.
+    link::m_busy_timestamp = std::chrono::steady_clock::now();
+    link::m_read_timestamp = link::m_busy_timestamp;
+    link::m_n_timeouts = 0;
+    link::m_failed = false;
+    link::m_probe_timestamp = link::m_busy_timestamp;
+    link::m_negotiator = nullptr;
+}
+link::~link()
+{
+    // Clean up the negotiator.
+    delete link::m_negotiator;
+
+    // Clean up the transport.
+    delete link::m_transport;
+}
+
+// METHODS
+void link::write(const unsigned char* buffer, unsigned int length)
+{
+    // Extend the backlog from now, or from the end of the existing backlog if it has not yet drained.
+    link::m_busy_timestamp = link::completion_time(length);
+
+    link::m_transport->write(buffer, length);
+
+    // A failed link that is written to is being probed.
+    if(link::m_failed)
+    {
+        link::m_probe_timestamp = std::chrono::steady_clock::now();
+    }
+}
+void link::write(const iovec* vectors, unsigned int count)
+{
+    unsigned int length = 0;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        length += static_cast<unsigned int>(vectors[i].iov_len);
+    }
+    link::m_busy_timestamp = link::completion_time(length);
+
+    link::m_transport->write(vectors, count);
+
+    // A failed link that is written to is being probed.
+    if(link::m_failed)
+    {
+        link::m_probe_timestamp = std::chrono::steady_clock::now();
+    }
+}
+unsigned long link::read(unsigned char* buffer, unsigned int length)
+{
+    unsigned long n_read = link::m_transport->read(buffer, length);
+    if(n_read > 0)
+    {
+        link::m_read_timestamp = std::chrono::steady_clock::now();
+    }
+    return n_read;
+}
+unsigned long link::available()
+{
+    return link::m_transport->available();
+}
+std::chrono::steady_clock::time_point link::completion_time(unsigned int length) const
+{
+    std::chrono::steady_clock::time_point start = std::max(std::chrono::steady_clock::now(), link::m_busy_timestamp);
+    return start + std::chrono::nanoseconds(link::m_transport->p_byte_time() * length);
+}
+std::chrono::steady_clock::time_point link::quiet_time(unsigned int gap) const
+{
+    std::chrono::steady_clock::time_point last = std::max(link::m_busy_timestamp, link::m_read_timestamp);
+    return last + std::chrono::nanoseconds(link::m_transport->p_byte_time() * gap);
+}
+void link::mark_timeout()
+{
+    if(link::m_failed == false && ++link::m_n_timeouts >= link::m_max_timeouts)
+    {
+        // Fail the link.
+        link::m_failed = true;
+        link::m_probe_timestamp = std::chrono::steady_clock::now();
+    }
+}
+void link::mark_received()
+{
+    link::m_n_timeouts = 0;
+    link::m_failed = false;
+}
+bool link::start_negotiation(const std::vector<unsigned int>& bauds)
+{
+    unsigned int baud = link::m_transport->p_baud();
+    if(baud == 0)
+    {
+        return false;
+    }
+    delete link::m_negotiator;
+    link::m_negotiator = new negotiator(bauds, baud);
+    return true;
+}
+void link::stop_negotiation()
+{
+    delete link::m_negotiator;
+    link::m_negotiator = nullptr;
+}
+void link::set_baud(unsigned int baud)
+{
+    link::m_transport->set_baud(baud);
+    // The transport drains before switching, so nothing remains of the old backlog.
+    link::m_busy_timestamp = std::chrono::steady_clock::now();
+}
+
+// PROPERTIES
+bool link::p_usable() const
+{
+    return link::m_failed == false ||
+           std::chrono::steady_clock::now() - link::m_probe_timestamp >= std::chrono::milliseconds(link::m_probe_interval);
+}
+bool link::p_paused() const
+{
+    return link::m_negotiator != nullptr && link::m_negotiator->p_paused();
+}
+bool link::p_drained() const
+{
+    return std::chrono::steady_clock::now() >= link::m_busy_timestamp;
+}
+negotiator* link::p_negotiator() const
+{
+    return link::m_negotiator;
+}
+bool link::p_failed() const
+{
+    return link::m_failed;
+}
+bool link::p_closed() const
+{
+    return link::m_transport->p_closed();
+}
+int link::p_file_descriptor() const
+{
+    return link::m_transport->p_file_descriptor();
+}
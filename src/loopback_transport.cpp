@@ -0,0 +1,112 @@
+#include "serial_communicator/transport/loopback_transport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+using namespace serial_communicator;
+
+// CHANNEL
+loopback_transport::channel::channel()
+{
+    read_position = 0;
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+loopback_transport::channel::~channel()
+{
+    close(event_fd);
+}
+
+// CONSTRUCTORS
+loopback_transport::loopback_transport(std::shared_ptr<channel> rx, std::shared_ptr<channel> tx)
+{
+    loopback_transport::m_rx = rx;
+    loopback_transport::m_tx = tx;
+}
+
+// FACTORIES
+void loopback_transport::create_pair(loopback_transport*& first, loopback_transport*& second)
+{
+    std::shared_ptr<channel> forward = std::make_shared<channel>();
+    std::shared_ptr<channel> backward = std::make_shared<channel>();
+    first = new loopback_transport(backward, forward);
+    second = new loopback_transport(forward, backward);
+}
+
+// METHODS
+unsigned long loopback_transport::read(unsigned char* buffer, unsigned long length)
+{
+    channel& rx = *loopback_transport::m_rx;
+    std::unique_lock<std::mutex> lock(rx.mutex);
+
+    // Wait until length bytes have arrived or the read timeout elapses.
+    rx.condition.wait_for(lock, std::chrono::milliseconds(loopback_transport::m_read_timeout), [&rx, length]{return rx.buffer.size() - rx.read_position >= length;});
+
+    // Copy out what is available.
+    unsigned long n_read = std::min(length, static_cast<unsigned long>(rx.buffer.size() - rx.read_position));
+    if(n_read == 0)
+    {
+        // Nothing arrived, and the buffer may be empty, so it can not be indexed.
+        return 0;
+    }
+    std::memcpy(buffer, &rx.buffer[rx.read_position], n_read);
+    rx.read_position += n_read;
+
+    // Reset the buffer and readability once drained.
+    if(rx.read_position == rx.buffer.size())
+    {
+        rx.buffer.clear();
+        rx.read_position = 0;
+        eventfd_t value;
+        eventfd_read(rx.event_fd, &value);
+    }
+
+    return n_read;
+}
+unsigned long loopback_transport::write(const unsigned char* buffer, unsigned long length)
+{
+    channel& tx = *loopback_transport::m_tx;
+    {
+        std::lock_guard<std::mutex> lock(tx.mutex);
+        tx.buffer.insert(tx.buffer.end(), buffer, buffer + length);
+        eventfd_write(tx.event_fd, 1);
+    }
+    tx.condition.notify_all();
+    return length;
+}
+unsigned long loopback_transport::write(const iovec* vectors, unsigned int count)
+{
+    channel& tx = *loopback_transport::m_tx;
+    unsigned long n_written = 0;
+    {
+        std::lock_guard<std::mutex> lock(tx.mutex);
+        for(unsigned int i = 0; i < count; i++)
+        {
+            const unsigned char* buffer = static_cast<const unsigned char*>(vectors[i].iov_base);
+            tx.buffer.insert(tx.buffer.end(), buffer, buffer + vectors[i].iov_len);
+            n_written += vectors[i].iov_len;
+        }
+        eventfd_write(tx.event_fd, 1);
+    }
+    tx.condition.notify_all();
+    return n_written;
+}
+unsigned long loopback_transport::available()
+{
+    channel& rx = *loopback_transport::m_rx;
+    std::lock_guard<std::mutex> lock(rx.mutex);
+    return rx.buffer.size() - rx.read_position;
+}
+
+// PROPERTIES
+int loopback_transport::p_file_descriptor() const
+{
+    return loopback_transport::m_rx->event_fd;
+}
+unsigned long loopback_transport::p_byte_time() const
+{
+    // Loopbacks are not rate limited.
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "serial_communicator/manager.h"
+
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+manager::manager(unsigned int n_threads)
+{
+    // Store parameters.
+    manager::m_n_threads = n_threads > 0 ? n_threads : 1;
+    manager::m_receive_index = 0;
+
+    // Set up the epoll instance and the stop event.
+    manager::m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    manager::m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    // The stop event is marked with an index that can never be used by a communicator.
+    event.data.u64 = 0xFFFFFFFF;
+    epoll_ctl(manager::m_epoll_fd, EPOLL_CTL_ADD, manager::m_stop_fd, &event);
+}
+manager::~manager()
+{
+    // Stop the worker threads.
+    manager::stop();
+
+    // Clean up communicators.
+    for(unsigned int i = 0; i < manager::m_communicators.size(); i++)
+    {
+        delete manager::m_communicators[i];
+    }
+
+    // Clean up event sources.
+    close(manager::m_stop_fd);
+    close(manager::m_epoll_fd);
+}
+
+// METHODS
+unsigned short manager::add(communicator* communicator)
+{
+    std::lock_guard<std::mutex> lock(manager::m_communicators_mutex);
+
+    unsigned short index = static_cast<unsigned short>(manager::m_communicators.size());
+    manager::m_communicators.push_back(communicator);
+
+    // Register the communicator's descriptor.  One-shot ensures that only one worker services a communicator at a time.
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = index;
+    epoll_ctl(manager::m_epoll_fd, EPOLL_CTL_ADD, communicator->p_file_descriptor(), &event);
+
+    return index;
+}
+void manager::start()
+{
+    // Check if already started.
+    if(!manager::m_threads.empty())
+    {
+        return;
+    }
+
+    // Reset the stop event and launch the workers.
+    eventfd_t value;
+    eventfd_read(manager::m_stop_fd, &value);
+    for(unsigned int i = 0; i < manager::m_n_threads; i++)
+    {
+        manager::m_threads.emplace_back(&manager::worker, this);
+    }
+}
+void manager::stop()
+{
+    // The stop event is left signalled so that it wakes every worker.
+    eventfd_write(manager::m_stop_fd, 1);
+    for(unsigned int i = 0; i < manager::m_threads.size(); i++)
+    {
+        manager::m_threads[i].join();
+    }
+    manager::m_threads.clear();
+}
+bool manager::send(unsigned short index, message* message, bool receipt_required, message_status* tracker)
+{
+    communicator* target = manager::p_communicator(index);
+    if(target == nullptr)
+    {
+        delete message;
+        return false;
+    }
+    return target->send(message, receipt_required, tracker);
+}
+message* manager::receive(unsigned short& index, unsigned short id)
+{
+    std::lock_guard<std::mutex> lock(manager::m_communicators_mutex);
+
+    unsigned short n_communicators = static_cast<unsigned short>(manager::m_communicators.size());
+    for(unsigned short i = 0; i < n_communicators; i++)
+    {
+        // Visit communicators in round robin order.
+        unsigned short current = (manager::m_receive_index + i) % n_communicators;
+        message* output = manager::m_communicators[current]->receive(id);
+        if(output != nullptr)
+        {
+            index = current;
+            manager::m_receive_index = (current + 1) % n_communicators;
+            return output;
+        }
+    }
+
+    return nullptr;
+}
+
+// PROPERTIES
+communicator* manager::p_communicator(unsigned short index)
+{
+    std::lock_guard<std::mutex> lock(manager::m_communicators_mutex);
+
+    if(index >= manager::m_communicators.size())
+    {
+        return nullptr;
+    }
+    return manager::m_communicators[index];
+}
+unsigned short manager::p_size()
+{
+    std::lock_guard<std::mutex> lock(manager::m_communicators_mutex);
+    return static_cast<unsigned short>(manager::m_communicators.size());
+}
+void manager::p_callback(std::function<void(unsigned short, message*)> callback)
+{
+    manager::m_callback = callback;
+}
+
+// PRIVATE METHODS
+void manager::worker()
+{
+    while(true)
+    {
+        // Wait for a communicator to have pending work.
+        epoll_event event;
+        int n_events = epoll_wait(manager::m_epoll_fd, &event, 1, -1);
+        if(n_events < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n_events < 1 || event.data.u64 == 0xFFFFFFFF)
+        {
+            // Stop has been requested.
+            return;
+        }
+
+        // Service the communicator.
+        unsigned short index = static_cast<unsigned short>(event.data.u64);
+        communicator* current = manager::p_communicator(index);
+        current->spin();
+
+        // Dispatch received messages if a callback is set.
+        if(manager::m_callback)
+        {
+            message* received;
+            while((received = current->receive()) != nullptr)
+            {
+                manager::m_callback(index, received);
+            }
+        }
+
+        // Re-arm the communicator's descriptor so that it may be serviced again.
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.u64 = index;
+        epoll_ctl(manager::m_epoll_fd, EPOLL_CTL_MOD, current->p_file_descriptor(), &event);
+    }
+}
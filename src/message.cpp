@@ -1,7 +1,16 @@
 #include "serial_communicator/message.h"
+#include "serial_communicator/utility/bounds.h"
+#include "serial_communicator/utility/byte_order.h"
+
+// Compile the hot path into the library unless it is inlined into calling code.
+#ifndef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/message.inl"
+#endif
 
 #include <endian.h>
 #include <cstring>
+#include <stdexcept>
+#include <utility>
 
 using namespace serial_communicator;
 
@@ -10,44 +19,97 @@ message::message(unsigned short id)
 {
     message::m_id = id;
     message::m_priority = 0;
-    message::m_data_length = 0;
-    message::m_data = nullptr;
+    message::m_node = 0xFF;
+    message::allocate(0);
 }
 message::message(unsigned short id, unsigned short data_length)
 {
     message::m_id = id;
     message::m_priority = 0;
-    message::m_data_length = data_length;
-    message::m_data = new unsigned char[data_length];
+    message::m_node = 0xFF;
+    message::allocate(data_length);
 }
 message::message(const unsigned char* byte_array)
 {
-    // Deserialize the message from the byte array.
-    // Read the ID.
-    message::m_id = be16toh(*reinterpret_cast<const unsigned short*>(&byte_array[0]));
-    // Read the priority.
-    message::m_priority = byte_array[2];
-    // Read the data length.
-    message::m_data_length = be16toh(*reinterpret_cast<const unsigned short*>(&byte_array[3]));
-    // Read the data.
-    message::m_data = new unsigned char[message::m_data_length];
-    std::memcpy(message::m_data, &byte_array[5], message::m_data_length);
+    message::deserialize(byte_array);
 }
-message::~message()
+message::message(const unsigned char* byte_array, unsigned int length)
 {
-    // Clean up data array.
-    if(message::m_data)
+    // The data length is only trusted once it is known to fit within the byte array.
+    if(length < 5)
     {
-        delete [] message::m_data;
+        throw std::invalid_argument("serialized message is shorter than its header");
+    }
+    unsigned short be_data_length = 0;
+    std::memcpy(&be_data_length, &byte_array[3], 2);
+    if(5u + be16toh(be_data_length) > length)
+    {
+        throw std::invalid_argument("serialized message is shorter than its data length");
     }
-}
 
-// METHODS
-template <typename T>
-void message::set_field(unsigned short address, T data)
+    message::deserialize(byte_array);
+}
+message::message(const message& other)
 {
-    message::set_field(address, sizeof(data), &data);
+    message::m_id = other.m_id;
+    message::m_priority = other.m_priority;
+    message::m_node = other.m_node;
+    message::allocate(other.m_data_length);
+    std::memcpy(message::m_data, other.m_data, message::m_data_length);
 }
+message::message(message&& other)
+{
+    message::m_data = message::m_inline;
+    message::m_data_length = 0;
+    *this = std::move(other);
+}
+message& message::operator=(const message& other)
+{
+    if(this != &other)
+    {
+        message::deallocate();
+        message::m_id = other.m_id;
+        message::m_priority = other.m_priority;
+        message::m_node = other.m_node;
+        message::allocate(other.m_data_length);
+        std::memcpy(message::m_data, other.m_data, message::m_data_length);
+    }
+    return *this;
+}
+message& message::operator=(message&& other)
+{
+    if(this != &other)
+    {
+        message::deallocate();
+        message::m_id = other.m_id;
+        message::m_priority = other.m_priority;
+        message::m_node = other.m_node;
+        message::m_data_length = other.m_data_length;
+        if(other.m_data == other.m_inline)
+        {
+            // Inline data must be copied.
+            message::m_data = message::m_inline;
+            std::memcpy(message::m_data, other.m_data, message::m_data_length);
+        }
+        else
+        {
+            // Heap data can be taken.
+            message::m_data = other.m_data;
+        }
+        // Leave the other message empty.
+        other.m_data = other.m_inline;
+        other.m_data_length = 0;
+    }
+    return *this;
+}
+message::~message()
+{
+    // Clean up data array.
+    message::deallocate();
+}
+
+// METHODS
+#ifndef SERIAL_COMMUNICATOR_INLINE
 template void message::set_field<unsigned char>(unsigned short address, unsigned char data);
 template void message::set_field<char>(unsigned short address, char data);
 template void message::set_field<unsigned short>(unsigned short address, unsigned short data);
@@ -59,43 +121,7 @@ template void message::set_field<long>(unsigned short address, long data);
 template void message::set_field<float>(unsigned short address, float data);
 template void message::set_field<double>(unsigned short address, double data);
 
-void message::set_field(unsigned short address, unsigned int size, void *data)
-{
-    switch(size)
-    {
-    case 1:
-    {
-        message::m_data[address] = *static_cast<unsigned char*>(data);
-        break;
-    }
-    case 2:
-    {
-        unsigned short value = htobe16(*static_cast<unsigned short*>(data));
-        std::memcpy(&message::m_data[address], & value, 2);
-        break;
-    }
-    case 4:
-    {
-        unsigned int value = htobe32(*static_cast<unsigned int*>(data));
-        std::memcpy(&message::m_data[address], & value, 4);
-        break;
-    }
-    case 8:
-    {
-        unsigned long value = htobe64(*static_cast<unsigned long*>(data));
-        std::memcpy(&message::m_data[address], & value, 8);
-        break;
-    }
-    }
-}
 
-template <typename T>
-T message::get_field(unsigned short address) const
-{
-    T output;
-    message::get_field(address, sizeof(output), &output);
-    return output;
-}
 template unsigned char message::get_field<unsigned char>(unsigned short address) const;
 template char message::get_field<char>(unsigned short address) const;
 template unsigned short message::get_field<unsigned short>(unsigned short address) const;
@@ -106,35 +132,68 @@ template unsigned long message::get_field<unsigned long>(unsigned short address)
 template long message::get_field<long>(unsigned short address) const;
 template float message::get_field<float>(unsigned short address) const;
 template double message::get_field<double>(unsigned short address) const;
+#endif
+
 
-void message::get_field(unsigned short address, unsigned int size, void *data) const
+template <typename T>
+void message::set_array(unsigned short address, const T* data, unsigned short count)
 {
-    switch(size)
-    {
-    case 1:
-    {
-        *static_cast<unsigned char*>(data) = static_cast<unsigned char>(message::m_data[address]);
-        break;
-    }
-    case 2:
-    {
-        unsigned short value = be16toh(*reinterpret_cast<unsigned short*>(&message::m_data[address]));
-        std::memcpy(data, &value, 2);
-        break;
-    }
-    case 4:
-    {
-        unsigned int value = be32toh(*reinterpret_cast<unsigned int*>(&message::m_data[address]));
-        std::memcpy(data, &value, 4);
-        break;
-    }
-    case 8:
-    {
-        unsigned long value = be64toh(*reinterpret_cast<unsigned long*>(&message::m_data[address]));
-        std::memcpy(data, &value, 8);
-        break;
-    }
-    }
+    utility::check_bounds(address, static_cast<unsigned long>(sizeof(T)) * count, message::m_data_length);
+    utility::convert_big_endian(&message::m_data[address], reinterpret_cast<const unsigned char*>(data), sizeof(T), count);
+}
+template void message::set_array<unsigned char>(unsigned short address, const unsigned char* data, unsigned short count);
+template void message::set_array<char>(unsigned short address, const char* data, unsigned short count);
+template void message::set_array<unsigned short>(unsigned short address, const unsigned short* data, unsigned short count);
+template void message::set_array<short>(unsigned short address, const short* data, unsigned short count);
+template void message::set_array<unsigned int>(unsigned short address, const unsigned int* data, unsigned short count);
+template void message::set_array<int>(unsigned short address, const int* data, unsigned short count);
+template void message::set_array<unsigned long>(unsigned short address, const unsigned long* data, unsigned short count);
+template void message::set_array<long>(unsigned short address, const long* data, unsigned short count);
+template void message::set_array<float>(unsigned short address, const float* data, unsigned short count);
+template void message::set_array<double>(unsigned short address, const double* data, unsigned short count);
+
+template <typename T>
+void message::get_array(unsigned short address, T* data, unsigned short count) const
+{
+    utility::check_bounds(address, static_cast<unsigned long>(sizeof(T)) * count, message::m_data_length);
+    utility::convert_big_endian(reinterpret_cast<unsigned char*>(data), &message::m_data[address], sizeof(T), count);
+}
+template void message::get_array<unsigned char>(unsigned short address, unsigned char* data, unsigned short count) const;
+template void message::get_array<char>(unsigned short address, char* data, unsigned short count) const;
+template void message::get_array<unsigned short>(unsigned short address, unsigned short* data, unsigned short count) const;
+template void message::get_array<short>(unsigned short address, short* data, unsigned short count) const;
+template void message::get_array<unsigned int>(unsigned short address, unsigned int* data, unsigned short count) const;
+template void message::get_array<int>(unsigned short address, int* data, unsigned short count) const;
+template void message::get_array<unsigned long>(unsigned short address, unsigned long* data, unsigned short count) const;
+template void message::get_array<long>(unsigned short address, long* data, unsigned short count) const;
+template void message::get_array<float>(unsigned short address, float* data, unsigned short count) const;
+template void message::get_array<double>(unsigned short address, double* data, unsigned short count) const;
+
+void message::set_string(unsigned short address, const std::string& data, unsigned short length)
+{
+    utility::check_bounds(address, length, message::m_data_length);
+    // Copy as much of the string as fits, and pad the remainder of the field with nulls.
+    unsigned short n_copy = data.size() < length ? static_cast<unsigned short>(data.size()) : length;
+    std::memcpy(&message::m_data[address], data.data(), n_copy);
+    std::memset(&message::m_data[address + n_copy], 0, length - n_copy);
+}
+std::string message::get_string(unsigned short address, unsigned short length) const
+{
+    utility::check_bounds(address, length, message::m_data_length);
+    // The string ends at the first null, or at the end of the field.
+    const char* field = reinterpret_cast<const char*>(&message::m_data[address]);
+    const void* terminator = std::memchr(field, 0, length);
+    return std::string(field, terminator ? static_cast<const char*>(terminator) - field : length);
+}
+void message::set_bytes(unsigned short address, const unsigned char* data, unsigned short length)
+{
+    utility::check_bounds(address, length, message::m_data_length);
+    std::memcpy(&message::m_data[address], data, length);
+}
+void message::get_bytes(unsigned short address, unsigned char* data, unsigned short length) const
+{
+    utility::check_bounds(address, length, message::m_data_length);
+    std::memcpy(data, &message::m_data[address], length);
 }
 
 void message::serialize(unsigned char *byte_array) const
@@ -152,20 +211,42 @@ void message::serialize(unsigned char *byte_array) const
 }
 
 
-// PROPERTIES
-unsigned short message::p_id() const
+// PRIVATE METHODS
+void message::allocate(unsigned short data_length)
 {
-    return message::m_id;
-}
-unsigned char message::p_priority() const
-{
-    return message::m_priority;
+    message::m_data_length = data_length;
+    if(data_length <= SERIAL_COMMUNICATOR_INLINE_PAYLOAD)
+    {
+        message::m_data = message::m_inline;
+    }
+    else
+    {
+        message::m_data = new unsigned char[data_length];
+    }
 }
-unsigned short message::p_data_length() const
+void message::deallocate()
 {
-    return message::m_data_length;
+    if(message::m_data != message::m_inline)
+    {
+        delete [] message::m_data;
+    }
+    message::m_data = message::m_inline;
+    message::m_data_length = 0;
 }
-unsigned int message::p_message_length() const
+void message::deserialize(const unsigned char* byte_array)
 {
-    return message::m_data_length + 5;
+    // The fields are not aligned within the byte array, so they are copied out before being converted.
+    // Read the ID.
+    unsigned short be_id = 0;
+    std::memcpy(&be_id, &byte_array[0], 2);
+    message::m_id = be16toh(be_id);
+    // Read the priority.  The node is not serialized, so the message is addressed to all nodes.
+    message::m_priority = byte_array[2];
+    message::m_node = 0xFF;
+    // Read the data length.
+    unsigned short be_data_length = 0;
+    std::memcpy(&be_data_length, &byte_array[3], 2);
+    message::allocate(be16toh(be_data_length));
+    // Read the data.
+    std::memcpy(message::m_data, &byte_array[5], message::m_data_length);
 }
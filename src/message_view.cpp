@@ -0,0 +1,110 @@
+#include "serial_communicator/message_view.h"
+#include "serial_communicator/utility/bounds.h"
+#include "serial_communicator/utility/byte_order.h"
+
+// Compile the hot path into the library unless it is inlined into calling code.
+#ifndef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/message_view.inl"
+#endif
+
+#include <cstring>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+message_view::message_view()
+{
+    message_view::m_buffer = nullptr;
+    message_view::m_message = nullptr;
+}
+message_view::message_view(utility::rx_buffer* buffer, unsigned int offset)
+{
+    buffer->retain();
+    message_view::m_buffer = buffer;
+    message_view::m_message = buffer->p_data() + offset;
+}
+message_view::message_view(const message_view& other)
+{
+    if(other.m_buffer)
+    {
+        other.m_buffer->retain();
+    }
+    message_view::m_buffer = other.m_buffer;
+    message_view::m_message = other.m_message;
+}
+message_view& message_view::operator=(const message_view& other)
+{
+    // Retain first so that self assignment does not release the last reference.
+    if(other.m_buffer)
+    {
+        other.m_buffer->retain();
+    }
+    message_view::release();
+    message_view::m_buffer = other.m_buffer;
+    message_view::m_message = other.m_message;
+    return *this;
+}
+message_view::~message_view()
+{
+    message_view::release();
+}
+
+// METHODS
+#ifndef SERIAL_COMMUNICATOR_INLINE
+template unsigned char message_view::get_field<unsigned char>(unsigned short address) const;
+template char message_view::get_field<char>(unsigned short address) const;
+template unsigned short message_view::get_field<unsigned short>(unsigned short address) const;
+template short message_view::get_field<short>(unsigned short address) const;
+template unsigned int message_view::get_field<unsigned int>(unsigned short address) const;
+template int message_view::get_field<int>(unsigned short address) const;
+template unsigned long message_view::get_field<unsigned long>(unsigned short address) const;
+template long message_view::get_field<long>(unsigned short address) const;
+template float message_view::get_field<float>(unsigned short address) const;
+template double message_view::get_field<double>(unsigned short address) const;
+#endif
+
+template <typename T>
+void message_view::get_array(unsigned short address, T* data, unsigned short count) const
+{
+    utility::check_bounds(address, static_cast<unsigned long>(sizeof(T)) * count, message_view::p_data_length());
+    utility::convert_big_endian(reinterpret_cast<unsigned char*>(data), message_view::p_data() + address, sizeof(T), count);
+}
+template void message_view::get_array<unsigned char>(unsigned short address, unsigned char* data, unsigned short count) const;
+template void message_view::get_array<char>(unsigned short address, char* data, unsigned short count) const;
+template void message_view::get_array<unsigned short>(unsigned short address, unsigned short* data, unsigned short count) const;
+template void message_view::get_array<short>(unsigned short address, short* data, unsigned short count) const;
+template void message_view::get_array<unsigned int>(unsigned short address, unsigned int* data, unsigned short count) const;
+template void message_view::get_array<int>(unsigned short address, int* data, unsigned short count) const;
+template void message_view::get_array<unsigned long>(unsigned short address, unsigned long* data, unsigned short count) const;
+template void message_view::get_array<long>(unsigned short address, long* data, unsigned short count) const;
+template void message_view::get_array<float>(unsigned short address, float* data, unsigned short count) const;
+template void message_view::get_array<double>(unsigned short address, double* data, unsigned short count) const;
+
+std::string message_view::get_string(unsigned short address, unsigned short length) const
+{
+    utility::check_bounds(address, length, message_view::p_data_length());
+    // The string ends at the first null, or at the end of the field.
+    const char* field = reinterpret_cast<const char*>(message_view::p_data() + address);
+    const void* terminator = std::memchr(field, 0, length);
+    return std::string(field, terminator ? static_cast<const char*>(terminator) - field : length);
+}
+void message_view::get_bytes(unsigned short address, unsigned char* data, unsigned short length) const
+{
+    utility::check_bounds(address, length, message_view::p_data_length());
+    std::memcpy(data, message_view::p_data() + address, length);
+}
+message* message_view::to_message() const
+{
+    message* output = new message(message_view::m_message);
+    output->p_node(message_view::p_node());
+    return output;
+}
+void message_view::release()
+{
+    if(message_view::m_buffer)
+    {
+        message_view::m_buffer->release();
+        message_view::m_buffer = nullptr;
+        message_view::m_message = nullptr;
+    }
+}
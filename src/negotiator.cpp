@@ -0,0 +1,349 @@
+#include "serial_communicator/utility/negotiator.h"
+
+#include <algorithm>
+
+using namespace serial_communicator::utility;
+
+// CONSTRUCTORS
+negotiator::negotiator(std::vector<unsigned int> bauds, unsigned int baud)
+{
+    // Store the rates in ascending order, including the starting rate.
+    bauds.push_back(baud);
+    std::sort(bauds.begin(), bauds.end());
+    bauds.erase(std::unique(bauds.begin(), bauds.end()), bauds.end());
+    negotiator::m_bauds = bauds;
+    negotiator::m_base = negotiator::index_of(baud);
+    negotiator::m_index = negotiator::m_base;
+    negotiator::m_previous = negotiator::m_base;
+    negotiator::m_target = negotiator::m_base;
+
+    // Initialize state.
+    negotiator::m_state = state::IDLE;
+    negotiator::m_initiator = false;
+    negotiator::m_nonce = 0;
+    negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+    negotiator::m_send_timestamp = negotiator::m_state_timestamp;
+    negotiator::m_n_received = 0;
+    negotiator::m_n_errors = 0;
+    negotiator::m_n_silent_errors = 0;
+    negotiator::m_received_timestamp = negotiator::m_state_timestamp;
+    negotiator::m_n_clean_windows = 0;
+    negotiator::m_window_timestamp = negotiator::m_state_timestamp;
+    negotiator::m_ceiling = static_cast<unsigned int>(negotiator::m_bauds.size());
+    negotiator::m_hold = negotiator::m_min_hold;
+    negotiator::m_hold_timestamp = negotiator::m_state_timestamp;
+    negotiator::m_random.seed(std::random_device()());
+}
+
+// METHODS
+void negotiator::mark_received(bool checksum_ok)
+{
+    if(checksum_ok)
+    {
+        negotiator::m_n_received++;
+        negotiator::m_n_silent_errors = 0;
+        negotiator::m_received_timestamp = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        negotiator::m_n_errors++;
+        negotiator::m_n_silent_errors++;
+    }
+}
+void negotiator::mark_timeout()
+{
+    negotiator::m_n_errors++;
+    negotiator::m_n_silent_errors++;
+}
+void negotiator::handle(const control& control)
+{
+    unsigned int index = negotiator::index_of(control.baud);
+    switch(control.command)
+    {
+    case command::REQUEST:
+    {
+        // Answer a resent request again if the switch has not happened yet.
+        if(negotiator::m_state == state::ACCEPTED && negotiator::m_initiator == false && control.nonce == negotiator::m_nonce)
+        {
+            negotiator::m_outgoing.push_back({command::ACCEPT, control.baud, control.nonce});
+            break;
+        }
+        // Refuse rates that are not listed, higher rates that are held off, and requests while a change is underway.
+        bool held = index > negotiator::m_index && index >= negotiator::m_ceiling && std::chrono::steady_clock::now() < negotiator::m_hold_timestamp;
+        if(index == negotiator::m_bauds.size() || held || (negotiator::m_state != state::IDLE && negotiator::m_state != state::REQUESTED))
+        {
+            negotiator::m_outgoing.push_back({command::REJECT, control.baud, control.nonce});
+            break;
+        }
+        // If both ends requested at once, the request with the larger nonce goes ahead.
+        if(negotiator::m_state == state::REQUESTED && negotiator::m_nonce > control.nonce)
+        {
+            break;
+        }
+        // Both ends hold off a rate that is stepped down from.
+        if(index < negotiator::m_index)
+        {
+            negotiator::hold(negotiator::m_index);
+        }
+        // Accept the request.  The accept is sent at the old rate, and the switch waits until it has drained.
+        negotiator::m_target = index;
+        negotiator::m_initiator = false;
+        negotiator::m_nonce = control.nonce;
+        negotiator::m_state = state::ACCEPTED;
+        negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+        negotiator::m_outgoing.push_back({command::ACCEPT, control.baud, control.nonce});
+        break;
+    }
+    case command::ACCEPT:
+    {
+        if(negotiator::m_state == state::REQUESTED && control.nonce == negotiator::m_nonce && index == negotiator::m_target)
+        {
+            negotiator::m_state = state::ACCEPTED;
+            negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+        }
+        break;
+    }
+    case command::REJECT:
+    {
+        if(negotiator::m_state == state::REQUESTED && control.nonce == negotiator::m_nonce)
+        {
+            negotiator::finish(false);
+        }
+        break;
+    }
+    case command::CONFIRM:
+    {
+        if(negotiator::m_state == state::VERIFYING && control.nonce == negotiator::m_nonce && index == negotiator::m_index)
+        {
+            negotiator::finish(true);
+            negotiator::m_outgoing.push_back({command::CONFIRMED, control.baud, control.nonce});
+        }
+        else if(negotiator::m_state == state::IDLE && index == negotiator::m_index)
+        {
+            // The initiator missed the last answer.
+            negotiator::m_outgoing.push_back({command::CONFIRMED, control.baud, control.nonce});
+        }
+        break;
+    }
+    case command::CONFIRMED:
+    {
+        if(negotiator::m_state == state::CONFIRMING && control.nonce == negotiator::m_nonce && index == negotiator::m_index)
+        {
+            negotiator::finish(true);
+        }
+        break;
+    }
+    }
+}
+negotiator::action negotiator::poll(bool drained, control& output)
+{
+    switch(negotiator::m_state)
+    {
+    case state::IDLE:
+    {
+        // A link that has lost sync with the remote end falls back to its starting rate, as the remote end does.
+        if(negotiator::lost_sync())
+        {
+            negotiator::m_index = negotiator::m_base;
+            negotiator::finish(true);
+            output.baud = negotiator::m_bauds[negotiator::m_index];
+            return action::SWITCH;
+        }
+        if(negotiator::remaining(negotiator::m_window_timestamp, negotiator::m_window) == 0)
+        {
+            negotiator::evaluate();
+        }
+        break;
+    }
+    case state::REQUESTED:
+    {
+        // Switch anyway once the request times out, since the remote end may have switched after its accept was lost.
+        if(negotiator::remaining(negotiator::m_state_timestamp, negotiator::m_request_timeout) == 0)
+        {
+            negotiator::m_state = state::ACCEPTED;
+            negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+        }
+        // Resend the request until it is answered.
+        else if(negotiator::remaining(negotiator::m_send_timestamp, negotiator::m_resend_interval) == 0)
+        {
+            negotiator::m_send_timestamp = std::chrono::steady_clock::now();
+            negotiator::m_outgoing.push_back({command::REQUEST, negotiator::m_bauds[negotiator::m_target], negotiator::m_nonce});
+        }
+        break;
+    }
+    case state::ACCEPTED:
+    {
+        // Switch once every byte at the old rate, including the accept, has been transmitted.
+        if(drained && negotiator::m_outgoing.empty())
+        {
+            negotiator::m_previous = negotiator::m_index;
+            negotiator::m_index = negotiator::m_target;
+            negotiator::m_state = negotiator::m_initiator ? state::CONFIRMING : state::VERIFYING;
+            negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+            negotiator::m_send_timestamp = negotiator::m_state_timestamp - std::chrono::milliseconds(negotiator::m_resend_interval);
+            output.baud = negotiator::m_bauds[negotiator::m_index];
+            return action::SWITCH;
+        }
+        break;
+    }
+    case state::CONFIRMING:
+    case state::VERIFYING:
+    {
+        // Revert if the change is not confirmed in time.
+        unsigned int timeout = negotiator::m_state == state::CONFIRMING ? negotiator::m_confirm_timeout : 2 * negotiator::m_confirm_timeout;
+        if(negotiator::remaining(negotiator::m_state_timestamp, timeout) == 0)
+        {
+            negotiator::m_index = negotiator::m_previous;
+            negotiator::finish(false);
+            output.baud = negotiator::m_bauds[negotiator::m_index];
+            return action::SWITCH;
+        }
+        // The initiator resends its confirm until it is answered.
+        if(negotiator::m_state == state::CONFIRMING && negotiator::remaining(negotiator::m_send_timestamp, negotiator::m_resend_interval) == 0)
+        {
+            negotiator::m_send_timestamp = std::chrono::steady_clock::now();
+            negotiator::m_outgoing.push_back({command::CONFIRM, negotiator::m_bauds[negotiator::m_index], negotiator::m_nonce});
+        }
+        break;
+    }
+    }
+
+    // Send any queued control packets.
+    if(!negotiator::m_outgoing.empty())
+    {
+        output = negotiator::m_outgoing.front();
+        negotiator::m_outgoing.pop_front();
+        return action::SEND;
+    }
+    return action::NONE;
+}
+
+// PROPERTIES
+unsigned int negotiator::p_baud() const
+{
+    return negotiator::m_bauds[negotiator::m_index];
+}
+bool negotiator::p_paused() const
+{
+    return negotiator::m_state != state::IDLE;
+}
+unsigned int negotiator::p_poll_delay() const
+{
+    if(!negotiator::m_outgoing.empty())
+    {
+        return 0;
+    }
+    switch(negotiator::m_state)
+    {
+    case state::IDLE:
+    {
+        unsigned int delay = negotiator::remaining(negotiator::m_window_timestamp, negotiator::m_window);
+        if(negotiator::m_index != negotiator::m_base && negotiator::m_n_silent_errors >= negotiator::m_max_silent_errors)
+        {
+            delay = std::min(delay, negotiator::remaining(negotiator::m_received_timestamp, negotiator::m_sync_timeout));
+        }
+        return delay;
+    }
+    case state::REQUESTED:
+        return std::min(negotiator::remaining(negotiator::m_state_timestamp, negotiator::m_request_timeout),
+                        negotiator::remaining(negotiator::m_send_timestamp, negotiator::m_resend_interval));
+    case state::ACCEPTED:
+        // Check again shortly for the link to drain.
+        return 1;
+    case state::CONFIRMING:
+        return std::min(negotiator::remaining(negotiator::m_state_timestamp, negotiator::m_confirm_timeout),
+                        negotiator::remaining(negotiator::m_send_timestamp, negotiator::m_resend_interval));
+    case state::VERIFYING:
+        return negotiator::remaining(negotiator::m_state_timestamp, 2 * negotiator::m_confirm_timeout);
+    }
+    return 0;
+}
+
+// PRIVATE METHODS
+void negotiator::request(unsigned int index)
+{
+    negotiator::m_target = index;
+    negotiator::m_initiator = true;
+    negotiator::m_nonce = static_cast<unsigned int>(negotiator::m_random());
+    negotiator::m_state = state::REQUESTED;
+    negotiator::m_state_timestamp = std::chrono::steady_clock::now();
+    negotiator::m_send_timestamp = negotiator::m_state_timestamp;
+    negotiator::m_outgoing.push_back({command::REQUEST, negotiator::m_bauds[index], negotiator::m_nonce});
+}
+void negotiator::finish(bool success)
+{
+    // A higher rate that could not be reached is held off.
+    if(!success && negotiator::m_target > negotiator::m_index)
+    {
+        negotiator::hold(negotiator::m_target);
+    }
+
+    // Start a new window at the current rate.
+    negotiator::m_state = state::IDLE;
+    negotiator::m_n_received = 0;
+    negotiator::m_n_errors = 0;
+    negotiator::m_n_silent_errors = 0;
+    negotiator::m_n_clean_windows = 0;
+    negotiator::m_window_timestamp = std::chrono::steady_clock::now();
+    negotiator::m_received_timestamp = negotiator::m_window_timestamp;
+}
+void negotiator::hold(unsigned int index)
+{
+    negotiator::m_ceiling = std::min(negotiator::m_ceiling, index);
+    negotiator::m_hold_timestamp = std::chrono::steady_clock::now() + std::chrono::milliseconds(negotiator::m_hold);
+    negotiator::m_hold = std::min(2 * negotiator::m_hold, negotiator::m_max_hold);
+}
+bool negotiator::lost_sync() const
+{
+    // Only errors, and no valid packets, have been seen at a negotiated rate for some time.
+    return negotiator::m_index != negotiator::m_base &&
+           negotiator::m_n_silent_errors >= negotiator::m_max_silent_errors &&
+           negotiator::remaining(negotiator::m_received_timestamp, negotiator::m_sync_timeout) == 0;
+}
+void negotiator::evaluate()
+{
+    // Close the window.
+    unsigned int n_packets = negotiator::m_n_received + negotiator::m_n_errors;
+    bool excessive = negotiator::m_n_errors >= negotiator::m_min_errors &&
+                     negotiator::m_n_errors * 100 >= n_packets * negotiator::m_max_error_percent;
+    negotiator::m_n_clean_windows = negotiator::m_n_errors == 0 ? negotiator::m_n_clean_windows + 1 : 0;
+    negotiator::m_n_received = 0;
+    negotiator::m_n_errors = 0;
+    negotiator::m_window_timestamp = std::chrono::steady_clock::now();
+
+    if(excessive)
+    {
+        // Errors are too frequent at this rate, so step down and hold off from returning to it.
+        if(negotiator::m_index > 0)
+        {
+            negotiator::hold(negotiator::m_index);
+            negotiator::request(negotiator::m_index - 1);
+        }
+        return;
+    }
+
+    if(negotiator::m_n_clean_windows >= negotiator::m_clean_windows)
+    {
+        // A rate that failed before has proven sustainable, so stop holding off.
+        if(negotiator::m_index >= negotiator::m_ceiling)
+        {
+            negotiator::m_ceiling = static_cast<unsigned int>(negotiator::m_bauds.size());
+            negotiator::m_hold = negotiator::m_min_hold;
+        }
+        // Probe the next higher rate, unless it is being held off.
+        unsigned int next = negotiator::m_index + 1;
+        if(next < negotiator::m_bauds.size() && (next < negotiator::m_ceiling || std::chrono::steady_clock::now() >= negotiator::m_hold_timestamp))
+        {
+            negotiator::request(next);
+        }
+    }
+}
+unsigned int negotiator::index_of(unsigned int baud) const
+{
+    return static_cast<unsigned int>(std::find(negotiator::m_bauds.begin(), negotiator::m_bauds.end(), baud) - negotiator::m_bauds.begin());
+}
+unsigned int negotiator::remaining(std::chrono::steady_clock::time_point timestamp, unsigned int duration) const
+{
+    long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timestamp).count();
+    return elapsed >= static_cast<long>(duration) ? 0 : static_cast<unsigned int>(static_cast<long>(duration) - elapsed);
+}
@@ -1,35 +1,40 @@
 #include "serial_communicator/utility/outbound.h"
 
+// Compile the hot path into the library unless it is inlined into calling code.
+#ifndef SERIAL_COMMUNICATOR_INLINE
+#include "serial_communicator/inline/outbound.inl"
+#endif
+
+#include <utility>
+
 using namespace serial_communicator;
 using namespace serial_communicator::utility;
 
 outbound::outbound(message* message, unsigned int sequence_number, bool receipt_required, message_status* tracker)
+    : m_message(std::move(*message))
 {
-    // Store locals.
-    outbound::m_message = message;
-    outbound::m_sequence_number = sequence_number;
-    outbound::m_receipt_required = receipt_required;
-    outbound::m_tracker = tracker;
-
-    // Initialize counters.
-    outbound::m_transmit_timestamp = std::chrono::high_resolution_clock::now();
-    outbound::m_n_transmissions = 0;
-
-    // Set status to queued.
-    outbound::update_status(message_status::QUEUED);
+    // The message's data now belongs to this instance.
+    delete message;
+    outbound::initialize(sequence_number, receipt_required, tracker);
 }
-outbound::~outbound()
+outbound::outbound(message&& message, unsigned int sequence_number, bool receipt_required, message_status* tracker)
+    : m_message(std::move(message))
 {
-    delete outbound::m_message;
+    outbound::initialize(sequence_number, receipt_required, tracker);
 }
 
 // METHODS
-void outbound::mark_transmitted()
+void outbound::mark_transmitted(utility::link* link)
 {
+    // Store the link used.
+    outbound::m_link = link;
     // Update transmission timestamp.
-    outbound::m_transmit_timestamp = std::chrono::high_resolution_clock::now();
-    // Increment transmission counter.
-    outbound::m_n_transmissions++;
+    outbound::m_transmit_timestamp = std::chrono::steady_clock::now();
+    // Increment transmission counter, which stops at its limit for journaled messages that are never given up on.
+    if(outbound::m_n_transmissions < 255)
+    {
+        outbound::m_n_transmissions++;
+    }
 }
 void outbound::update_status(message_status status)
 {
@@ -44,31 +49,37 @@ void outbound::update_status(message_status status)
 bool outbound::timeout_elapsed(unsigned int timeout) const
 {
     // Check if the given timeout has been elapsed.
-    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - outbound::m_transmit_timestamp).count() > timeout;
-}
-bool outbound::can_retransmit(unsigned char transmit_limit) const
-{
-    return outbound::m_n_transmissions < transmit_limit;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - outbound::m_transmit_timestamp).count() > timeout;
 }
-
-// PROPERTIES
-const message* outbound::p_message() const
-{
-    return outbound::m_message;
-}
-unsigned int outbound::p_sequence_number() const
-{
-    return outbound::m_sequence_number;
-}
-bool outbound::p_receipt_required() const
+unsigned int outbound::timeout_remaining(unsigned int timeout) const
 {
-    return outbound::m_receipt_required;
+    // Get elapsed time and compare to timeout.  The timeout elapses once it has been exceeded, hence the additional millisecond.
+    long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - outbound::m_transmit_timestamp).count();
+    long remaining = static_cast<long>(timeout) + 1 - elapsed;
+    return remaining > 0 ? static_cast<unsigned int>(remaining) : 0;
 }
-unsigned char outbound::p_n_transmissions() const
+unsigned long long outbound::elapsed() const
 {
-    return outbound::m_n_transmissions;
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - outbound::m_transmit_timestamp).count();
 }
-message_status outbound::p_status() const
+
+// PRIVATE METHODS
+void outbound::initialize(unsigned int sequence_number, bool receipt_required, message_status* tracker)
 {
-    return outbound::m_status;
+    // Store locals.
+    outbound::m_sequence_number = sequence_number;
+    outbound::m_receipt_required = receipt_required;
+    outbound::m_tracker = tracker;
+
+    // Initialize counters.
+    outbound::m_queue_timestamp = std::chrono::steady_clock::now();
+    outbound::m_transmit_timestamp = outbound::m_queue_timestamp;
+    outbound::m_n_transmissions = 0;
+    outbound::m_link = nullptr;
+    outbound::m_has_call = false;
+    outbound::m_call = 0;
+    outbound::m_journal_position = outbound::m_not_journaled;
+
+    // Set status to queued.
+    outbound::update_status(message_status::QUEUED);
 }
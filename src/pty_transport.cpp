@@ -0,0 +1,63 @@
+#include "serial_communicator/transport/pty_transport.h"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <termios.h>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+pty_transport::pty_transport()
+    : descriptor_transport(pty_transport::open_master())
+{
+    // Unlock and look up the slave side.
+    char slave_name[128];
+    if(grantpt(pty_transport::m_fd) < 0 || unlockpt(pty_transport::m_fd) < 0 || ptsname_r(pty_transport::m_fd, slave_name, sizeof(slave_name)) != 0)
+    {
+        throw std::runtime_error("failed to set up pseudo-terminal");
+    }
+    pty_transport::m_slave_name = slave_name;
+
+    pty_transport::make_raw();
+}
+pty_transport::pty_transport(std::string device)
+    : descriptor_transport(pty_transport::open_device(device))
+{
+    pty_transport::make_raw();
+}
+
+// PROPERTIES
+std::string pty_transport::p_slave_name() const
+{
+    return pty_transport::m_slave_name;
+}
+
+// PRIVATE METHODS
+int pty_transport::open_master()
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to open pseudo-terminal");
+    }
+    return fd;
+}
+int pty_transport::open_device(std::string device)
+{
+    int fd = open(device.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to open terminal device " + device);
+    }
+    return fd;
+}
+void pty_transport::make_raw()
+{
+    termios settings;
+    if(tcgetattr(pty_transport::m_fd, &settings) == 0)
+    {
+        cfmakeraw(&settings);
+        tcsetattr(pty_transport::m_fd, TCSANOW, &settings);
+    }
+}
@@ -0,0 +1,245 @@
+#include "serial_communicator/utility/reed_solomon.h"
+
+#include <cstring>
+
+using namespace serial_communicator::utility;
+
+// METHODS
+void reed_solomon::encode(const iovec* segments, unsigned int n_segments, unsigned int n_parity, unsigned char* parity)
+{
+    std::memset(parity, 0, n_parity);
+    if(n_parity == 0)
+    {
+        return;
+    }
+
+    // The parity is the remainder of the data divided by the generator, found with a shift register.
+    const reed_solomon::field& field = reed_solomon::tables();
+    const unsigned char* generator = field.generators[n_parity];
+    for(unsigned int i = 0; i < n_segments; i++)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(segments[i].iov_base);
+        for(unsigned int j = 0; j < segments[i].iov_len; j++)
+        {
+            unsigned char feedback = data[j] ^ parity[0];
+            std::memmove(parity, parity + 1, n_parity - 1);
+            parity[n_parity - 1] = 0;
+            if(feedback != 0)
+            {
+                unsigned int log_feedback = field.log[feedback];
+                for(unsigned int k = 0; k < n_parity; k++)
+                {
+                    if(generator[k + 1] != 0)
+                    {
+                        parity[k] ^= field.exp[log_feedback + field.log[generator[k + 1]]];
+                    }
+                }
+            }
+        }
+    }
+}
+int reed_solomon::decode(unsigned char* codeword, unsigned int length, unsigned int n_parity)
+{
+    if(n_parity == 0 || length > reed_solomon::m_max_codeword_length)
+    {
+        return 0;
+    }
+    const reed_solomon::field& field = reed_solomon::tables();
+
+    // Evaluate the codeword at each root of the generator.  All syndromes are zero if there are no errors.
+    unsigned char syndromes[reed_solomon::m_max_parity];
+    bool errors = false;
+    for(unsigned int j = 0; j < n_parity; j++)
+    {
+        unsigned char syndrome = 0;
+        for(unsigned int i = 0; i < length; i++)
+        {
+            syndrome = (syndrome == 0 ? 0 : field.exp[field.log[syndrome] + j + 1]) ^ codeword[i];
+        }
+        syndromes[j] = syndrome;
+        errors |= syndrome != 0;
+    }
+    if(errors == false)
+    {
+        return 0;
+    }
+
+    // Find the error locator polynomial with the Berlekamp-Massey algorithm, lowest power first.
+    unsigned char locator[reed_solomon::m_max_parity + 1] = {1};
+    unsigned char previous[reed_solomon::m_max_parity + 1] = {1};
+    unsigned char saved[reed_solomon::m_max_parity + 1];
+    unsigned int n_errors = 0;
+    unsigned int shift = 1;
+    unsigned char previous_discrepancy = 1;
+    for(unsigned int n = 0; n < n_parity; n++)
+    {
+        unsigned char discrepancy = syndromes[n];
+        for(unsigned int i = 1; i <= n_errors; i++)
+        {
+            if(locator[i] != 0 && syndromes[n - i] != 0)
+            {
+                discrepancy ^= field.exp[field.log[locator[i]] + field.log[syndromes[n - i]]];
+            }
+        }
+        if(discrepancy == 0)
+        {
+            shift++;
+            continue;
+        }
+        unsigned int log_scale = field.log[discrepancy] + 255 - field.log[previous_discrepancy];
+        bool lengthen = 2 * n_errors <= n;
+        if(lengthen)
+        {
+            std::memcpy(saved, locator, sizeof(locator));
+        }
+        for(unsigned int i = 0; i + shift <= n_parity; i++)
+        {
+            if(previous[i] != 0)
+            {
+                locator[i + shift] ^= field.exp[(log_scale + field.log[previous[i]]) % 255];
+            }
+        }
+        if(lengthen)
+        {
+            n_errors = n + 1 - n_errors;
+            std::memcpy(previous, saved, sizeof(saved));
+            previous_discrepancy = discrepancy;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+    }
+    if(2 * n_errors > n_parity)
+    {
+        return -1;
+    }
+
+    // Find the positions of the errors, which are the roots of the locator, by trying every position.
+    unsigned int positions[reed_solomon::m_max_parity / 2];
+    unsigned int n_found = 0;
+    for(unsigned int i = 0; i < length; i++)
+    {
+        // Position i is the coefficient of x^(length - 1 - i), which is in error if the locator has a root at its inverse.
+        unsigned int log_inverse = (255 - (length - 1 - i)) % 255;
+        unsigned char sum = 0;
+        for(unsigned int k = 0; k <= n_errors; k++)
+        {
+            if(locator[k] != 0)
+            {
+                sum ^= field.exp[(field.log[locator[k]] + k * log_inverse) % 255];
+            }
+        }
+        if(sum == 0)
+        {
+            if(n_found == n_errors)
+            {
+                return -1;
+            }
+            positions[n_found++] = i;
+        }
+    }
+    if(n_found != n_errors)
+    {
+        return -1;
+    }
+
+    // Find the value of each error with Forney's algorithm, from the error evaluator polynomial.
+    unsigned char evaluator[reed_solomon::m_max_parity] = {0};
+    for(unsigned int k = 0; k < n_parity; k++)
+    {
+        for(unsigned int i = 0; i <= k && i <= n_errors; i++)
+        {
+            if(locator[i] != 0 && syndromes[k - i] != 0)
+            {
+                evaluator[k] ^= field.exp[field.log[locator[i]] + field.log[syndromes[k - i]]];
+            }
+        }
+    }
+    unsigned char magnitudes[reed_solomon::m_max_parity / 2];
+    for(unsigned int e = 0; e < n_found; e++)
+    {
+        unsigned int log_position = length - 1 - positions[e];
+        unsigned int log_inverse = (255 - log_position) % 255;
+        unsigned char numerator = 0;
+        for(unsigned int k = 0; k < n_parity; k++)
+        {
+            if(evaluator[k] != 0)
+            {
+                numerator ^= field.exp[(field.log[evaluator[k]] + k * log_inverse) % 255];
+            }
+        }
+        // The formal derivative of the locator keeps only its odd powers.
+        unsigned char denominator = 0;
+        for(unsigned int k = 1; k <= n_errors; k += 2)
+        {
+            if(locator[k] != 0)
+            {
+                denominator ^= field.exp[(field.log[locator[k]] + (k - 1) * log_inverse) % 255];
+            }
+        }
+        if(denominator == 0)
+        {
+            return -1;
+        }
+        magnitudes[e] = numerator == 0 ? 0 : field.exp[(field.log[numerator] + 255 - field.log[denominator]) % 255];
+    }
+
+    // Only change the codeword once it is known to be correctable.
+    for(unsigned int e = 0; e < n_found; e++)
+    {
+        codeword[positions[e]] ^= magnitudes[e];
+    }
+    return static_cast<int>(n_errors);
+}
+
+// PRIVATE METHODS
+const reed_solomon::field& reed_solomon::tables()
+{
+    // Built once, on first use, and safe to share between threads from then on.
+    static const reed_solomon::field field;
+    return field;
+}
+
+// STRUCTURES
+reed_solomon::field::field()
+{
+    // The field is generated by x^8 + x^4 + x^3 + x^2 + 1.
+    unsigned int value = 1;
+    for(unsigned int i = 0; i < 255; i++)
+    {
+        reed_solomon::field::exp[i] = static_cast<unsigned char>(value);
+        reed_solomon::field::log[value] = i;
+        value <<= 1;
+        if(value & 0x100)
+        {
+            value ^= 0x11D;
+        }
+    }
+    for(unsigned int i = 255; i < 512; i++)
+    {
+        reed_solomon::field::exp[i] = reed_solomon::field::exp[i - 255];
+    }
+    reed_solomon::field::log[0] = 0;
+
+    // Each generator is the product of (x - a^j) for j from 1 to its number of parity bytes.  Leaving out a^0 keeps
+    // the parity from forcing the bytes of a miscorrected codeword to sum to zero, which would hide the miscorrection
+    // from the packet's checksum.
+    std::memset(reed_solomon::field::generators, 0, sizeof(reed_solomon::field::generators));
+    reed_solomon::field::generators[0][0] = 1;
+    for(unsigned int n = 1; n <= reed_solomon::m_max_parity; n++)
+    {
+        const unsigned char* lower = reed_solomon::field::generators[n - 1];
+        unsigned char* generator = reed_solomon::field::generators[n];
+        for(unsigned int j = 0; j <= n; j++)
+        {
+            unsigned char coefficient = j < n ? lower[j] : 0;
+            if(j > 0 && lower[j - 1] != 0)
+            {
+                coefficient ^= reed_solomon::field::exp[reed_solomon::field::log[lower[j - 1]] + n];
+            }
+            generator[j] = coefficient;
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/// \file replay.cpp
+/// \brief Replays a packet capture through a communicator's receive pipeline.
+/// \details Usage: serial_communicator_replay CAPTURE_FILE [--tx] [--max-speed]
+///
+/// Received packets are replayed by default, or transmitted packets with --tx.  Packets are fed at their recorded
+/// timing, or as fast as possible with --max-speed, which also makes the replay a throughput benchmark of the parser.
+#include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/loopback_transport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace serial_communicator;
+
+namespace {
+// The framing bytes, which must match serial_communicator::communicator.
+const unsigned char header_byte = 0xAA;
+const unsigned char escape_byte = 0x1B;
+
+// Escapes a packet for writing to a transport.
+void escape(const std::vector<unsigned char>& packet, std::vector<unsigned char>& output)
+{
+    output.clear();
+    output.reserve(packet.size() * 2);
+    for(unsigned int i = 0; i < packet.size(); i++)
+    {
+        // The header is never escaped.
+        if(i > 0 && (packet[i] == header_byte || packet[i] == escape_byte))
+        {
+            output.push_back(escape_byte);
+            output.push_back(packet[i] - 1);
+        }
+        else
+        {
+            output.push_back(packet[i]);
+        }
+    }
+}
+
+// Spins the communicator until all fed bytes have been processed, discarding its receipts and messages.
+unsigned long drain(communicator& receiver, loopback_transport* feeder, loopback_transport* input)
+{
+    unsigned long n_messages = 0;
+    unsigned char discard[256];
+    while(input->available() > 0)
+    {
+        receiver.spin();
+        message* received;
+        while((received = receiver.receive()) != nullptr)
+        {
+            n_messages++;
+            delete received;
+        }
+        // Read only what is available, since reading more would block until the transport's read timeout.
+        unsigned long n_pending;
+        while((n_pending = feeder->available()) > 0)
+        {
+            feeder->read(discard, std::min<unsigned long>(n_pending, sizeof(discard)));
+        }
+    }
+    return n_messages;
+}
+}
+
+int main(int argc, char** argv)
+{
+    // Parse arguments.
+    const char* path = nullptr;
+    utility::capture::direction direction = utility::capture::direction::RX;
+    bool max_speed = false;
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--tx") == 0)
+        {
+            direction = utility::capture::direction::TX;
+        }
+        else if(std::strcmp(argv[i], "--max-speed") == 0)
+        {
+            max_speed = true;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    if(path == nullptr)
+    {
+        std::fprintf(stderr, "usage: %s CAPTURE_FILE [--tx] [--max-speed]\n", argv[0]);
+        return 1;
+    }
+
+    // Load the capture.
+    std::vector<utility::capture::frame> frames;
+    if(!utility::capture::load(path, frames))
+    {
+        std::fprintf(stderr, "failed to load capture file %s\n", path);
+        return 1;
+    }
+
+    // Set up a communicator fed through a loopback.
+    loopback_transport* feeder;
+    loopback_transport* input;
+    loopback_transport::create_pair(feeder, input);
+    communicator receiver(input);
+    receiver.p_queue_size(1024);
+
+    // Feed the packets.
+    unsigned long n_frames = 0;
+    unsigned long n_bytes = 0;
+    unsigned long n_messages = 0;
+    std::vector<unsigned char> escaped;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long first_timestamp = 0;
+    for(unsigned int i = 0; i < frames.size(); i++)
+    {
+        const utility::capture::frame& frame = frames[i];
+        if(frame.direction != direction)
+        {
+            continue;
+        }
+
+        // Wait until the packet's recorded time, relative to the first packet.
+        if(n_frames == 0)
+        {
+            first_timestamp = frame.timestamp;
+        }
+        else if(!max_speed)
+        {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(frame.timestamp - first_timestamp));
+        }
+
+        escape(frame.bytes, escaped);
+        feeder->write(escaped.data(), escaped.size());
+        n_frames++;
+        n_bytes += escaped.size();
+
+        n_messages += drain(receiver, feeder, input);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Report.
+    const statistics& stats = receiver.p_statistics();
+    std::printf("frames:            %lu\n", n_frames);
+    std::printf("bytes:             %lu\n", n_bytes);
+    std::printf("messages:          %lu\n", n_messages);
+    std::printf("checksum failures: %llu\n", stats.p_counter(statistics::counter::CHECKSUM_FAILURES));
+    std::printf("elapsed:           %.6f s\n", elapsed);
+    if(elapsed > 0)
+    {
+        std::printf("throughput:        %.0f frames/s, %.3f MB/s\n", n_frames / elapsed, n_bytes / elapsed / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "serial_communicator/utility/rx_buffer.h"
+
+#include <mutex>
+#include <vector>
+
+using namespace serial_communicator::utility;
+
+namespace {
+// The maximum number of released buffers to keep.
+const unsigned int pool_capacity = 64;
+// The smallest buffer to allocate, so that small packets can reuse each other's buffers.
+const unsigned int minimum_size = 256;
+}
+
+// STRUCTURES
+struct rx_buffer::pool
+{
+    std::mutex mutex;
+    std::vector<rx_buffer*> buffers;
+
+    ~pool()
+    {
+        for(unsigned int i = 0; i < pool::buffers.size(); i++)
+        {
+            delete pool::buffers[i];
+        }
+    }
+};
+
+// CONSTRUCTORS
+rx_buffer::rx_buffer(unsigned int capacity)
+{
+    rx_buffer::m_data = new unsigned char[capacity];
+    rx_buffer::m_capacity = capacity;
+    rx_buffer::m_length = 0;
+    rx_buffer::m_source = 0xFF;
+    rx_buffer::m_destination = 0xFF;
+    rx_buffer::m_references = 0;
+}
+rx_buffer::~rx_buffer()
+{
+    delete [] rx_buffer::m_data;
+}
+
+// FACTORIES
+rx_buffer* rx_buffer::acquire(unsigned int length)
+{
+    rx_buffer* output = nullptr;
+    {
+        pool& shared = rx_buffer::instance();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        // Take the most recently released buffer that is large enough, since it is the most likely to be cached.
+        for(unsigned int i = shared.buffers.size(); i > 0; i--)
+        {
+            if(shared.buffers[i-1]->m_capacity >= length)
+            {
+                output = shared.buffers[i-1];
+                shared.buffers.erase(shared.buffers.begin() + (i-1));
+                break;
+            }
+        }
+    }
+    if(output == nullptr)
+    {
+        output = new rx_buffer(length > minimum_size ? length : minimum_size);
+    }
+
+    output->m_length = length;
+    output->m_source = 0xFF;
+    output->m_destination = 0xFF;
+    output->m_references = 1;
+    return output;
+}
+
+// METHODS
+void rx_buffer::retain()
+{
+    rx_buffer::m_references.fetch_add(1, std::memory_order_relaxed);
+}
+void rx_buffer::release()
+{
+    if(rx_buffer::m_references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        // Other holders remain.
+        return;
+    }
+
+    // This was the last reference, so return the buffer to the pool if there is room.
+    {
+        pool& shared = rx_buffer::instance();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if(shared.buffers.size() < pool_capacity)
+        {
+            shared.buffers.push_back(this);
+            return;
+        }
+    }
+    delete this;
+}
+
+// PROPERTIES
+unsigned char* rx_buffer::p_data()
+{
+    return rx_buffer::m_data;
+}
+const unsigned char* rx_buffer::p_data() const
+{
+    return rx_buffer::m_data;
+}
+unsigned int rx_buffer::p_length() const
+{
+    return rx_buffer::m_length;
+}
+unsigned char rx_buffer::p_source() const
+{
+    return rx_buffer::m_source;
+}
+unsigned char rx_buffer::p_destination() const
+{
+    return rx_buffer::m_destination;
+}
+void rx_buffer::p_addresses(unsigned char source, unsigned char destination)
+{
+    rx_buffer::m_source = source;
+    rx_buffer::m_destination = destination;
+}
+
+// PRIVATE METHODS
+rx_buffer::pool& rx_buffer::instance()
+{
+    static pool shared;
+    return shared;
+}
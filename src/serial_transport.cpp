@@ -0,0 +1,77 @@
+#include "serial_communicator/transport/serial_transport.h"
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+serial_transport::serial_transport(std::string port, unsigned int baud, unsigned int data_bits, unsigned int parity_bits, unsigned int stop_bits)
+{
+    // Set up the serial port.
+    serial_transport::m_serial_port = new serial::Serial(port, baud, serial::Timeout::simpleTimeout(30),
+                                                         static_cast<serial::bytesize_t>(data_bits),
+                                                         static_cast<serial::parity_t>(parity_bits),
+                                                         static_cast<serial::stopbits_t>(stop_bits),
+                                                         serial::flowcontrol_t::flowcontrol_none);
+    serial_transport::m_serial_port->flush();
+
+    // serial::Serial does not expose its descriptor, so a second descriptor is opened to the device for polling only.
+    serial_transport::m_poll_fd = open(port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+    // Calculate the byte time from the framing: 1 start bit, data bits, optional parity bit, and stop bits.
+    serial_transport::m_bits_per_byte = 1 + data_bits + (parity_bits != 0) + stop_bits;
+    serial_transport::m_byte_time = (1000000000UL * serial_transport::m_bits_per_byte) / (baud > 0 ? baud : 1);
+}
+serial_transport::~serial_transport()
+{
+    // Clean up the poll descriptor.
+    if(serial_transport::m_poll_fd >= 0)
+    {
+        close(serial_transport::m_poll_fd);
+    }
+
+    // Clean up the serial port.
+    serial_transport::m_serial_port->close();
+    delete serial_transport::m_serial_port;
+}
+
+// METHODS
+unsigned long serial_transport::read(unsigned char* buffer, unsigned long length)
+{
+    return serial_transport::m_serial_port->read(buffer, length);
+}
+unsigned long serial_transport::write(const unsigned char* buffer, unsigned long length)
+{
+    return serial_transport::m_serial_port->write(buffer, length);
+}
+unsigned long serial_transport::available()
+{
+    return serial_transport::m_serial_port->available();
+}
+bool serial_transport::set_baud(unsigned int baud)
+{
+    // Finish transmitting at the old rate, since changing the rate mid byte corrupts it.
+    if(serial_transport::m_poll_fd >= 0)
+    {
+        tcdrain(serial_transport::m_poll_fd);
+    }
+    serial_transport::m_serial_port->setBaudrate(baud);
+    serial_transport::m_byte_time = (1000000000UL * serial_transport::m_bits_per_byte) / (baud > 0 ? baud : 1);
+    return true;
+}
+
+// PROPERTIES
+int serial_transport::p_file_descriptor() const
+{
+    return serial_transport::m_poll_fd;
+}
+unsigned long serial_transport::p_byte_time() const
+{
+    return serial_transport::m_byte_time;
+}
+unsigned int serial_transport::p_baud() const
+{
+    return serial_transport::m_serial_port->getBaudrate();
+}
@@ -0,0 +1,309 @@
+#include "serial_communicator/transport/shm_transport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace serial_communicator;
+
+// The rings are shared between processes, which is only sound if their positions are lock free.
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shm_transport requires lock free 64 bit atomics");
+
+// CONSTRUCTORS
+shm_transport::shm_transport(std::string path, void* map, unsigned long map_size, unsigned int side, int doorbell_fd)
+{
+    shm_transport::m_path = path;
+    shm_transport::m_map = static_cast<segment*>(map);
+    shm_transport::m_map_size = map_size;
+    shm_transport::m_side = side;
+    shm_transport::m_doorbell_fd = doorbell_fd;
+
+    // Each side writes its own ring and reads the other side's.
+    unsigned char* data = static_cast<unsigned char*>(map) + sizeof(segment);
+    unsigned long capacity = shm_transport::m_map->capacity;
+    shm_transport::m_tx = &shm_transport::m_map->rings[side];
+    shm_transport::m_rx = &shm_transport::m_map->rings[1 - side];
+    shm_transport::m_tx_data = data + side * capacity;
+    shm_transport::m_rx_data = data + (1 - side) * capacity;
+    shm_transport::m_mask = capacity - 1;
+}
+shm_transport::~shm_transport()
+{
+    close(shm_transport::m_doorbell_fd);
+    munmap(shm_transport::m_map, shm_transport::m_map_size);
+    // The creator removes the name.  An attached peer keeps its mapping until it is destroyed.
+    if(shm_transport::m_side == 0)
+    {
+        shm_unlink(shm_transport::m_path.c_str());
+    }
+}
+
+// FACTORIES
+shm_transport* shm_transport::create(std::string name, unsigned long capacity)
+{
+    // The name is also used for the doorbells' socket addresses, which are short.
+    if(name.empty() || name.size() > shm_transport::m_max_name_length || name.find('/') != std::string::npos)
+    {
+        throw std::invalid_argument("shared memory segment names must be 1 to 64 characters without slashes");
+    }
+    // Ring offsets are found by masking, so the capacity is a power of two.
+    unsigned long rounded = 64;
+    while(rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+    if(rounded > 0x80000000UL)
+    {
+        throw std::invalid_argument("shared memory ring capacity is too large");
+    }
+
+    // Holding the creating side's doorbell shows that no live process created the segment, so any segment left
+    // under the name is stale and is replaced.
+    std::string path = "/" + name;
+    int doorbell_fd = shm_transport::bind_doorbell(path, 0);
+    if(doorbell_fd < 0)
+    {
+        throw std::runtime_error("shared memory segment " + name + " is already in use");
+    }
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if(fd < 0)
+    {
+        close(doorbell_fd);
+        throw std::runtime_error("failed to create shared memory segment " + name + ": " + std::strerror(errno));
+    }
+    unsigned long map_size = sizeof(segment) + 2 * rounded;
+    void* map = MAP_FAILED;
+    if(ftruncate(fd, static_cast<off_t>(map_size)) == 0)
+    {
+        map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        close(doorbell_fd);
+        shm_unlink(path.c_str());
+        throw std::runtime_error("failed to map shared memory segment " + name);
+    }
+
+    // The segment is zero filled, which leaves both rings empty.  The magic is stored last so that an attaching
+    // process never sees a partly initialized header.
+    segment* header = static_cast<segment*>(map);
+    header->capacity = static_cast<unsigned int>(rounded);
+    header->magic.store(shm_transport::m_magic, std::memory_order_release);
+
+    return new shm_transport(path, map, map_size, 0, doorbell_fd);
+}
+shm_transport* shm_transport::attach(std::string name)
+{
+    if(name.empty() || name.size() > shm_transport::m_max_name_length || name.find('/') != std::string::npos)
+    {
+        throw std::invalid_argument("shared memory segment names must be 1 to 64 characters without slashes");
+    }
+    std::string path = "/" + name;
+    int fd = shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to open shared memory segment " + name + ": " + std::strerror(errno));
+    }
+    struct stat status;
+    void* map = MAP_FAILED;
+    unsigned long map_size = 0;
+    if(fstat(fd, &status) == 0 && static_cast<unsigned long>(status.st_size) >= sizeof(segment))
+    {
+        map_size = static_cast<unsigned long>(status.st_size);
+        map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        throw std::runtime_error("failed to map shared memory segment " + name);
+    }
+
+    // Check that the segment was created by a shm_transport and is as large as its rings.
+    segment* header = static_cast<segment*>(map);
+    bool valid = header->magic.load(std::memory_order_acquire) == shm_transport::m_magic;
+    unsigned long capacity = header->capacity;
+    if(!valid || capacity == 0 || (capacity & (capacity - 1)) != 0 || sizeof(segment) + 2 * capacity > map_size)
+    {
+        munmap(map, map_size);
+        throw std::runtime_error("shared memory segment " + name + " is not a serial_communicator segment");
+    }
+
+    // Only one transport may attach at a time.
+    int doorbell_fd = shm_transport::bind_doorbell(path, 1);
+    if(doorbell_fd < 0)
+    {
+        munmap(map, map_size);
+        throw std::runtime_error("shared memory segment " + name + " is already attached");
+    }
+
+    return new shm_transport(path, map, map_size, 1, doorbell_fd);
+}
+
+// METHODS
+unsigned long shm_transport::read(unsigned char* buffer, unsigned long length)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(shm_transport::m_read_timeout);
+    unsigned long n_read = 0;
+    while(true)
+    {
+        // Copy out what has arrived, in up to two pieces where the ring wraps.
+        unsigned long long tail = shm_transport::m_rx->tail.load(std::memory_order_relaxed);
+        unsigned long long head = shm_transport::m_rx->head.load(std::memory_order_acquire);
+        // The peer's positions are not trusted to keep copies within the ring.
+        unsigned long n_copy = static_cast<unsigned long>(std::min<unsigned long long>(std::min<unsigned long long>(length - n_read, head - tail), shm_transport::m_mask + 1));
+        unsigned long offset = static_cast<unsigned long>(tail & shm_transport::m_mask);
+        unsigned long first = std::min(n_copy, static_cast<unsigned long>(shm_transport::m_mask + 1 - offset));
+        std::memcpy(buffer + n_read, shm_transport::m_rx_data + offset, first);
+        std::memcpy(buffer + n_read + first, shm_transport::m_rx_data, n_copy - first);
+        n_read += n_copy;
+        tail += n_copy;
+        shm_transport::m_rx->tail.store(tail, std::memory_order_seq_cst);
+
+        if(tail == head)
+        {
+            // The ring has been emptied, so clear the doorbell.  The peer rings again for bytes written after the
+            // tail was stored.  Bytes written before it without a ring are found here, and the doorbell is rung
+            // again so that it stays readable while the ring holds bytes.
+            unsigned char signal[16];
+            while(recv(shm_transport::m_doorbell_fd, signal, sizeof(signal), 0) > 0)
+            {
+            }
+            if(shm_transport::m_rx->head.load(std::memory_order_seq_cst) != tail)
+            {
+                shm_transport::ring_doorbell(shm_transport::m_side);
+            }
+        }
+
+        if(n_read == length)
+        {
+            return n_read;
+        }
+
+        // Wait for the peer to write more.
+        long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if(remaining <= 0)
+        {
+            return n_read;
+        }
+        pollfd poll_fd;
+        poll_fd.fd = shm_transport::m_doorbell_fd;
+        poll_fd.events = POLLIN;
+        poll(&poll_fd, 1, static_cast<int>(remaining));
+    }
+}
+unsigned long shm_transport::write(const unsigned char* buffer, unsigned long length)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(shm_transport::m_write_timeout);
+    return shm_transport::append(buffer, length, deadline);
+}
+unsigned long shm_transport::write(const iovec* vectors, unsigned int count)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(shm_transport::m_write_timeout);
+    unsigned long n_written = 0;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        unsigned long n_appended = shm_transport::append(static_cast<const unsigned char*>(vectors[i].iov_base), vectors[i].iov_len, deadline);
+        n_written += n_appended;
+        if(n_appended < vectors[i].iov_len)
+        {
+            break;
+        }
+    }
+    return n_written;
+}
+unsigned long shm_transport::available()
+{
+    return static_cast<unsigned long>(shm_transport::m_rx->head.load(std::memory_order_acquire) - shm_transport::m_rx->tail.load(std::memory_order_relaxed));
+}
+
+// PROPERTIES
+int shm_transport::p_file_descriptor() const
+{
+    return shm_transport::m_doorbell_fd;
+}
+unsigned long shm_transport::p_byte_time() const
+{
+    // Shared memory is not rate limited.
+    return 0;
+}
+
+// PRIVATE METHODS
+socklen_t shm_transport::doorbell_address(const std::string& path, unsigned int side, sockaddr_un& address)
+{
+    // Abstract socket addresses begin with a null byte, and are released with their socket.
+    std::string name = std::string(1, '\0') + "serial_communicator" + path + "/" + std::to_string(side);
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, name.data(), name.size());
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + name.size());
+}
+int shm_transport::bind_doorbell(const std::string& path, unsigned int side)
+{
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to create shared memory doorbell");
+    }
+    sockaddr_un address;
+    socklen_t address_length = shm_transport::doorbell_address(path, side, address);
+    if(bind(fd, reinterpret_cast<sockaddr*>(&address), address_length) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+void shm_transport::ring_doorbell(unsigned int side)
+{
+    sockaddr_un address;
+    socklen_t address_length = shm_transport::doorbell_address(shm_transport::m_path, side, address);
+    // This fails harmlessly if the peer is not attached, or its doorbell is already full.
+    unsigned char signal = 1;
+    sendto(shm_transport::m_doorbell_fd, &signal, 1, MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&address), address_length);
+}
+unsigned long shm_transport::append(const unsigned char* buffer, unsigned long length, std::chrono::steady_clock::time_point deadline)
+{
+    unsigned long n_written = 0;
+    while(n_written < length)
+    {
+        // Copy in as much as there is room for, in up to two pieces where the ring wraps.
+        unsigned long long head = shm_transport::m_tx->head.load(std::memory_order_relaxed);
+        unsigned long long tail = shm_transport::m_tx->tail.load(std::memory_order_acquire);
+        unsigned long long used = std::min<unsigned long long>(head - tail, shm_transport::m_mask + 1);
+        unsigned long long room = shm_transport::m_mask + 1 - used;
+        if(room == 0)
+        {
+            // Wait for the peer to read.
+            if(std::chrono::steady_clock::now() >= deadline)
+            {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        unsigned long n_copy = static_cast<unsigned long>(std::min<unsigned long long>(length - n_written, room));
+        unsigned long offset = static_cast<unsigned long>(head & shm_transport::m_mask);
+        unsigned long first = std::min(n_copy, static_cast<unsigned long>(shm_transport::m_mask + 1 - offset));
+        std::memcpy(shm_transport::m_tx_data + offset, buffer + n_written, first);
+        std::memcpy(shm_transport::m_tx_data, buffer + n_written + first, n_copy - first);
+        n_written += n_copy;
+        shm_transport::m_tx->head.store(head + n_copy, std::memory_order_seq_cst);
+
+        // Ring the peer's doorbell if it had read everything, since it may be waiting.
+        if(shm_transport::m_tx->tail.load(std::memory_order_seq_cst) == head)
+        {
+            shm_transport::ring_doorbell(1 - shm_transport::m_side);
+        }
+    }
+    return n_written;
+}
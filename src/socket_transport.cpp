@@ -0,0 +1,99 @@
+#include "serial_communicator/transport/socket_transport.h"
+
+#include <cstring>
+#include <netdb.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+socket_transport::socket_transport(int fd)
+    : descriptor_transport(fd)
+{
+    // Disable Nagle's algorithm on TCP sockets so that packets are not delayed. This fails harmlessly on UNIX sockets.
+    int enable = 1;
+    setsockopt(socket_transport::m_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+// FACTORIES
+void socket_transport::create_pair(socket_transport*& first, socket_transport*& second)
+{
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+    {
+        throw std::runtime_error("failed to create socket pair");
+    }
+    first = new socket_transport(fds[0]);
+    second = new socket_transport(fds[1]);
+}
+socket_transport* socket_transport::connect(std::string host, unsigned short port)
+{
+    // Resolve the host.
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        throw std::runtime_error("failed to resolve " + host);
+    }
+
+    // Connect to the first address that accepts.
+    int fd = -1;
+    for(addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+    {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if(fd < 0)
+        {
+            continue;
+        }
+        if(::connect(fd, address->ai_addr, address->ai_addrlen) == 0)
+        {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to connect to " + host);
+    }
+    return new socket_transport(fd);
+}
+socket_transport* socket_transport::accept(unsigned short port)
+{
+    // Listen on all interfaces.
+    int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(listen_fd < 0)
+    {
+        throw std::runtime_error("failed to create socket");
+    }
+    int enable = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd, 1) < 0)
+    {
+        close(listen_fd);
+        throw std::runtime_error("failed to listen on port " + std::to_string(port));
+    }
+
+    // Accept a single connection.
+    int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    close(listen_fd);
+    if(fd < 0)
+    {
+        throw std::runtime_error("failed to accept connection on port " + std::to_string(port));
+    }
+    return new socket_transport(fd);
+}
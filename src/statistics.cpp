@@ -0,0 +1,52 @@
+#include "serial_communicator/statistics.h"
+
+using namespace serial_communicator;
+
+// CONSTRUCTORS
+statistics::statistics()
+{
+    statistics::reset();
+}
+
+// METHODS
+void statistics::increment(counter counter, unsigned long long amount)
+{
+    statistics::m_counters[static_cast<unsigned int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+void statistics::sample(gauge gauge, unsigned long long value)
+{
+    statistics::m_gauges[static_cast<unsigned int>(gauge)].store(value, std::memory_order_relaxed);
+}
+void statistics::record(timing timing, unsigned long long microseconds)
+{
+    statistics::m_histograms[static_cast<unsigned int>(timing)].record(microseconds);
+}
+void statistics::reset()
+{
+    for(unsigned int i = 0; i < statistics::m_n_counters; i++)
+    {
+        statistics::m_counters[i].store(0, std::memory_order_relaxed);
+    }
+    for(unsigned int i = 0; i < statistics::m_n_gauges; i++)
+    {
+        statistics::m_gauges[i].store(0, std::memory_order_relaxed);
+    }
+    for(unsigned int i = 0; i < statistics::m_n_timings; i++)
+    {
+        statistics::m_histograms[i].reset();
+    }
+}
+
+// PROPERTIES
+unsigned long long statistics::p_counter(counter counter) const
+{
+    return statistics::m_counters[static_cast<unsigned int>(counter)].load(std::memory_order_relaxed);
+}
+unsigned long long statistics::p_gauge(gauge gauge) const
+{
+    return statistics::m_gauges[static_cast<unsigned int>(gauge)].load(std::memory_order_relaxed);
+}
+const utility::histogram& statistics::p_histogram(timing timing) const
+{
+    return statistics::m_histograms[static_cast<unsigned int>(timing)];
+}
@@ -0,0 +1,103 @@
+/// \file test_capture.cpp
+/// \brief Tests loading capture files, including ones that are truncated or corrupted.
+#include "serial_communicator/utility/capture.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+using namespace serial_communicator::utility;
+
+namespace {
+class capture_test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_path = "/tmp/serial_communicator_test_capture_" + std::to_string(getpid());
+        unlink(m_path.c_str());
+    }
+    void TearDown() override
+    {
+        unlink(m_path.c_str());
+    }
+
+    // Records three packets of 8 bytes, which take 24 bytes each in the ring, behind the 32 byte file header.
+    void record_packets()
+    {
+        capture recording(m_path, 1024);
+        for(unsigned char i = 0; i < 3; i++)
+        {
+            unsigned char packet[8] = {i, i, i, i, i, i, i, i};
+            recording.record(capture::direction::TX, i, packet, sizeof(packet));
+        }
+    }
+
+    // Overwrites part of the capture file.
+    void overwrite(off_t position, const void* bytes, size_t length)
+    {
+        int fd = open(m_path.c_str(), O_WRONLY);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(pwrite(fd, bytes, length, position), static_cast<ssize_t>(length));
+        close(fd);
+    }
+
+    std::string m_path;
+};
+}
+
+TEST_F(capture_test, loads_recorded_packets)
+{
+    record_packets();
+    std::vector<capture::frame> frames;
+    ASSERT_TRUE(capture::load(m_path, frames));
+    ASSERT_EQ(frames.size(), 3u);
+    for(unsigned char i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(frames[i].link, i);
+        EXPECT_EQ(frames[i].bytes, std::vector<unsigned char>(8, i));
+    }
+}
+
+TEST_F(capture_test, rejects_corrupted_lengths)
+{
+    // A length running past the end of a full ring is not copied, and the packets before it are still loaded.
+    record_packets();
+    unsigned long long used = 1024;
+    overwrite(24, &used, sizeof(used));
+    unsigned int length = 0x7FFFFFF0;
+    overwrite(32 + 24, &length, sizeof(length));
+    std::vector<capture::frame> frames;
+    EXPECT_FALSE(capture::load(m_path, frames));
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].bytes, std::vector<unsigned char>(8, 0));
+
+    // A length running past the used part of the ring is rejected too.
+    record_packets();
+    length = 40;
+    overwrite(32 + 48, &length, sizeof(length));
+    frames.clear();
+    EXPECT_FALSE(capture::load(m_path, frames));
+    EXPECT_EQ(frames.size(), 2u);
+}
+
+TEST_F(capture_test, rejects_truncated_files)
+{
+    record_packets();
+    ASSERT_EQ(truncate(m_path.c_str(), 32 + 64), 0);
+    std::vector<capture::frame> frames;
+    EXPECT_FALSE(capture::load(m_path, frames));
+    EXPECT_TRUE(frames.empty());
+
+    ASSERT_EQ(truncate(m_path.c_str(), 16), 0);
+    EXPECT_FALSE(capture::load(m_path, frames));
+    EXPECT_TRUE(frames.empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,229 @@
+/// \file test_journal.cpp
+/// \brief Tests the journal file, and the communicator's durable transmit queue built on it.
+#include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/loopback_transport.h"
+#include "serial_communicator/utility/journal.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+using namespace serial_communicator;
+
+namespace {
+// Drops everything written while the link is down.
+class gated_transport : public transport
+{
+public:
+    gated_transport(transport* inner)
+        : m_inner(inner),
+          m_down(false)
+    {}
+    ~gated_transport()
+    {
+        delete m_inner;
+    }
+    unsigned long read(unsigned char* buffer, unsigned long length) override
+    {
+        return m_inner->read(buffer, length);
+    }
+    unsigned long write(const unsigned char* buffer, unsigned long length) override
+    {
+        return m_down ? length : m_inner->write(buffer, length);
+    }
+    unsigned long available() override
+    {
+        return m_inner->available();
+    }
+    int p_file_descriptor() const override
+    {
+        return m_inner->p_file_descriptor();
+    }
+    unsigned long p_byte_time() const override
+    {
+        return m_inner->p_byte_time();
+    }
+    void p_down(bool value)
+    {
+        m_down = value;
+    }
+
+private:
+    transport* m_inner;
+    bool m_down;
+};
+
+class journal_test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_path = "/tmp/serial_communicator_test_journal_" + std::to_string(getpid());
+        unlink(m_path.c_str());
+    }
+    void TearDown() override
+    {
+        unlink(m_path.c_str());
+    }
+
+    // Creates a message whose data identifies it.
+    static message numbered(unsigned int number, unsigned short data_length)
+    {
+        message created(1, data_length);
+        created.set_field<unsigned int>(0, number);
+        return created;
+    }
+
+    // Spins a communicator pair, collecting the numbers of the messages received.
+    static void exchange(communicator& sender, communicator& receiver, std::multiset<unsigned int>& received, unsigned int n_spins)
+    {
+        for(unsigned int i = 0; i < n_spins; i++)
+        {
+            sender.spin();
+            receiver.spin();
+            for(message* current = receiver.receive(); current != nullptr; current = receiver.receive())
+            {
+                received.insert(current->get_field<unsigned int>(0));
+                delete current;
+            }
+        }
+    }
+
+    std::string m_path;
+};
+}
+
+TEST_F(journal_test, rejects_sizes_that_hold_no_record)
+{
+    EXPECT_THROW(utility::journal(m_path, 0), std::invalid_argument);
+    EXPECT_THROW(utility::journal(m_path, 8), std::invalid_argument);
+    EXPECT_NO_THROW(utility::journal(m_path, 16));
+
+    // A communicator left without a journal still sends.
+    unlink(m_path.c_str());
+    loopback_transport* first;
+    loopback_transport* second;
+    loopback_transport::create_pair(first, second);
+    communicator sender(first);
+    communicator receiver(second);
+    EXPECT_THROW(sender.start_journal(m_path, 0), std::invalid_argument);
+    EXPECT_TRUE(sender.send(numbered(1, 4), true));
+    std::multiset<unsigned int> received;
+    exchange(sender, receiver, received, 10);
+    EXPECT_EQ(received.count(1), 1u);
+}
+
+TEST_F(journal_test, wraps_past_the_end_of_the_ring)
+{
+    // Records take their 16 byte header plus their data, rounded up to 8 bytes.
+    unsigned long long a, b, c, d, e;
+    {
+        utility::journal journal(m_path, 256);
+        ASSERT_TRUE(journal.append(numbered(0, 48), false, a));
+        ASSERT_TRUE(journal.append(numbered(1, 48), false, b));
+        ASSERT_TRUE(journal.append(numbered(2, 48), false, c));
+        EXPECT_EQ(a, 0u);
+        EXPECT_EQ(b, 64u);
+        EXPECT_EQ(c, 128u);
+
+        // Loaded and acknowledged records make room at the front.
+        message loaded(static_cast<unsigned short>(0));
+        unsigned long long position;
+        ASSERT_TRUE(journal.next(loaded, position));
+        EXPECT_EQ(position, a);
+        ASSERT_TRUE(journal.next(loaded, position));
+        EXPECT_EQ(position, b);
+        journal.acknowledge(a);
+        journal.acknowledge(b);
+
+        // A record that does not fit before the end of the ring wraps to its start, behind a wrap marker.
+        ASSERT_TRUE(journal.append(numbered(3, 64), false, d));
+        EXPECT_EQ(d, 0u);
+        // The unacknowledged record is never overwritten, so there is no room left for another.
+        EXPECT_FALSE(journal.append(numbered(4, 48), false, e));
+    }
+
+    // Reopening loads the unacknowledged records in order, across the wrap marker.
+    utility::journal reopened(m_path, 256);
+    EXPECT_TRUE(reopened.p_waiting());
+    message loaded(static_cast<unsigned short>(0));
+    unsigned long long position;
+    ASSERT_TRUE(reopened.next(loaded, position));
+    EXPECT_EQ(position, c);
+    EXPECT_EQ(loaded.get_field<unsigned int>(0), 2u);
+    EXPECT_EQ(loaded.p_data_length(), 48u);
+    ASSERT_TRUE(reopened.next(loaded, position));
+    EXPECT_EQ(position, d);
+    EXPECT_EQ(loaded.get_field<unsigned int>(0), 3u);
+    EXPECT_EQ(loaded.p_data_length(), 64u);
+    EXPECT_FALSE(reopened.next(loaded, position));
+    EXPECT_FALSE(reopened.p_waiting());
+}
+
+TEST_F(journal_test, resends_unacknowledged_messages_after_restart)
+{
+    // Messages sent while the link is down outlive the communicator that sent them.
+    const unsigned int n_messages = 500;
+    {
+        loopback_transport* first;
+        loopback_transport* second;
+        loopback_transport::create_pair(first, second);
+        gated_transport* gate = new gated_transport(first);
+        gate->p_down(true);
+        communicator sender(gate);
+        communicator receiver(second);
+        sender.p_queue_size(8);
+        sender.start_journal(m_path, 65536);
+        for(unsigned int i = 0; i < n_messages; i++)
+        {
+            ASSERT_TRUE(sender.send(numbered(i, 20), true));
+        }
+        std::multiset<unsigned int> received;
+        exchange(sender, receiver, received, 50);
+        EXPECT_TRUE(received.empty());
+    }
+
+    // A new communicator that reopens the journal sends them all.
+    std::multiset<unsigned int> received;
+    {
+        loopback_transport* first;
+        loopback_transport* second;
+        loopback_transport::create_pair(first, second);
+        communicator sender(first);
+        communicator receiver(second);
+        sender.p_queue_size(8);
+        receiver.p_queue_size(100);
+        sender.start_journal(m_path);
+        for(unsigned int i = 0; i < 5000 && received.size() < n_messages; i++)
+        {
+            exchange(sender, receiver, received, 1);
+        }
+        // Let the last receipts arrive.
+        exchange(sender, receiver, received, 20);
+    }
+    ASSERT_EQ(received.size(), n_messages);
+    for(unsigned int i = 0; i < n_messages; i++)
+    {
+        EXPECT_EQ(received.count(i), 1u);
+    }
+
+    // Received messages are removed from the journal, so reopening it again sends nothing.
+    loopback_transport* first;
+    loopback_transport* second;
+    loopback_transport::create_pair(first, second);
+    communicator sender(first);
+    communicator receiver(second);
+    sender.start_journal(m_path);
+    std::multiset<unsigned int> resent;
+    exchange(sender, receiver, resent, 20);
+    EXPECT_TRUE(resent.empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
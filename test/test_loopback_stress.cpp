@@ -0,0 +1,285 @@
+/// \file test_loopback_stress.cpp
+/// \brief Drives random and adversarial byte streams into a communicator between valid packets over a loopback transport.
+#include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/loopback_transport.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <unistd.h>
+#include <vector>
+
+using namespace serial_communicator;
+
+namespace {
+// Holds every byte written to a transport until the test forwards it, so that packets can be split and cut short.
+class recording_transport : public transport
+{
+public:
+    recording_transport(transport* inner)
+        : m_inner(inner)
+    {}
+    ~recording_transport()
+    {
+        delete m_inner;
+    }
+    unsigned long read(unsigned char* buffer, unsigned long length) override
+    {
+        return m_inner->read(buffer, length);
+    }
+    unsigned long write(const unsigned char* buffer, unsigned long length) override
+    {
+        m_written.insert(m_written.end(), buffer, buffer + length);
+        return length;
+    }
+    unsigned long available() override
+    {
+        return m_inner->available();
+    }
+    int p_file_descriptor() const override
+    {
+        return m_inner->p_file_descriptor();
+    }
+    unsigned long p_byte_time() const override
+    {
+        return m_inner->p_byte_time();
+    }
+
+    std::vector<unsigned char> take()
+    {
+        std::vector<unsigned char> written;
+        written.swap(m_written);
+        return written;
+    }
+
+private:
+    transport* m_inner;
+    std::vector<unsigned char> m_written;
+};
+
+// Gets the resident set size of the process in bytes.
+unsigned long resident_bytes()
+{
+    unsigned long pages = 0;
+    unsigned long resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    return resident * static_cast<unsigned long>(sysconf(_SC_PAGESIZE));
+}
+
+// The longest any spin may take.  Spins never wait on the transport, so this is generous even under sanitizers.
+const double max_spin_ms = 50.0;
+
+class loopback_stress : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        loopback_transport* sender_end;
+        loopback_transport::create_pair(sender_end, m_receiver_end);
+        // The sender's end also carries the adversarial bytes, which arrive between the sender's packets.
+        m_wire = sender_end;
+        m_recorder = new recording_transport(sender_end);
+        m_sender = new communicator(m_recorder);
+        m_receiver = new communicator(m_receiver_end);
+        m_sender->p_queue_size(1);
+        m_receiver->p_queue_size(100);
+        m_rng.seed(44);
+        m_slowest_spin_ms = 0.0;
+    }
+    void TearDown() override
+    {
+        delete m_receiver;
+        delete m_sender;
+    }
+
+    // Spins the receiver, timing the spin, and checks every message it has received unless noise may have passed
+    // for one by chance.
+    void spin_receiver(bool check = true)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        m_receiver->spin();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_slowest_spin_ms = std::max(m_slowest_spin_ms, elapsed);
+        for(message* received = m_receiver->receive(); received != nullptr; received = m_receiver->receive())
+        {
+            if(check == false)
+            {
+                delete received;
+                continue;
+            }
+            ASSERT_EQ(m_lengths.count(received->p_id()), 1u);
+            ASSERT_EQ(received->p_data_length(), m_lengths[received->p_id()]);
+            for(unsigned int j = 0; j < received->p_data_length(); j++)
+            {
+                ASSERT_EQ(received->p_data()[j], pattern(received->p_id(), j));
+            }
+            EXPECT_TRUE(m_received.insert(received->p_id()).second);
+            delete received;
+        }
+    }
+
+    // Gets a data byte of a message, which is often a header or escape byte.
+    static unsigned char pattern(unsigned short id, unsigned int index)
+    {
+        unsigned int value = (id * 131u + index * 7u) % 23u;
+        return value == 0 ? 0xAA : value == 1 ? 0x1B : static_cast<unsigned char>(id + index);
+    }
+
+    // Builds a run of adversarial bytes.
+    std::vector<unsigned char> junk(const std::vector<std::vector<unsigned char>>& packets)
+    {
+        std::vector<unsigned char> bytes;
+        switch(m_rng() % 6)
+        {
+        case 0:
+            // Random garbage.
+            for(unsigned int j = m_rng() % 64; j > 0; j--)
+            {
+                bytes.push_back(static_cast<unsigned char>(m_rng()));
+            }
+            break;
+        case 1:
+            // An earlier packet, cut short.
+            if(packets.empty() == false)
+            {
+                const std::vector<unsigned char>& packet = packets[m_rng() % packets.size()];
+                bytes.insert(bytes.end(), packet.begin(), packet.begin() + m_rng() % packet.size());
+            }
+            break;
+        case 2:
+        {
+            // A header with the largest possible data length, followed by bytes that are never a header.
+            unsigned char oversized[] = {0xAA, 0, 0, 0, 1, 0, 0, 1, 0, 0xFF, 0xFF};
+            bytes.insert(bytes.end(), oversized, oversized + sizeof(oversized));
+            for(unsigned int j = m_rng() % 128; j > 0; j--)
+            {
+                bytes.push_back(static_cast<unsigned char>(m_rng() % 0xAA));
+            }
+            break;
+        }
+        case 3:
+            // A stray header byte.
+            bytes.push_back(0xAA);
+            break;
+        case 4:
+            // A stray escape byte.
+            bytes.push_back(0x1B);
+            break;
+        default:
+            break;
+        }
+        return bytes;
+    }
+
+    loopback_transport* m_wire;
+    loopback_transport* m_receiver_end;
+    recording_transport* m_recorder;
+    communicator* m_sender;
+    communicator* m_receiver;
+    std::mt19937 m_rng;
+    std::map<unsigned short, unsigned int> m_lengths;
+    std::set<unsigned short> m_received;
+    double m_slowest_spin_ms;
+};
+}
+
+TEST_F(loopback_stress, valid_messages_survive_adversarial_bytes)
+{
+    const unsigned short n_messages = 2000;
+    std::vector<std::vector<unsigned char>> packets;
+    for(unsigned short id = 0; id < n_messages; id++)
+    {
+        // Adversarial bytes arrive before each packet.
+        std::vector<unsigned char> bytes = junk(packets);
+        m_wire->write(bytes.data(), bytes.size());
+
+        // The packet itself is written by the sender, and arrives in pieces over several spins of the receiver.
+        unsigned int length = m_rng() % 300;
+        message sent(id, static_cast<unsigned short>(length));
+        for(unsigned int j = 0; j < length; j++)
+        {
+            sent.p_data()[j] = pattern(id, j);
+        }
+        m_lengths[id] = length;
+        ASSERT_TRUE(m_sender->send(std::move(sent)));
+        m_sender->spin();
+        packets.push_back(m_recorder->take());
+        const std::vector<unsigned char>& packet = packets.back();
+        for(unsigned int position = 0; position < packet.size();)
+        {
+            unsigned int n_bytes = std::min(static_cast<unsigned int>(packet.size()) - position, static_cast<unsigned int>(1 + m_rng() % 64));
+            m_wire->write(&packet[position], n_bytes);
+            position += n_bytes;
+            if(m_rng() % 3 == 0)
+            {
+                spin_receiver();
+            }
+        }
+    }
+    for(unsigned int i = 0; i < 1000 && m_received.size() < n_messages; i++)
+    {
+        spin_receiver();
+    }
+
+    EXPECT_EQ(m_received.size(), n_messages);
+    EXPECT_GT(m_receiver->p_statistics().p_counter(statistics::counter::FRAMING_ERRORS), 0u);
+    EXPECT_LT(m_slowest_spin_ms, max_spin_ms);
+}
+
+TEST_F(loopback_stress, noise_keeps_memory_bounded)
+{
+    // Let allocations that are made once settle before measuring.
+    std::vector<unsigned char> noise(512);
+    for(unsigned int i = 0; i < 1000; i++)
+    {
+        for(unsigned int j = 0; j < noise.size(); j++)
+        {
+            noise[j] = static_cast<unsigned char>(m_rng());
+        }
+        m_wire->write(noise.data(), noise.size());
+        spin_receiver(false);
+    }
+    unsigned long settled = resident_bytes();
+
+    // Megabytes of noise pass through the receiver without it holding on to any of them.
+    for(unsigned int i = 0; i < 20000; i++)
+    {
+        for(unsigned int j = 0; j < noise.size(); j++)
+        {
+            noise[j] = static_cast<unsigned char>(m_rng());
+        }
+        m_wire->write(noise.data(), noise.size());
+        spin_receiver(false);
+    }
+    EXPECT_LT(resident_bytes(), settled + 8ul * 1024ul * 1024ul);
+    EXPECT_LT(m_slowest_spin_ms, max_spin_ms);
+
+    // A valid message still arrives once the noise stops.
+    m_lengths[7] = 3;
+    message sent(7, 3);
+    for(unsigned int j = 0; j < 3; j++)
+    {
+        sent.p_data()[j] = pattern(7, j);
+    }
+    ASSERT_TRUE(m_sender->send(std::move(sent)));
+    m_sender->spin();
+    std::vector<unsigned char> packet = m_recorder->take();
+    m_wire->write(packet.data(), packet.size());
+    for(unsigned int i = 0; i < 100 && m_received.empty(); i++)
+    {
+        spin_receiver();
+    }
+    EXPECT_EQ(m_received.count(7), 1u);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/// \file test_transports.cpp
+/// \brief Tests the transports, and how a communicator handles a transport whose remote end closes.
+#include "serial_communicator/communicator.h"
+#include "serial_communicator/transport/loopback_transport.h"
+#include "serial_communicator/transport/pty_transport.h"
+#include "serial_communicator/transport/socket_transport.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace serial_communicator;
+
+namespace {
+// Gets the time a wait() took, in milliseconds.
+long timed_wait(communicator& waiting, int timeout, bool& woken)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    woken = waiting.wait(timeout);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Spins a communicator for as long as it reports work, up to a limit.
+void settle(communicator& spinning)
+{
+    for(unsigned int i = 0; i < 10 && spinning.wait(0); i++)
+    {
+        spinning.spin();
+    }
+}
+}
+
+TEST(loopback_transport, reads_nothing_from_an_empty_channel)
+{
+    loopback_transport* first;
+    loopback_transport* second;
+    loopback_transport::create_pair(first, second);
+    unsigned char buffer[4];
+    EXPECT_EQ(first->read(buffer, sizeof(buffer)), 0u);
+    delete first;
+    delete second;
+}
+
+TEST(socket_transport, closed_peer_stops_waking_wait)
+{
+    socket_transport* first;
+    socket_transport* second;
+    socket_transport::create_pair(first, second);
+    communicator remaining(first);
+    delete second;
+
+    // The hangup is noticed by a spin, after which the link is no longer polled.
+    settle(remaining);
+    EXPECT_TRUE(first->p_closed());
+    bool woken = true;
+    long elapsed = timed_wait(remaining, 200, woken);
+    EXPECT_FALSE(woken);
+    EXPECT_GE(elapsed, 150);
+
+    // Messages wait rather than being written to the closed socket, which would raise SIGPIPE.
+    EXPECT_TRUE(remaining.send(message(1, 4)));
+    remaining.spin();
+    EXPECT_EQ(remaining.p_statistics().p_counter(statistics::counter::PACKETS_SENT), 0u);
+}
+
+TEST(pty_transport, reopened_terminal_is_polled_again)
+{
+    pty_transport* master = new pty_transport();
+    communicator host(master);
+    communicator* device = new communicator(new pty_transport(master->p_slave_name()));
+    device->send(message(1, 4));
+    device->spin();
+    settle(host);
+    message* received = host.receive();
+    ASSERT_NE(received, nullptr);
+    delete received;
+
+    // Closing the terminal hangs up the master, which stops waking wait().
+    delete device;
+    settle(host);
+    EXPECT_TRUE(master->p_closed());
+    bool woken = true;
+    long elapsed = timed_wait(host, 200, woken);
+    EXPECT_FALSE(woken);
+    EXPECT_GE(elapsed, 150);
+
+    // Opening the terminal again is noticed, and messages are received once more.
+    device = new communicator(new pty_transport(master->p_slave_name()));
+    device->send(message(2, 4));
+    device->spin();
+    for(unsigned int i = 0; i < 5 && host.messages_available() == 0; i++)
+    {
+        if(host.wait(1500))
+        {
+            host.spin();
+        }
+    }
+    received = host.receive();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(received->p_id(), 2u);
+    EXPECT_FALSE(master->p_closed());
+    delete received;
+    delete device;
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}